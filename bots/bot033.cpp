@@ -0,0 +1,3747 @@
+// bot033.cpp - bot032 engine on a bitboard Board
+// Key changes over bot032:
+// 1. Board keeps one uint64_t per color plus an arrow bitboard instead of int8_t grid[64]
+// 2. Precomputed per-square ray tables; queen/arrow targets come from ray & occupancy masks
+// 3. Move generation iterates pieces, destinations and arrows with lsb_index()
+// 4. Untried moves are enumerated lazily per node (MoveCursor) instead of being
+//    materialized into a global move_pool at every expansion
+// 5. Optional two-level tree (-DTWO_LEVEL_TREE=1): the amazon move and the arrow
+//    shot are separate plies, so per-node branching drops from ~2000 to ~100
+// 6. Botzone long-running mode with tree reuse: after our move and the reply the
+//    matching grandchild becomes the root
+// 7. Incremental garbage collection: discarded subtrees are reclaimed into a node
+//    free list a slice at a time inside the search loop, so reuse never pauses
+// 8. Memory budget reads the real RSS from /proc/self/statm with soft/hard limits
+//    (RSS_SOFT_LIMIT_MB / RSS_HARD_LIMIT_MB) instead of a hand-sized estimate
+// 9. Structure-of-arrays nodes: children in one contiguous block per node, wins
+//    and visits in packed arrays, so UCT selection is a linear scan
+// 10. Vectorized UCB kernel (AVX2 / SSE2 / scalar) with a sqrt(log N) table and
+//     Newton-refined rsqrt in place of log, sqrt and divide per child
+// 11. Evaluation on bitboard distance layers (king steps, AVX2 queen flood fills)
+//     scored by popcount per layer; qt now uses queen-move distances
+// 12. Runtime CPU dispatch: UCB and evaluation kernels are built for several
+//     targets and picked once at startup with __builtin_cpu_supports
+// 13. Root-parallel search (--threads N): every thread grows its own tree from
+//     thread_local state; root visit counts are merged by move at the deadline.
+//     Build with -pthread when N > 1 is wanted on older glibc.
+// 14. One shared node arena: threads reserve 4K-slot chunks with a single atomic
+//     add and carve their blocks out of them without synchronization
+// 15. Incremental Zobrist hash in Board and a bucketed, generation-aged
+//     transposition table through which transposed positions share statistics
+//     (-DTRANSPOSITION_TABLE=1)
+// 16. Endgame solver: once the arrows split the board into regions, private
+//     regions are scored by exact filling counts and small contested ones by a
+//     game search; a proved move is played without running MCTS
+// 17. Alternative alpha-beta backend (PVSEngine): iterative-deepening PVS with
+//     TT, killer and history ordering; --engine pvs|hybrid selects it
+// 18. Progressive widening: a node holds PW_K * N^PW_ALPHA children, drawn
+//     best first by a cheap prior (bot002's score_move, split per arrow)
+// 19. Batched leaf evaluation (-DLEAF_BATCH=N): N leaves per step under virtual
+//     loss, with an AVX2 kernel running the BFS of four boards in one register
+// 20. Optional NNUE-style evaluator (-DEVAL_NNUE=1): int16 accumulator in Board
+//     updated by three weight rows per move, embedded int16/int8 tables
+// 21. Ray and king-distance tables are constexpr-built; init_tables() is gone
+// 22. Compile-time search statistics (-DSEARCH_STATS=1): cycle counts per MCTS
+//     phase, tree size and depth and the stop reason, one stderr line per turn
+// 23. Time management: a turn ends early once the most visited root move cannot
+//     be overtaken at the current iteration rate, on a winning root move and on
+//     a forced move (-DEARLY_STOP=0 for the fixed limits)
+// 24. Pondering in long-running mode: the tree keeps growing on the opponent's
+//     time until a reader thread hands over the reply (-DPONDER=0 to idle)
+// 25. Botzone requests are parsed in place from a fixed read(0) buffer and
+//     replies written with write(1); no iostream, strings or allocation
+// 26. Opening book for turns 1-4 (tools/book_gen.cpp): hash-sorted constexpr
+//     table, binary searched, played only when the move is legal
+// 27. Node arena and TT are mmap'ed with MADV_HUGEPAGE and the front of the
+//     arena pre-faulted; SEARCH_STATS reports page faults per search
+// 28. 16-byte nodes: no parent index (search() keeps the descent path), flags
+//     in one byte, MoveCursors in a per-thread side pool taken on the first
+//     expansion, the widening cursor's key inline; 24 bytes per node with
+//     node_wins and node_visits, plus the cursors of expanding nodes
+// 29. Region-cached distance layers: leaves reuse the root's layers in the arrow-
+//     walled regions their path left untouched (-DREGION_CACHE=1)
+// 30. Optional greedy rollouts of a few plies before the static evaluation,
+//     length by game phase (-DROLLOUT_PLIES=N or ROLLOUT_OPENING/MIDGAME/ENDGAME)
+// 31. Mirror symmetry: Zobrist keys make the row-flipped position's hash a
+//     rotation of the hash, the TT and the opening book key on the smaller one,
+//     and a symmetric position expands only one move of each mirrored pair
+// 32. Root prefilter: a one-ply reach/mobility score keeps the root to its best
+//     K moves (K by search time) plus a random sample (-DROOT_PREFILTER=0)
+// 33. MCTS-Solver: proven wins and losses climb the path, selection skips
+//     proven subtrees and the search stops once the root is proven
+// 34. Deterministic mode: a fixed rng_seed plus a node limit give bit-identical
+//     trees and moves run to run, for timing regressions (tools/bench)
+// 35. Evaluation weights and the UCB schedule are one flat list of tunables
+//     (get_tunable/set_tunable) for distributed SPSA tuning in tools/arena
+
+#include <vector>
+#include <array>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+using namespace std;
+
+// --- SEARCH MODE ---
+// TWO_LEVEL_TREE=1 splits every move into a queen-step node (half_move) whose
+// children are the arrow shots of the same player.
+#ifndef TWO_LEVEL_TREE
+#define TWO_LEVEL_TREE 0
+#endif
+
+// LONG_RUNNING=1 requests >>>BOTZONE_REQUEST_KEEP_RUNNING<<< after every turn
+// and keeps the search tree between turns; 0 is the single-shot bot032 protocol.
+#ifndef LONG_RUNNING
+#define LONG_RUNNING 1
+#endif
+
+// Default search thread count; --threads N on the command line overrides it.
+#ifndef SEARCH_THREADS
+#define SEARCH_THREADS 1
+#endif
+
+// Search backend: 0 = MCTS, 1 = alpha-beta (PVSEngine), 2 = hybrid, alpha-beta
+// once the root has at most HYBRID_MAX_MOVES moves. --engine mcts|pvs|hybrid
+// on the command line overrides it.
+#ifndef SEARCH_ENGINE
+#define SEARCH_ENGINE 0
+#endif
+
+// SIMD_LEVEL is the highest kernel set compiled in: 2 = AVX2, 1 = SSE4.2/popcnt,
+// 0 = portable scalar only (forced off x86). Which compiled set runs is decided
+// at startup from the host CPU (init_cpu_dispatch).
+#if !defined(__x86_64__) && !defined(__i386__)
+#undef SIMD_LEVEL
+#define SIMD_LEVEL 0
+#endif
+#ifndef SIMD_LEVEL
+#define SIMD_LEVEL 2
+#endif
+#if SIMD_LEVEL > 0
+#include <immintrin.h>
+#endif
+
+// --- CONSTANTS ---
+// board size: 8 * 8
+const int NUM_SQUARES = 64;
+const int BLACK = 1;
+const int WHITE = -1;
+
+// 2D Directions for row,col movement: N, S, W, E, NW, NE, SW, SE
+constexpr int DIRECTIONS[8][2] = {
+    {-1, 0},  // N
+    {1, 0},   // S
+    {0, -1},  // W
+    {0, 1},   // E
+    {-1, -1}, // NW
+    {-1, 1},  // NE
+    {1, -1},  // SW
+    {1, 1}    // SE
+};
+
+#pragma pack(push, 1)
+struct Move {
+    uint8_t from, to, arrow;
+    
+    Move() = default;
+    Move(int from_sq, int to_sq, int arrow_sq) 
+        : from(from_sq), to(to_sq), arrow(arrow_sq) {}
+    
+    bool operator==(const Move& o) const {
+        return from == o.from && to == o.to && arrow == o.arrow;
+    }
+};
+#pragma pack(pop)
+static_assert(sizeof(Move) == 3, "Move must be 3 bytes");
+
+const uint8_t NO_SQUARE = 255; // Arrow field of a queen-step (half) move
+
+// --- FAST RNG ---
+// rng_seed fixes the streams for reproducible runs (tools/bench); 0, the
+// default, seeds them from the clock. See deterministic_search().
+uint32_t rng_seed = 0;
+static thread_local uint32_t xorshift_state;
+void seed_rng(int thread_id = 0) {
+    xorshift_state = rng_seed ? rng_seed : (uint32_t)chrono::steady_clock::now().time_since_epoch().count();
+    xorshift_state ^= (uint32_t)thread_id * 0x9E3779B9u; // Distinct streams per search thread
+    if (xorshift_state == 0) xorshift_state = 0xDEADBEEF;
+}
+inline uint32_t fast_rand() {
+    uint32_t x = xorshift_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return xorshift_state = x;
+}
+
+// Per-move cap on MCTS iterations or alpha-beta nodes, 0 for none. The bot runs
+// on the clock alone; fixed-node matches (tools/arena) set it.
+uint32_t search_node_limit = 0;
+
+// Deterministic mode, for regression tests of search speed: with rng_seed and
+// search_node_limit both set, a search depends on its inputs alone. Every
+// search reseeds the RNG, the clock stops nothing (the node limit does, and
+// the endgame solver its own), and the search runs on one thread, so two runs
+// of a binary build the same trees and play the same moves.
+inline bool deterministic_search() {
+    return rng_seed && search_node_limit;
+}
+
+// --- MEMORY POOLS (Maximized for RSS-based memory management) ---
+// Botzone monitors RSS (Resident Set Size), not allocated memory.
+// Only touched/written memory counts toward the 512MB limit.
+// We can allocate large arrays; unused portions don't consume RSS.
+// Untried moves live in each node's MoveCursor, so there is no move pool.
+const int MAX_NODES = 24000000;       // 24M nodes over all threads - only used ones consume RSS
+
+// RSS limits (Botzone kills at 512MB). Past the soft limit the pool stops
+// taking fresh pages and the search runs on reclaimed nodes only; past the
+// hard limit the search stops.
+#ifndef RSS_SOFT_LIMIT_MB
+#define RSS_SOFT_LIMIT_MB 480
+#endif
+#ifndef RSS_HARD_LIMIT_MB
+#define RSS_HARD_LIMIT_MB 500
+#endif
+
+// Large arrays are mapped directly and offered to the kernel for transparent
+// huge pages (-DHUGE_PAGES=0 to keep 4 KB pages): random node access then
+// misses the TLB far less, and a 2 MB page is one fault instead of 512.
+// The front PREFAULT_SHARE of the soft limit is faulted in at startup, so the
+// nodes every search allocates first are already resident; the rest stays
+// untouched until used and RSS keeps tracking the tree. Without mmap or THP
+// this degrades to plain zeroed 4 KB pages.
+#ifndef HUGE_PAGES
+#define HUGE_PAGES 1
+#endif
+
+const size_t HUGE_PAGE_BYTES = 2 << 20;
+const double PREFAULT_SHARE = 0.125;
+
+// Zeroed memory of at least bytes, huge-page aligned (cache-line aligned in
+// the fallback), the first prefault bytes resident. Never freed.
+void* map_pages(size_t bytes, size_t prefault) {
+    size_t len = (bytes + HUGE_PAGE_BYTES - 1) & ~(HUGE_PAGE_BYTES - 1);
+    char* raw = (char*)mmap(nullptr, len + HUGE_PAGE_BYTES, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (raw == MAP_FAILED) return (void*)(((uintptr_t)calloc(bytes + 64, 1) + 63) & ~(uintptr_t)63);
+    // Trim to a huge-page aligned range
+    char* base = (char*)(((uintptr_t)raw + HUGE_PAGE_BYTES - 1) & ~(uintptr_t)(HUGE_PAGE_BYTES - 1));
+    if (base > raw) munmap(raw, base - raw);
+    if (raw + HUGE_PAGE_BYTES > base) munmap(base + len, raw + HUGE_PAGE_BYTES - base);
+#ifdef MADV_HUGEPAGE
+    if (HUGE_PAGES) madvise(base, len, MADV_HUGEPAGE); // Refused where THP is disabled
+#endif
+    prefault = min(prefault, len);
+#ifdef MADV_POPULATE_WRITE
+    if (prefault && madvise(base, prefault, MADV_POPULATE_WRITE) == 0) prefault = 0; // Linux 5.14+
+#endif
+    for (size_t off = 0; off < prefault; off += 4096) ((volatile char*)base)[off] = 0;
+    return base;
+}
+
+// Minor and major page faults of the process so far
+inline long page_faults() {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_minflt + ru.ru_majflt;
+}
+
+struct MCTSNode;
+
+// Global storage - large allocation, RSS only grows as we use it.
+// Structure-of-arrays: cold per-node data in node_pool, the statistics read by
+// every UCT scan in their own packed arrays, all indexed by node id.
+// The arena is shared; every slot in it belongs to exactly one search thread.
+MCTSNode* node_pool = nullptr; // Allocated on heap to avoid stack overflow
+float* node_wins = nullptr;
+int* node_visits = nullptr;
+
+const int NO_NODE = -1;
+
+// Children of a node sit in one contiguous block of 2^k slots. A full block is
+// moved to one twice its size; freed blocks go to per-size free lists.
+const int NUM_BLOCK_CLASSES = 13;  // Up to 4096 children (turn 1 has 2176 moves)
+const uint8_t NO_BLOCK = 0xFF;
+
+// Threads take fresh slots from the arena one chunk (= one largest block) at a
+// time, so the shared counter is touched once per 4096 slots.
+const int ARENA_CHUNK = 1 << (NUM_BLOCK_CLASSES - 1);
+const int MAX_SEARCH_THREADS = 64;
+atomic<int> arena_top(0);
+atomic<int> arena_usage[MAX_SEARCH_THREADS]; // Slots reserved by each thread
+int search_threads = SEARCH_THREADS;
+
+// Tree state below is per thread: each search thread owns a whole tree
+thread_local int thread_id = 0;
+thread_local int chunk_next = 0;         // Unused part of this thread's current chunk
+thread_local int chunk_end = 0;
+thread_local vector<int> owned_chunks;   // Every chunk this thread has reserved
+thread_local int free_blocks[NUM_BLOCK_CLASSES]; // Head of each free list, chained through MCTSNode::first_child
+thread_local int free_count = 0;                 // Free slots over all classes
+
+// Incremental GC: child blocks of discarded nodes still to reclaim.
+// Descriptors are copied out of the tree, so a block can be freed (and
+// reused) before the blocks below it have been visited.
+struct GCBlock {
+    int start;
+    uint16_t count;
+    uint8_t cls;
+};
+thread_local GCBlock* gc_stack = nullptr; // MAX_NODES entries, touched only as deep as it grows
+thread_local int gc_top = 0;
+
+const int GC_SLICE = 1024;      // Nodes reclaimed per 256 search iterations
+const int GC_SLICE_FULL = 65536; // Slice size once RSS is past the soft limit
+
+// --- BITBOARD UTILITIES ---
+// Square index is row * 8 + col, bit i of a bitboard is square i.
+inline int popcount(uint64_t b) {
+    return __builtin_popcountll(b);
+}
+
+inline int lsb_index(uint64_t b) {
+    return __builtin_ctzll(b);
+}
+
+inline int msb_index(uint64_t b) {
+    return 63 - __builtin_clzll(b);
+}
+
+inline uint64_t clear_lsb(uint64_t b) {
+    return b & (b - 1);
+}
+
+// --- GEOMETRY TABLES ---
+// Built by the compiler: no startup code, and no row/col arithmetic or bounds
+// checks left at run time. SquareTable<T> is an array indexed by square that a
+// C++11 constexpr function can return; Squares() is the index pack 0..63.
+template <typename T>
+struct SquareTable {
+    T v[NUM_SQUARES];
+    constexpr const T& operator[](int sq) const { return v[sq]; }
+};
+
+template <int... S> struct SquareList {};
+template <int N, int... S> struct MakeSquares : MakeSquares<N - 1, N - 1, S...> {};
+template <int... S> struct MakeSquares<0, S...> { typedef SquareList<S...> type; };
+typedef MakeSquares<NUM_SQUARES>::type Squares;
+
+constexpr bool on_board(int r, int c) {
+    return r >= 0 && r < 8 && c >= 0 && c < 8;
+}
+
+constexpr uint64_t ray_from(int r, int c, int dr, int dc) {
+    return on_board(r + dr, c + dc) ? (1ULL << ((r + dr) * 8 + c + dc)) | ray_from(r + dr, c + dc, dr, dc) : 0;
+}
+
+template <int... S>
+constexpr SquareTable<uint64_t> make_rays(int d, SquareList<S...>) {
+    return SquareTable<uint64_t>{ { ray_from(S / 8, S % 8, DIRECTIONS[d][0], DIRECTIONS[d][1])... } };
+}
+
+constexpr int abs_c(int x) {
+    return x < 0 ? -x : x;
+}
+
+constexpr int king_distance(int a, int b) {
+    return abs_c(a / 8 - b / 8) > abs_c(a % 8 - b % 8) ? abs_c(a / 8 - b / 8) : abs_c(a % 8 - b % 8);
+}
+
+template <int... T>
+constexpr SquareTable<uint8_t> make_distance_row(int a, SquareList<T...>) {
+    return SquareTable<uint8_t>{ { (uint8_t)king_distance(a, T)... } };
+}
+
+template <int... S>
+constexpr SquareTable<SquareTable<uint8_t> > make_distances(SquareList<S...>) {
+    return SquareTable<SquareTable<uint8_t> >{ { make_distance_row(S, Squares())... } };
+}
+
+// RAYS[d][sq]: every square reachable from sq in direction d on an empty board (sq excluded)
+constexpr SquareTable<uint64_t> RAYS[8] = {
+    make_rays(0, Squares()), make_rays(1, Squares()), make_rays(2, Squares()), make_rays(3, Squares()),
+    make_rays(4, Squares()), make_rays(5, Squares()), make_rays(6, Squares()), make_rays(7, Squares())
+};
+
+// SQUARE_DISTANCE[a][b]: king distance between two squares
+constexpr SquareTable<SquareTable<uint8_t> > SQUARE_DISTANCE = make_distances(Squares());
+
+static_assert(RAYS[3][0] == 0xFEULL && RAYS[7][0] == 0x8040201008040200ULL, "ray tables");
+static_assert(SQUARE_DISTANCE[0][63] == 7 && SQUARE_DISTANCE[27][36] == 1, "distance table");
+
+// Directions that step towards higher square indices (S, E, SW, SE); the first
+// blocker on these rays is the lowest set bit, on the others it is the highest.
+const bool RAY_POSITIVE[8] = { false, true, false, true, false, false, true, true };
+
+// Squares a queen on sq can slide to, stopping before the first occupied square
+inline uint64_t queen_attacks(int sq, uint64_t occ) {
+    uint64_t attacks = 0;
+    for (int d = 0; d < 8; d++) {
+        uint64_t ray = RAYS[d][sq];
+        uint64_t blockers = ray & occ;
+        if (blockers) {
+            int b = RAY_POSITIVE[d] ? lsb_index(blockers) : msb_index(blockers);
+            ray ^= RAYS[d][b] | (1ULL << b);
+        }
+        attacks |= ray;
+    }
+    return attacks;
+}
+
+// One king step in all 8 directions (destination masks stop file wrap-around)
+inline uint64_t king_step(uint64_t b) {
+    const uint64_t NOT_COL0 = 0xfefefefefefefefeULL, NOT_COL7 = 0x7f7f7f7f7f7f7f7fULL;
+    uint64_t h = b | ((b >> 1) & NOT_COL7) | ((b << 1) & NOT_COL0);
+    return h | (h << 8) | (h >> 8);
+}
+
+// --- ZOBRIST HASHING ---
+// Keys for an amazon of either color and for an arrow on every square. The side
+// to move needs no key: every move adds exactly one arrow.
+// Of the eight symmetries of the board only the row flip (row -> 7 - row) keeps
+// the start position and every amazon's color, so a position and its mirror
+// image are worth the same. A key of rows 4-7 is the key of the mirrored square
+// rotated by 32 bits, which makes mirror_hash(hash) the hash of the mirror
+// image; the TT and the opening book key on the smaller of the two.
+uint64_t ZOBRIST_PIECE[2][NUM_SQUARES];
+uint64_t ZOBRIST_ARROW[NUM_SQUARES];
+
+inline int mirror_square(int sq) {
+    return sq ^ 56;
+}
+
+inline uint64_t mirror_hash(uint64_t h) {
+    return (h << 32) | (h >> 32);
+}
+
+inline uint64_t canonical_hash(uint64_t h) {
+    return min(h, mirror_hash(h));
+}
+
+// Move of the mirror image; a half move keeps its NO_SQUARE arrow
+inline Move mirror_move(const Move& m) {
+    return Move(mirror_square(m.from), mirror_square(m.to), m.arrow == NO_SQUARE ? NO_SQUARE : mirror_square(m.arrow));
+}
+
+void init_zobrist() {
+    uint64_t x = 0x9E3779B97F4A7C15ULL; // Fixed seed: hashes are stable between runs
+    auto next = [&x]() {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    };
+    for (int sq = 0; sq < NUM_SQUARES / 2; sq++) {
+        ZOBRIST_PIECE[0][sq] = next();
+        ZOBRIST_PIECE[1][sq] = next();
+        ZOBRIST_ARROW[sq] = next();
+        ZOBRIST_PIECE[0][mirror_square(sq)] = mirror_hash(ZOBRIST_PIECE[0][sq]);
+        ZOBRIST_PIECE[1][mirror_square(sq)] = mirror_hash(ZOBRIST_PIECE[1][sq]);
+        ZOBRIST_ARROW[mirror_square(sq)] = mirror_hash(ZOBRIST_ARROW[sq]);
+    }
+}
+
+// --- NNUE ACCUMULATOR ---
+// EVAL_NNUE=1 replaces the handcrafted evaluation by a small quantized network:
+// 192 occupancy features (black amazon, white amazon, arrow on each square), one
+// hidden layer of 32 clipped-ReLU units and a linear output read as Black's
+// score before fast_sigmoid. Board keeps the hidden pre-activations (the
+// accumulator) and a move changes exactly three features, so apply_move adds or
+// subtracts three weight rows instead of recomputing 192 x 32 sums.
+// The tables below are written by tools/nnue_train.cpp.
+#ifndef EVAL_NNUE
+#define EVAL_NNUE 0
+#endif
+
+const int NNUE_FEATURES = 3 * NUM_SQUARES;
+const int NNUE_HIDDEN = 32;
+const int NNUE_QA = 127; // Hidden activation 1.0 and first-layer weight scale
+const int NNUE_QB = 64;  // Output weight scale
+const int NNUE_ARROW = 2 * NUM_SQUARES; // Feature of an arrow on square 0
+
+// BEGIN NNUE WEIGHTS
+// tools/nnue_train.cpp: 30000 games, 10 epochs
+constexpr int16_t NNUE_W1[NNUE_FEATURES][NNUE_HIDDEN] = {
+    {-10,0,-18,-13,3,-4,-6,-5,0,-4,-23,-24,2,-1,-1,-7,6,-8,-22,1,-14,-17,-9,-13,13,-11,11,11,5,-2,-22,-4},
+    {-36,-6,-20,-14,0,-4,-11,1,-16,-4,-11,-23,8,-4,-3,-7,3,-6,-21,-9,-9,-17,-7,-15,14,-10,6,7,3,1,-28,-6},
+    {-56,-6,-14,-14,-1,-3,-10,1,-9,-6,7,-17,4,1,-2,-4,4,-3,-24,-7,-6,-12,-6,-14,9,-3,5,8,6,-2,-27,-4},
+    {-58,-7,-17,-12,-3,-5,-12,21,-15,-4,19,-13,20,-7,-6,3,5,-6,-26,-3,-4,-12,3,-19,17,11,7,10,7,-10,-6,-5},
+    {-5,1,-25,-14,13,4,-15,4,-1,-12,20,-6,-3,1,-6,0,12,-11,-4,5,-15,-13,17,-27,13,140,2,8,9,-2,5,-13},
+    {16,10,-25,-14,7,2,-5,2,4,-8,-6,-14,9,-4,-2,19,7,-14,201,-10,-25,-17,5,-20,22,149,29,12,10,-17,7,-11},
+    {23,14,-23,-16,12,3,-3,-6,3,-7,-13,-16,5,-3,-8,9,10,-14,220,-10,-19,-16,-4,-17,16,83,6,12,7,-4,14,-8},
+    {21,14,-24,-12,15,1,-18,-12,6,-7,-14,-13,23,-5,-1,42,7,-4,-37,-2,-13,-14,21,-19,4,90,31,7,10,2,17,-14},
+    {6,5,-20,-14,-3,-1,-13,0,-7,-7,-24,-24,6,0,-2,-6,4,-12,-26,-8,-9,-17,-5,-12,15,-15,6,12,6,-1,-69,-6},
+    {-28,-9,-17,-16,-4,0,-10,5,-7,-4,-6,-27,11,-4,-1,3,0,-7,-21,-1,-5,-14,-5,-14,13,-15,5,5,2,4,-83,-3},
+    {-49,-2,-13,-11,-3,0,-14,-2,-2,-5,34,-23,-5,-1,-6,-6,0,-2,-20,-3,-9,-14,-6,-15,12,-7,4,9,2,4,-59,-6},
+    {-50,0,-13,-9,-2,1,-13,14,-6,-7,71,-14,16,-1,-4,6,4,-7,-27,-10,-9,-12,7,-17,16,17,7,10,6,-14,-16,-6},
+    {3,6,-14,-16,-3,5,-21,-20,1,-12,50,-13,-33,2,-2,17,9,-11,2,-5,-14,-13,26,-20,14,144,4,10,12,11,8,-11},
+    {20,5,-13,-15,2,4,-13,0,1,-15,5,-16,-1,-2,0,26,11,-14,254,-8,-14,-16,13,-17,26,153,-1,11,3,-2,20,-10},
+    {23,15,-12,-14,9,4,-15,6,1,-19,-10,-19,-36,0,-4,-16,4,-1,254,-26,-17,-9,5,-15,18,144,-24,14,7,0,11,-2},
+    {23,17,-15,-15,14,-2,-12,2,10,-12,-26,-17,6,-5,0,5,6,-6,254,-22,-18,-9,-2,-12,15,123,-14,26,9,-3,10,-7},
+    {25,6,-14,-18,1,-7,-21,-6,-1,-9,-18,-24,6,2,-6,-7,4,-10,-27,-5,-14,10,1,-9,10,-17,11,9,7,-3,-80,-10},
+    {14,-1,-20,-19,-3,-3,-23,0,-9,-6,1,-24,16,0,-2,-1,7,-9,-23,-6,-10,1,5,-8,13,-19,9,8,6,-2,-122,-6},
+    {-4,11,-15,-13,2,-16,-28,-4,-5,-8,52,-17,2,-1,-6,-5,3,-4,-16,-6,-11,-5,2,-6,13,-17,8,13,8,-8,-69,0},
+    {-9,8,-6,-12,0,3,-24,24,-12,-7,109,-14,28,1,1,1,6,-6,-21,-5,-5,-12,11,-1,16,4,9,7,5,-32,-10,-3},
+    {22,16,6,-14,-6,1,-28,13,-1,-11,70,-15,-10,1,-2,5,6,-13,-25,-10,-11,-21,36,-5,18,130,1,5,9,-13,17,-11},
+    {27,9,25,-18,4,1,-17,12,3,-12,6,-20,37,-4,-3,19,11,-5,247,-15,-15,-19,11,5,16,156,-10,11,8,-19,17,-11},
+    {25,10,20,-17,4,1,-15,0,4,-7,-21,-18,18,0,-5,21,11,14,253,-19,-13,-14,10,3,10,156,-15,3,7,-2,10,-9},
+    {20,9,-3,-11,27,-1,-5,-27,7,-3,-33,-21,50,0,-4,22,16,17,195,-6,-21,-13,14,-3,10,138,-21,15,5,-6,15,-9},
+    {30,14,-13,-18,6,-3,-19,-5,2,-11,-21,-26,14,1,-8,-8,5,-11,-26,-6,-13,73,0,-10,8,-14,14,10,8,-2,-63,-14},
+    {31,4,-21,-20,0,3,-25,-1,-6,-10,4,-19,10,3,-5,-8,18,-6,-24,-4,-7,84,2,-5,8,-17,10,11,8,-6,-67,-15},
+    {26,8,-24,-20,0,-21,8,-2,-4,-7,37,-7,13,3,-4,-7,-4,-8,-20,5,-16,35,16,8,9,-23,10,11,3,4,-41,-2},
+    {30,-1,-4,-19,-6,4,-15,7,-6,-8,76,9,16,9,2,-1,5,-8,-31,-5,-7,-8,28,24,9,-16,8,7,-1,5,13,-2},
+    {27,7,124,-17,-15,-4,-7,2,3,-9,37,5,-10,1,-9,1,1,-8,-39,-15,-11,-21,43,23,15,10,-3,4,3,13,25,-4},
+    {31,2,131,-21,5,3,-30,5,1,-5,-10,-2,13,0,-6,11,9,27,-26,-11,-11,-21,63,23,9,151,-36,-14,7,6,22,-7},
+    {25,7,78,-20,-4,0,-19,-4,4,-2,-28,-13,22,-1,-10,16,9,157,1,-12,-12,-17,31,15,2,110,-32,3,3,1,15,-10},
+    {25,3,14,-17,3,-7,-24,5,8,-7,-32,-17,40,1,-10,7,5,155,-5,-7,-10,-11,23,9,-3,146,-17,-4,6,-2,15,-6},
+    {24,21,-18,16,1,-10,-24,-4,7,-9,-18,-17,15,2,-7,-8,5,-10,-23,-19,-10,154,2,-12,14,-14,14,10,7,0,-13,-9},
+    {28,18,-24,22,-5,-6,-51,-6,-4,-7,-6,-2,1,9,-2,-8,21,-5,-22,-26,-1,134,2,1,5,-16,11,10,4,0,-16,-8},
+    {27,-3,-28,-2,-4,-47,-35,0,-6,-4,3,17,12,-4,-7,1,-16,-10,-12,-16,-4,111,15,18,-10,-22,11,7,3,7,1,-2},
+    {28,-17,-8,-8,-1,4,-155,-1,-9,-11,7,121,6,14,1,-8,4,-14,-23,-11,9,9,17,32,-17,-20,6,4,3,-3,15,0},
+    {22,0,126,-14,-14,-7,-15,-1,0,0,-3,177,17,-1,4,-2,2,-9,-25,-16,-4,-16,24,25,0,-11,6,0,6,3,20,-1},
+    {19,4,149,-11,1,4,-27,4,4,1,-21,159,19,3,-6,-1,8,156,-30,-22,-7,-21,39,15,11,0,-17,-16,3,-2,16,-1},
+    {23,6,155,-17,5,3,-16,3,4,15,-27,14,14,-2,4,0,9,163,-2,-23,-10,-15,42,-2,3,14,-29,16,10,2,18,-6},
+    {20,5,39,-15,14,3,-15,-2,6,-2,-21,-12,6,4,-4,3,12,150,-10,-12,-6,-17,42,-9,-3,9,-27,-4,11,2,15,-7},
+    {21,12,-8,145,4,-10,-33,-5,5,-9,-14,-15,12,3,-9,-8,6,-7,-27,-19,-12,133,5,-14,18,-10,13,11,4,-6,6,-21},
+    {22,10,-19,123,-5,-1,-41,-5,-6,-8,-13,-7,0,7,-4,-4,20,-3,-21,-20,-4,151,13,0,-6,-12,8,9,2,2,12,-17},
+    {16,-11,-20,98,3,-16,31,-2,5,-9,-8,7,24,10,-5,-6,-2,-8,-19,-18,-16,119,24,16,-141,-12,12,13,1,0,11,-21},
+    {23,-11,-17,14,-3,17,-25,-4,-5,-8,-18,166,0,35,-3,-7,11,-15,-8,-22,-7,4,42,12,-138,-15,9,7,-8,4,15,6},
+    {23,6,79,-11,8,3,-3,-4,5,5,-20,163,11,10,-5,-9,2,-8,-17,-24,-3,-11,68,-35,-62,-18,9,2,0,3,19,-7},
+    {30,7,92,-17,5,2,-20,-8,6,24,-20,153,4,0,-61,-6,4,155,-21,-19,-10,-17,70,-63,-16,-19,12,-20,-2,-1,21,-13},
+    {30,6,79,-17,7,-3,-21,-7,2,8,-16,46,15,-4,-16,0,3,154,-12,-17,-3,-13,48,-71,-2,-9,-5,10,9,2,22,-8},
+    {24,12,24,-14,-1,-2,-19,-1,0,14,-20,12,15,3,-18,4,7,159,-20,-16,-8,-13,47,-40,10,-3,3,-1,18,0,16,-3},
+    {18,13,-13,144,5,-6,-24,-4,3,-10,-18,-19,7,6,-8,-7,5,-7,-26,-22,-10,59,4,-14,12,-10,13,8,4,-3,17,-12},
+    {18,44,-16,144,-2,-6,-42,-4,0,-5,-14,-17,6,6,-2,-1,6,-2,-19,-30,1,64,3,-4,-28,-8,5,8,4,4,17,-5},
+    {22,-3,-20,146,-1,-11,-51,1,4,-3,-14,-7,10,6,-6,-6,-5,-7,-11,-32,1,33,9,-5,-155,-12,9,9,8,1,15,-41},
+    {20,4,-14,71,-4,1,-47,-3,3,-3,-18,153,11,17,-10,-11,4,-13,-8,-23,10,-11,20,-28,-140,-13,12,8,17,0,6,-14},
+    {24,11,24,-1,3,1,-28,-2,4,-3,-19,161,14,-1,0,-10,7,1,-4,-21,27,-12,22,-97,-118,-17,8,0,33,3,16,-20},
+    {28,13,15,-20,-6,6,-16,-7,2,9,-15,154,8,4,-14,-13,12,145,-10,-7,5,-13,25,-98,-46,-18,6,5,25,1,19,2},
+    {27,6,22,-14,7,7,-9,-7,-6,-14,-15,145,-3,1,-8,-11,12,157,-5,-16,8,-13,34,-135,-2,-14,-2,-1,19,4,18,-6},
+    {28,5,1,-15,0,5,-10,-8,-3,2,-12,14,-2,-3,-8,-4,10,136,-20,-6,-4,-14,41,-65,10,-11,9,3,15,5,23,-8},
+    {18,8,-17,146,5,-9,-23,0,5,-9,-18,-20,13,5,-5,-9,6,-5,-24,-17,-9,9,-1,-11,8,-13,11,8,4,-5,14,-9},
+    {20,15,-20,155,-2,-4,-26,-2,4,-7,-20,-23,7,5,-4,-6,3,-5,-23,-26,1,8,6,-5,-27,-13,11,10,8,-1,17,-5},
+    {19,11,-10,143,0,-1,-33,-5,5,-4,-16,-18,13,8,-6,-7,3,-4,-19,-31,-10,-1,10,-10,-119,-11,11,9,8,-4,13,-22},
+    {24,14,-7,102,-1,1,-35,-10,6,-5,-16,5,5,10,-6,-9,7,-8,-25,-17,-4,-23,34,-39,-151,-8,12,8,10,-1,10,-17},
+    {29,11,1,5,9,3,-23,-6,6,0,-15,29,11,5,-8,-10,7,8,-14,-24,0,-12,42,-99,-146,-14,9,3,13,0,21,-22},
+    {27,10,-6,-13,4,0,-8,-11,5,14,-13,38,8,3,-18,-7,10,51,-26,-19,-8,-15,48,-100,-42,-13,10,14,14,-1,22,-14},
+    {26,8,-17,-15,1,0,-6,-8,2,4,-12,44,6,0,-6,0,7,153,-25,-7,0,-15,34,-103,-1,-16,7,12,15,2,22,-12},
+    {29,11,-21,-15,-5,-1,-12,-4,5,17,-8,9,13,0,-8,-10,8,151,-28,1,-12,-17,25,-60,8,-15,13,24,16,1,24,-7},
+    {14,4,4,3,-10,16,-31,19,108,2,5,-5,42,-13,18,22,-2,10,4,-23,4,13,23,-8,-12,3,-12,-20,-7,10,3,-3},
+    {12,9,-1,9,-7,16,-25,4,130,9,2,-2,13,-16,12,19,-6,6,-10,-11,6,3,32,-1,-5,1,-15,-13,-9,-1,17,4},
+    {34,7,8,13,-17,11,-29,-10,141,10,4,0,6,-16,11,14,-4,0,-17,-10,5,4,30,-10,-8,8,-2,-19,-8,-22,-2,-2},
+    {24,1,1,9,-17,22,-31,-80,65,5,1,2,-5,-7,19,4,-11,10,-14,-18,7,0,36,2,-11,5,-11,-11,-6,-5,2,5},
+    {15,-3,4,10,-18,15,-28,-145,-2,13,-6,-3,54,-15,13,-22,-9,5,2,-27,6,6,25,-6,-3,0,-16,-14,-17,-8,-2,6},
+    {6,-4,4,9,-10,15,-24,-101,-9,13,0,3,56,-17,9,-94,-6,5,-8,-24,3,10,30,-8,-6,5,-12,-12,-10,12,-6,7},
+    {4,-3,4,7,-16,19,-24,-26,-11,13,-2,-2,56,-21,12,-121,-8,5,-5,-22,6,4,31,-5,-6,-4,-8,-15,-12,17,-3,5},
+    {3,-3,5,7,-15,20,-25,8,-10,8,0,1,27,-18,9,-149,-7,6,-2,-26,4,6,39,-6,-6,2,-2,-13,-8,18,-6,4},
+    {17,7,3,5,-10,5,-28,20,143,3,-2,-8,41,-16,19,24,16,0,-13,-32,6,15,25,-3,-10,8,-4,-10,-7,7,25,8},
+    {32,7,-4,13,-16,2,-39,6,132,2,4,0,10,-11,17,21,20,1,-15,-8,-2,3,26,-1,-3,-1,-7,-10,-12,-13,31,10},
+    {32,11,2,12,-22,0,-30,-20,141,10,0,-4,-11,-11,17,17,1,2,-15,-17,-2,2,26,-7,0,1,-15,-12,-16,-69,26,8},
+    {21,-4,-1,12,-14,14,-30,-81,65,7,-5,3,-8,-10,19,2,-13,1,-19,-16,3,6,25,-7,-6,10,-10,-9,-11,-78,6,-4},
+    {14,-3,2,11,-6,19,-27,-165,-2,11,-1,-4,42,-16,17,-29,-10,1,0,-22,4,7,17,-10,-4,5,-1,-13,-13,-144,-1,2},
+    {6,-3,1,11,10,13,-27,-107,-11,8,-6,2,56,-21,21,-133,-8,-1,-4,-26,0,7,21,-10,-2,10,11,-13,-12,4,-5,6},
+    {5,-3,4,7,-8,17,-25,-27,-13,10,-4,-1,37,-19,12,-120,-6,0,10,-18,4,4,34,-6,-4,0,46,-18,-10,17,-3,6},
+    {5,-5,4,7,-15,22,-23,13,-11,7,-1,2,14,-17,13,-114,-8,2,-7,-22,0,8,42,-5,-8,-1,52,-19,-11,18,-4,6},
+    {7,1,6,4,-7,-4,-29,21,149,10,10,1,42,-16,16,26,146,12,-12,-24,6,11,19,-2,-6,7,-16,-19,-8,17,26,4},
+    {18,1,7,12,-11,-20,-23,11,158,11,-3,1,6,-9,19,16,112,8,-15,-1,2,4,24,-9,-9,12,-10,-10,-8,-20,23,13},
+    {16,7,1,12,-21,-20,-25,-1,162,12,4,0,-33,-11,16,12,23,5,-21,-36,2,1,22,-8,-6,8,-20,-13,-12,-148,23,16},
+    {19,7,0,13,-8,-10,-22,-79,36,6,-7,-3,-36,-6,23,8,-13,-2,-20,-28,4,2,15,-9,-1,4,-11,-16,-18,-149,7,11},
+    {10,0,2,11,48,11,-22,-82,-7,7,4,-5,12,-16,25,-8,-16,2,1,-20,5,5,14,-6,-3,2,-1,-7,-14,-159,-1,3},
+    {6,-4,11,12,51,11,-26,-62,-14,3,2,-2,20,-17,24,-75,-7,2,-9,-19,0,12,15,-8,-6,13,49,-8,-10,-2,-8,8},
+    {5,-5,3,8,17,20,-23,-1,-14,11,-4,-1,3,-18,14,-117,-6,-2,-6,-21,-3,5,32,-8,-3,4,191,-3,-10,16,-2,6},
+    {5,1,7,10,-9,18,-23,15,-11,7,1,5,-8,-17,5,-100,-8,2,-9,-25,0,8,37,-9,-5,3,99,5,-7,14,-7,5},
+    {4,-20,-1,2,-7,-11,-19,24,52,17,-7,2,14,-15,19,18,159,-2,-18,-9,-6,-8,12,-5,-3,8,-24,-18,-14,23,27,-7},
+    {2,-16,3,3,-14,-118,-20,17,68,15,-5,0,-8,-11,24,23,156,8,-23,24,2,-7,20,-5,-3,11,-23,-18,-14,11,25,-1},
+    {8,-10,-6,5,-23,-147,23,5,10,12,-10,-5,-36,2,22,14,146,3,-25,-33,0,-13,18,-5,3,6,-22,-15,-18,-87,30,16},
+    {4,2,0,10,14,-150,-4,3,-6,6,-13,-4,-31,14,12,7,-5,-3,-23,-41,14,-3,23,-4,2,5,-24,-18,-18,-157,8,16},
+    {2,1,-4,13,75,2,-6,10,-18,9,-6,3,2,9,10,5,-16,1,-17,-30,15,6,21,-2,1,3,-8,-5,-13,-123,-6,15},
+    {4,-7,15,10,94,16,-24,0,-14,13,-5,2,-2,-11,16,-8,-12,1,-3,-23,1,6,15,-4,-2,1,37,79,-11,4,-7,9},
+    {3,-3,5,10,31,18,-27,6,-10,11,-2,1,-8,-18,5,-19,-7,6,-5,-21,1,7,24,-6,-5,3,102,121,-9,15,-4,6},
+    {5,-4,5,9,-10,18,-23,13,-13,8,3,3,-14,-17,4,-20,-9,4,-5,-20,1,7,38,-8,-5,0,83,96,-7,17,-3,5},
+    {6,-12,1,3,-14,-11,-34,12,-8,8,2,8,0,-9,9,21,155,5,-21,132,10,-13,33,-4,-10,11,-18,-21,-9,10,7,-172},
+    {0,-3,1,-4,-10,-145,4,7,-2,10,-7,-7,-5,7,15,23,162,1,-11,38,-3,-4,14,-10,-3,5,-19,-14,-13,10,12,-164},
+    {6,-6,-7,2,-15,-114,28,7,-15,3,-5,-8,-14,126,15,14,157,1,-23,-34,10,-23,11,-5,-2,8,-14,-15,-16,4,6,-171},
+    {-1,13,3,1,5,-152,42,17,-17,-1,-4,-2,2,163,10,16,-2,0,-33,-30,19,-6,29,1,0,2,-14,-13,-3,-6,1,15},
+    {0,-3,0,11,69,1,-2,15,-11,5,0,9,-6,147,-157,13,-12,-2,-23,-28,27,4,8,1,0,3,-12,-9,-3,6,-7,11},
+    {2,0,30,8,50,14,-24,14,-8,4,-3,0,8,4,-125,15,-11,-5,-17,-21,14,8,4,-7,-1,0,16,101,-4,14,-8,11},
+    {3,1,8,10,12,15,-28,11,-8,-17,-2,8,0,-11,-128,14,-8,10,-16,-19,3,10,13,-6,-3,8,51,140,-9,15,-8,2},
+    {3,-5,9,12,-18,16,-29,10,-10,-23,2,5,0,-14,-26,16,-11,6,-14,-17,0,8,31,-6,-6,9,63,143,-13,16,-9,2},
+    {16,220,5,3,-13,-6,-38,10,-23,5,10,-1,7,-9,6,21,151,5,-23,234,12,7,31,-13,-18,12,-16,-17,-8,10,-10,-138},
+    {10,198,5,-1,-17,-70,-31,11,-24,12,7,-3,0,5,13,20,98,5,-28,250,-3,12,16,-13,-6,12,-19,-14,-3,18,-9,-156},
+    {17,186,-7,-7,-21,-131,68,16,-21,11,-4,0,20,123,22,19,147,1,-21,-13,-18,-9,-13,-8,7,11,-8,-11,3,22,-9,-155},
+    {3,-4,-6,-4,-8,-73,14,15,-12,-7,-3,7,9,145,9,15,-13,-1,-35,-20,29,-1,-9,-3,2,5,-10,-9,134,19,-7,-158},
+    {0,-6,-12,9,-4,13,8,16,-9,-8,-5,29,14,139,-142,16,-5,2,-28,-19,29,2,-8,2,11,3,-6,-1,161,11,-11,13},
+    {3,1,21,9,14,13,-23,6,-8,-76,-3,15,-9,-2,-118,12,-5,-3,-18,-18,32,8,1,-12,-1,4,-10,74,146,14,-13,13},
+    {0,-3,7,12,-4,15,-26,14,-6,-119,-6,4,15,-8,-102,17,-6,18,-8,-21,-21,9,4,-2,-1,5,3,135,-3,13,-9,2},
+    {5,-6,11,11,-14,15,-25,10,-8,-102,2,5,9,-12,-33,20,-10,7,-7,-27,-16,8,23,-9,-5,7,10,141,-14,12,-9,-7},
+    {11,207,0,6,-14,-2,-39,14,-16,13,2,-5,-1,-7,13,22,9,6,-22,251,-6,1,33,-13,-12,8,-17,-16,-4,16,-14,-167},
+    {8,221,4,15,-13,-7,-23,19,-13,14,6,2,11,19,15,15,13,4,-33,254,-28,-4,18,-9,-3,8,-17,-14,7,16,-9,-166},
+    {8,187,1,5,-17,2,-26,13,-10,18,3,3,6,96,21,19,-10,3,-29,254,-59,2,8,-9,-14,13,-15,-10,31,20,-12,-141},
+    {-1,16,-1,-9,-19,-1,-10,12,-3,14,-7,-2,13,127,-1,15,-10,3,-27,-6,-84,1,-14,-8,-20,7,-8,-6,174,16,-9,-186},
+    {2,-14,1,1,-14,14,-32,10,-10,-18,-6,17,15,84,-90,20,-5,2,-27,-16,-84,3,-14,-3,-12,9,-1,-3,125,14,-9,-4},
+    {5,4,11,5,-6,13,-28,11,-12,-104,-1,10,9,-4,-102,15,1,-1,-14,-18,-72,6,0,-25,-6,7,-10,18,153,10,-9,21},
+    {3,0,6,8,-13,15,-26,16,-6,-141,-1,4,18,-8,-86,14,-5,11,-15,-25,-62,8,11,-9,1,6,-10,57,10,13,-7,7},
+    {5,-7,8,10,-22,14,-27,16,-11,-159,2,5,20,-13,-27,17,-8,5,-9,-25,-31,7,28,-5,-4,5,-13,77,-11,12,-9,-2},
+    {8,214,3,-3,-16,13,-31,13,-11,9,5,0,-2,-9,10,20,-10,11,-10,251,-1,18,47,-12,-20,8,-22,-15,-4,11,-11,-164},
+    {8,216,5,4,-14,9,-35,16,-12,13,3,-3,-6,11,15,18,-14,7,-21,253,-37,11,38,-12,-6,6,-23,-14,6,16,-6,-163},
+    {11,207,5,6,-12,17,-20,10,2,19,-3,0,-8,30,12,13,-5,-1,-24,-20,-105,10,-5,-19,-3,12,-15,-9,42,14,-7,-170},
+    {4,7,-3,-1,-13,11,-39,10,-8,13,-7,7,-8,28,3,18,-8,2,-26,-19,-130,3,-2,-11,-3,9,-18,-6,126,17,-6,-165},
+    {2,-12,2,8,-21,13,-34,13,-10,-16,-6,12,1,14,-30,18,-4,6,-29,-26,-145,1,-1,-4,-1,11,-11,-8,151,9,-12,-9},
+    {6,-3,8,7,-1,8,-27,5,-10,-112,4,11,2,-10,-38,16,-3,5,-17,-29,-171,8,23,-20,-9,11,-10,-6,152,16,-12,10},
+    {2,-3,6,12,-10,14,-26,16,-11,-157,-3,6,10,-15,-36,22,-8,4,-11,-26,-134,6,20,1,-3,9,-14,1,14,15,-11,10},
+    {2,-6,7,11,-12,19,-22,12,-10,-133,5,6,14,-17,-16,23,-9,5,-9,-25,-35,7,34,-3,-4,9,-11,9,-7,18,-9,2},
+    {-4,-3,-1,-2,1,0,-2,3,12,0,-5,-2,7,0,2,1,0,-2,-3,2,-2,-5,-1,2,-1,-1,2,-3,0,1,-8,2},
+    {-18,-6,-3,-3,-2,3,-5,3,11,1,-3,-1,4,-1,0,1,-3,0,-3,5,1,-5,3,1,1,-2,-1,-1,-2,-2,0,0},
+    {-24,-4,1,0,-3,1,0,-7,14,0,4,2,-1,3,-1,0,-5,1,1,3,3,1,0,-1,-1,0,3,1,-1,-5,-4,2},
+    {-24,-3,-1,-2,-5,2,-1,-11,5,3,7,2,7,1,-1,2,-2,1,7,1,-1,1,1,-1,-1,3,0,1,-1,-9,-1,1},
+    {-7,-4,-2,1,-3,-1,0,-26,-1,3,7,3,9,-1,-1,-6,-2,0,15,3,2,1,1,-3,1,8,-6,0,-1,3,-1,0},
+    {-1,-1,-3,1,-4,0,0,-15,-2,3,7,6,27,-2,-1,-11,-1,-3,14,-2,1,1,-5,-3,2,13,-3,-2,-2,-1,-1,1},
+    {0,-2,-3,0,-5,2,1,-5,-3,5,-1,1,10,-4,2,-29,-1,-3,23,-2,2,-1,-5,-2,3,8,-16,-1,-3,4,1,2},
+    {1,-4,-1,0,-4,1,0,1,-3,2,1,2,8,-2,0,-17,0,-2,15,-5,3,-2,2,-3,3,7,4,-6,0,2,0,1},
+    {6,-1,-1,-2,0,-2,-5,4,14,0,-7,-2,10,1,2,0,4,-2,-7,7,1,-6,4,1,2,-2,2,0,1,4,-12,4},
+    {0,-6,2,0,-1,-1,-6,4,27,-1,-2,-1,9,-2,-1,3,0,1,-7,11,1,-6,8,1,-1,-1,2,-2,-1,-1,-8,0},
+    {-18,-6,2,1,-6,2,-3,-9,27,0,9,-1,-19,2,0,0,-5,2,0,7,0,-1,4,-2,0,-1,-2,0,-2,-10,-5,0},
+    {-23,-6,-4,0,-2,4,-1,-18,10,1,14,3,4,1,-1,4,-5,-1,3,2,-2,2,-2,-4,-1,7,2,0,-3,-20,-3,-1},
+    {-6,-2,-1,0,0,2,1,-52,0,1,14,0,-11,-3,-2,1,-3,-4,17,-1,1,1,-7,-4,1,11,-1,-2,0,7,-1,-1},
+    {2,2,-4,1,4,-2,-1,-20,-1,-1,7,3,14,-2,2,-15,0,-6,20,-1,0,0,-7,-4,3,27,-3,-3,0,0,0,0},
+    {0,-2,-1,-1,-3,1,3,10,-1,0,-2,-3,-18,-1,0,-44,-2,-3,37,-1,0,-1,-7,0,1,15,-11,-4,-1,4,1,-1},
+    {0,-3,0,-1,-4,3,2,13,-2,2,-5,0,-13,-2,0,-31,-2,0,22,-3,0,-1,0,1,0,8,6,-6,-2,3,0,2},
+    {8,-1,2,-3,5,-5,-3,1,15,-1,-5,-1,8,-3,1,1,11,0,-1,9,-1,2,2,1,-2,-1,2,0,2,4,-19,2},
+    {8,-2,3,0,0,-6,-4,-1,21,-3,1,1,4,1,2,-3,13,2,-5,13,-2,-5,6,1,-3,1,2,1,2,-4,-30,7},
+    {0,-2,1,-1,-8,-12,-5,-6,15,2,18,-1,-21,-3,-3,-3,1,2,2,5,-1,0,3,1,0,-7,-1,1,-1,-23,-8,7},
+    {0,1,0,1,3,5,-2,-4,-3,0,29,-4,-3,-1,4,-1,-1,-1,4,8,1,-2,-7,-1,2,-2,1,0,-2,-47,-3,3},
+    {3,1,2,0,17,-1,1,-12,-2,0,24,-9,-8,-5,8,2,-5,-5,14,2,1,-4,-8,3,3,3,2,1,-1,-18,5,0},
+    {2,2,10,-1,20,0,0,0,-3,1,7,-7,18,-5,9,3,1,-6,10,0,1,-1,-13,5,2,23,10,-1,0,-8,1,1},
+    {-1,-2,3,0,7,0,2,3,0,1,-4,-2,-9,-1,5,-5,1,1,25,-2,-1,-1,-4,4,0,23,25,-8,0,6,-1,-1},
+    {0,0,2,0,-4,1,2,5,-2,4,-3,-2,-8,-1,2,-3,0,7,14,-2,2,0,3,2,-1,10,25,-4,1,1,-3,1},
+    {9,-7,1,-7,4,0,0,4,9,1,-5,-3,8,-4,-1,2,18,-2,-2,15,0,4,4,-1,1,-1,0,0,0,6,-13,-1},
+    {7,-16,-1,-6,-3,-3,0,1,7,0,2,-3,-3,-2,1,-2,29,1,-3,13,1,7,4,1,1,-1,-3,-1,-1,-3,-14,-2},
+    {4,-9,-8,-8,-7,-29,42,-4,2,2,8,-1,-19,0,3,3,1,-2,2,17,-3,0,9,4,5,-7,-6,-2,-5,-3,1,14},
+    {6,-9,1,-5,13,0,16,3,-5,-2,11,-2,-12,9,1,-2,-2,-6,-1,7,6,-4,6,10,4,-8,-6,-7,-10,-11,5,8},
+    {2,-4,1,-2,20,-5,19,4,-3,2,8,5,-7,-1,5,2,-8,-5,3,0,5,-7,0,15,8,-3,-4,-4,-5,0,6,8},
+    {2,-3,23,-1,38,4,2,2,-2,5,-2,-3,-5,-6,4,5,-2,-2,8,3,1,-4,-9,12,4,5,-1,-1,-6,9,5,0},
+    {0,2,9,-1,4,0,0,-2,1,6,-6,-4,-11,-5,2,7,-1,11,15,-2,2,-2,-11,8,0,12,30,3,-3,5,0,0},
+    {1,-1,2,0,-7,0,0,3,-3,5,-5,-4,-10,-3,0,6,-2,12,15,0,3,1,-3,4,0,2,33,0,-1,1,-1,0},
+    {3,5,3,-3,2,-4,-2,2,5,0,-3,-1,5,-4,-2,-1,19,1,-2,20,2,24,3,-1,3,1,1,0,0,5,-2,-3},
+    {3,3,-1,-8,-3,-7,-2,-4,-7,0,3,-1,-10,1,1,-1,36,3,-2,10,1,30,-2,1,0,0,0,1,-1,-1,-1,-1},
+    {3,-9,-7,-8,-1,-51,25,3,-5,3,4,-2,-4,-3,1,3,-9,-2,10,13,4,4,-3,8,1,-7,-3,-4,-3,4,3,2},
+    {3,-11,1,-5,9,-4,5,6,-9,-4,5,2,-2,18,6,-1,-1,-6,5,11,19,0,-6,14,-2,-7,-3,-5,-3,-10,2,14},
+    {1,-4,8,-1,18,-6,13,6,0,2,6,14,-5,-1,-3,0,-7,-8,2,8,19,-4,-16,18,3,-8,-4,-2,2,0,5,6},
+    {0,0,38,-2,20,4,-5,5,0,4,-2,0,4,-3,-7,2,-1,-5,0,3,11,-2,-14,5,3,-5,2,5,-3,0,2,5},
+    {-2,3,13,2,7,2,2,-2,0,11,-5,-2,-6,-2,5,3,1,21,-1,-1,1,0,-13,5,0,5,2,45,-1,2,-1,2},
+    {-1,1,3,-1,-5,2,1,-1,-1,2,-5,-4,-8,0,3,4,2,21,8,-3,1,1,-2,3,1,3,6,26,-3,3,-1,0},
+    {1,9,1,4,3,2,-2,0,-3,0,-2,-1,-1,-5,-2,1,12,-3,-2,25,2,25,6,-3,6,0,0,-1,-1,1,4,-12},
+    {0,7,-2,2,-1,-3,1,-3,-8,-3,0,-3,-4,1,-1,0,18,2,2,24,4,31,-3,0,0,1,-2,-3,-4,1,4,-25},
+    {0,-24,-11,-6,-6,-15,106,3,-2,0,0,4,18,13,9,1,-4,-2,8,19,-5,3,0,9,0,-4,3,1,-2,2,3,-18},
+    {-1,-12,-4,-5,2,19,25,4,-4,-4,-3,17,-5,45,7,-2,1,-9,7,13,7,0,-12,12,-5,-6,-3,-4,-5,2,2,12},
+    {0,-7,-9,0,4,2,22,6,0,1,-2,40,7,18,-6,-1,-4,-6,6,7,14,-4,-4,10,6,-6,-1,-1,5,3,1,15},
+    {-2,-4,29,-1,8,3,-8,-1,2,9,-4,20,-8,1,-62,-1,-2,-4,4,3,6,-2,-14,-4,3,-10,-1,-5,-10,4,1,0},
+    {-2,2,8,0,-4,-2,-1,1,3,-5,0,1,4,-5,-17,0,-1,32,10,0,3,1,-13,-2,0,-7,-1,28,-4,-3,0,-2},
+    {2,-1,3,0,-9,-3,-1,0,-1,-3,0,-4,6,-1,-12,7,-3,23,8,-7,-1,1,-4,-2,2,-3,4,24,-6,-2,-1,-1},
+    {-1,24,0,24,-1,0,-2,0,-3,0,-4,0,-3,-5,-3,3,2,-3,-4,21,4,4,4,-3,11,-2,-3,-3,0,0,3,-10},
+    {0,56,-1,35,0,-2,-2,-1,-3,1,2,1,0,3,2,1,-1,1,2,12,-2,3,-1,1,4,0,-2,-1,-2,4,0,-10},
+    {0,-3,-5,17,3,-5,-5,2,3,3,0,-1,6,8,6,-1,-13,0,5,8,0,-1,-11,8,-20,1,-1,-2,8,1,-1,-45},
+    {-1,6,0,-2,-8,3,-4,2,2,8,2,2,8,18,2,0,-1,-4,7,6,-5,2,-18,2,-38,0,3,2,24,-1,0,0},
+    {-1,-5,-1,-2,0,0,-8,1,-1,-3,-1,17,5,0,0,-1,-1,-4,8,5,9,-1,-22,-6,-23,-2,1,-2,40,-1,-1,3},
+    {1,3,8,-7,-7,0,-8,-1,-2,-10,1,15,3,1,-18,-1,3,-4,6,11,-8,1,-19,-26,-6,-6,1,-3,17,-2,1,17},
+    {1,1,0,0,-1,2,-1,1,0,-44,2,6,-2,-2,-7,-1,0,18,6,0,3,1,-13,-17,3,-5,-4,-3,-3,0,1,-1},
+    {3,-2,-3,2,-4,2,-1,1,-1,-28,2,-1,0,-1,-3,1,-2,15,4,-5,1,0,-6,-10,4,-4,-1,1,-10,0,1,-4},
+    {1,16,-1,16,-2,0,-1,2,1,3,-2,0,1,0,0,0,-2,-2,1,15,-4,2,2,0,0,-1,-2,1,-2,0,3,-7},
+    {1,27,-2,22,-1,3,0,-1,0,3,-2,-5,-7,1,2,4,-8,0,-2,15,-4,-7,4,1,-2,-3,-5,0,0,1,2,-15},
+    {1,9,1,24,2,4,-6,1,0,7,0,-1,0,6,5,-2,-6,-2,-1,10,-26,-8,-1,-1,-12,1,-2,3,7,-3,-2,-19},
+    {3,10,1,8,-1,3,-4,-2,-2,10,2,-4,-3,6,1,1,-1,-5,2,5,-39,-5,-2,-7,-24,-1,-1,2,15,0,1,1},
+    {3,-8,0,6,3,-1,-5,1,-1,2,2,3,-2,-2,-3,0,0,0,3,-1,-44,-6,-2,-12,-18,-2,0,-2,19,0,-1,0},
+    {4,-2,0,-2,0,-3,-3,-2,-3,-8,2,5,1,0,-8,3,2,0,2,0,-38,0,1,-26,-8,-2,1,-4,8,-2,0,7},
+    {3,-1,-3,-3,-1,0,-2,3,-3,-25,0,4,1,-3,-3,1,1,9,1,-2,-16,0,-4,-17,2,-4,-2,-11,1,1,3,2},
+    {2,-1,-1,-1,-2,-1,-3,2,-1,-15,2,3,5,-1,-5,3,-1,10,6,-4,-8,0,-3,-8,1,0,-3,0,-3,-2,1,0}
+};
+constexpr int16_t NNUE_B1[NNUE_HIDDEN] = {93,86,84,92,68,44,-11,46,69,44,68,84,104,84,35,49,79,78,24,29,35,85,121,35,47,81,82,85,84,53,48,33};
+constexpr int8_t NNUE_W2[NNUE_HIDDEN] = {71,-39,60,70,-51,51,47,59,-67,59,65,60,-40,-64,53,62,-62,67,35,-34,42,65,-47,-69,-64,69,-57,-55,-62,50,-78,50};
+constexpr int32_t NNUE_B2 = -3626;
+// END NNUE WEIGHTS
+
+inline void nnue_add(int16_t* acc, int f) {
+    for (int j = 0; j < NNUE_HIDDEN; j++) acc[j] += NNUE_W1[f][j];
+}
+
+inline void nnue_move(int16_t* acc, int f_from, int f_to) {
+    for (int j = 0; j < NNUE_HIDDEN; j++) acc[j] += NNUE_W1[f_to][j] - NNUE_W1[f_from][j];
+}
+
+// --- BOARD (Bitboard) ---
+class Board {
+public:
+    uint64_t pieces[2]; // [0] = BLACK amazons, [1] = WHITE amazons
+    uint64_t arrows;    // All shot arrows
+    uint64_t hash;      // Zobrist key, kept up to date by move_queen/shoot
+#if EVAL_NNUE
+    int16_t acc[NNUE_HIDDEN]; // NNUE accumulator, kept up to date the same way
+#endif
+    
+    Board() {
+        pieces[0] = pieces[1] = 0;
+        arrows = 0;
+        init_board();
+    }
+    
+    static inline int side(int color) {
+        return color == BLACK ? 0 : 1;
+    }
+    
+    inline uint64_t occupied() const {
+        return pieces[0] | pieces[1] | arrows;
+    }
+    
+    // Equal to its mirror image (byte swap = row flip)
+    inline bool symmetric() const {
+        return mirror_hash(hash) == hash && __builtin_bswap64(pieces[0]) == pieces[0] &&
+               __builtin_bswap64(pieces[1]) == pieces[1] && __builtin_bswap64(arrows) == arrows;
+    }
+    
+    void init_board() {
+        // row * 8 + col
+        pieces[0] = (1ULL << (0*8 + 2)) | (1ULL << (2*8 + 0)) | (1ULL << (5*8 + 0)) | (1ULL << (7*8 + 2));
+        pieces[1] = (1ULL << (0*8 + 5)) | (1ULL << (2*8 + 7)) | (1ULL << (5*8 + 7)) | (1ULL << (7*8 + 5));
+        hash = compute_hash();
+#if EVAL_NNUE
+        refresh_accumulator();
+#endif
+    }
+    
+#if EVAL_NNUE
+    // Full recomputation; only for setting up a position
+    void refresh_accumulator() {
+        memcpy(acc, NNUE_B1, sizeof(acc));
+        for (int s = 0; s < 2; s++)
+            for (uint64_t b = pieces[s]; b; b &= b - 1) nnue_add(acc, s * NUM_SQUARES + __builtin_ctzll(b));
+        for (uint64_t b = arrows; b; b &= b - 1) nnue_add(acc, NNUE_ARROW + __builtin_ctzll(b));
+    }
+#endif
+    
+    // Full rehash; only for setting up a position
+    uint64_t compute_hash() const {
+        uint64_t h = 0;
+        for (int s = 0; s < 2; s++)
+            for (uint64_t b = pieces[s]; b; b &= b - 1) h ^= ZOBRIST_PIECE[s][__builtin_ctzll(b)];
+        for (uint64_t b = arrows; b; b &= b - 1) h ^= ZOBRIST_ARROW[__builtin_ctzll(b)];
+        return h;
+    }
+    
+    inline void move_queen(int from, int to) {
+        uint64_t from_bit = 1ULL << from;
+        int s = (pieces[0] & from_bit) ? 0 : 1;
+        pieces[s] ^= from_bit | (1ULL << to);
+        hash ^= ZOBRIST_PIECE[s][from] ^ ZOBRIST_PIECE[s][to];
+#if EVAL_NNUE
+        nnue_move(acc, s * NUM_SQUARES + from, s * NUM_SQUARES + to);
+#endif
+    }
+    
+    inline void shoot(int sq) {
+        arrows |= 1ULL << sq;
+        hash ^= ZOBRIST_ARROW[sq];
+#if EVAL_NNUE
+        nnue_add(acc, NNUE_ARROW + sq);
+#endif
+    }
+    
+    void apply_move(const Move& m) {
+        move_queen(m.from, m.to);
+        shoot(m.arrow);
+    }
+};
+
+// Pick a uniformly random set bit of a non-empty bitboard
+inline int random_bit(uint64_t b) {
+    for (int k = fast_rand() % popcount(b); k > 0; k--) b = clear_lsb(b);
+    return lsb_index(b);
+}
+
+// --- MOVE ORDERING ---
+// Static prior of a move, generalized from bot002's score_move: a central
+// destination, an arrow close to an opponent amazon, and an arrow or amazon
+// landing on a square the opponent could move to.
+const int CENTRALITY[NUM_SQUARES] = {
+    0, 1, 2, 3, 3, 2, 1, 0,
+    1, 2, 3, 4, 4, 3, 2, 1,
+    2, 3, 4, 5, 5, 4, 3, 2,
+    3, 4, 5, 6, 6, 5, 4, 3,
+    3, 4, 5, 6, 6, 5, 4, 3,
+    2, 3, 4, 5, 5, 4, 3, 2,
+    1, 2, 3, 4, 4, 3, 2, 1,
+    0, 1, 2, 3, 3, 2, 1, 0
+};
+
+// King distance between two squares
+inline int square_distance(int a, int b) {
+    return SQUARE_DISTANCE[a][b];
+}
+
+// Union of the queen moves of every amazon in `pieces`
+inline uint64_t queen_reach(uint64_t pieces, uint64_t occ) {
+    uint64_t reach = 0;
+    for (uint64_t p = pieces; p; p = clear_lsb(p)) reach |= queen_attacks(lsb_index(p), occ);
+    return reach;
+}
+
+// opp_reach = queen_reach of the opponent before the move
+inline int score_move(const Move& m, uint64_t opp_pieces, uint64_t opp_reach) {
+    int score = CENTRALITY[m.to];
+    int min_dist = 99;
+    for (uint64_t p = opp_pieces; p; p = clear_lsb(p)) min_dist = min(min_dist, square_distance(m.arrow, lsb_index(p)));
+    if (min_dist <= 6) score += 6 - min_dist;
+    score += 2 * (int)(opp_reach >> m.arrow & 1) + (int)(opp_reach >> m.to & 1);
+    return score;
+}
+
+// score_move split into a destination part and an arrow part, so the arrows of
+// a queen step can be scored at once: arrow_level[v] holds the squares whose
+// arrow part is v. dest_score(to) + arrow part == score_move.
+struct MovePrior {
+    uint64_t opp_reach;
+    uint64_t arrow_level[8];
+    
+    void init(const Board& board, int side) {
+        uint64_t opp = board.pieces[side ^ 1];
+        opp_reach = queen_reach(opp, board.occupied());
+        memset(arrow_level, 0, sizeof(arrow_level));
+        uint64_t within = opp; // Squares at most d king steps from an opponent amazon
+        for (int d = 1; d <= 6; d++) {
+            uint64_t grown = king_step(within);
+            uint64_t ring = grown & ~within;
+            arrow_level[6 - d + 2] |= ring & opp_reach;
+            arrow_level[6 - d] |= ring & ~opp_reach;
+            within = grown;
+        }
+        arrow_level[2] |= ~within & opp_reach;
+        arrow_level[0] |= ~within & ~opp_reach;
+    }
+    
+    inline int dest_score(int to) const {
+        return CENTRALITY[to] + (int)(opp_reach >> to & 1);
+    }
+    
+    // Best arrow of a non-empty shot set (lowest square on ties); value gets its part
+    inline int best_arrow(uint64_t shots, int& value) const {
+        for (int v = 7; v > 0; v--) {
+            if (shots & arrow_level[v]) {
+                value = v;
+                return lsb_index(shots & arrow_level[v]);
+            }
+        }
+        value = 0;
+        return lsb_index(shots);
+    }
+};
+
+// Every legal move of color; out must hold MAX_MOVES
+const int MAX_MOVES = 4 * 27 * 27;
+
+int generate_moves(const Board& board, int color, Move* out) {
+    uint64_t occ = board.occupied();
+    int n = 0;
+    for (uint64_t p = board.pieces[Board::side(color)]; p; p = clear_lsb(p)) {
+        int from = lsb_index(p);
+        for (uint64_t d = queen_attacks(from, occ); d; d = clear_lsb(d)) {
+            int to = lsb_index(d);
+            uint64_t after = (occ ^ (1ULL << from)) | (1ULL << to);
+            for (uint64_t s = queen_attacks(to, after); s; s = clear_lsb(s)) out[n++] = Move(from, to, lsb_index(s));
+        }
+    }
+    return n;
+}
+
+// --- LAZY MOVE ENUMERATION ---
+// Untried moves of a node, generated on demand from the node's board.
+// Amazons and destinations are drawn in random order, and every arrow of a
+// (from, to) pair is yielded before moving on. Kinds of cursor:
+//   CURSOR_FULL  - complete (from, to, arrow) moves
+//   CURSOR_QUEEN - queen steps only (arrow = NO_SQUARE), two-level tree
+//   CURSOR_ARROW - arrows of one queen step already applied to the board
+//   CURSOR_PRIOR - progressive widening: the best-scored arrow of every queen
+//                  step, queen steps in descending MovePrior order. Nothing is
+//                  stored; each draw rescans for the best step below the last one.
+//   CURSOR_REST  - after CURSOR_PRIOR: every other arrow, in CURSOR_FULL order
+//   CURSOR_LIST  - the root's moves kept by the prefilter, from root_list
+// Invariant: (dests | shots) != 0 whenever an untried move is left.
+enum CursorKind { CURSOR_FULL, CURSOR_QUEEN, CURSOR_ARROW, CURSOR_PRIOR, CURSOR_REST, CURSOR_LIST };
+
+static thread_local Move root_list[MAX_MOVES]; // Of this thread's root, see prefilter_root
+
+struct MoveCursor {
+    uint64_t pieces; // Amazons whose destinations are not started yet
+    uint64_t dests;  // Untried destinations of `from`
+    uint64_t shots;  // Untried arrows for (from, to)
+    uint8_t from, to;
+    uint8_t kind;
+    
+    void init(const Board& board, int color) {
+        kind = CURSOR_FULL;
+        pieces = board.pieces[Board::side(color)];
+        dests = 0;
+        shots = 0;
+        refill(board);
+    }
+    
+    void init_queen(const Board& board, int color) {
+        kind = CURSOR_QUEEN;
+        pieces = board.pieces[Board::side(color)];
+        dests = 0;
+        shots = 0;
+        next_piece(board.occupied());
+    }
+    
+    // `board` already has the amazon on `to_sq`
+    void init_arrow(const Board& board, int from_sq, int to_sq) {
+        kind = CURSOR_ARROW;
+        pieces = dests = 0;
+        from = (uint8_t)from_sq;
+        to = (uint8_t)to_sq;
+        shots = queen_attacks(to_sq, board.occupied());
+    }
+    
+    void init_prior(const Board& board, int color) {
+        kind = CURSOR_PRIOR;
+        pieces = 0; // Key of the last queen step drawn + 1, 0 before the first
+        dests = 0;
+        from = (uint8_t)Board::side(color);
+        // shots only flags that a move is left until the prior order runs out
+        shots = (king_step(board.pieces[from]) & ~board.occupied()) ? ~0ULL : 0;
+    }
+    
+    // The first count moves of root_list, in order
+    void init_list(int count) {
+        kind = CURSOR_LIST;
+        pieces = 0; // Next index
+        dests = 0;
+        shots = (uint64_t)count; // Moves left
+    }
+    
+    // A CURSOR_PRIOR cursor of a position with moves left, from its saved key (pieces)
+    void resume_prior(int color, uint64_t key) {
+        kind = CURSOR_PRIOR;
+        pieces = key;
+        dests = 0;
+        from = (uint8_t)Board::side(color);
+        shots = ~0ULL;
+    }
+    
+    inline bool has_next() const {
+        return (dests | shots) != 0;
+    }
+    
+    // Precondition: has_next(). `board` must be the position this cursor was created for.
+    Move next(const Board& board) {
+        if (kind == CURSOR_PRIOR) return next_prior(board);
+        if (kind == CURSOR_LIST) {
+            shots--;
+            return root_list[pieces++];
+        }
+        if (kind == CURSOR_QUEEN) {
+            int t = random_bit(dests);
+            dests ^= 1ULL << t;
+            Move m(from, t, NO_SQUARE);
+            if (!dests) next_piece(board.occupied());
+            return m;
+        }
+        int a = random_bit(shots);
+        shots ^= 1ULL << a;
+        Move m(from, to, a);
+        if (!shots && kind != CURSOR_ARROW) refill(board);
+        return m;
+    }
+    
+private:
+    // Keys order queen steps by prior, then by (from, to)
+    Move next_prior(const Board& board) {
+        int side = from;
+        MovePrior prior;
+        prior.init(board, side);
+        uint64_t occ = board.occupied();
+        int last = (int)pieces - 1;
+        int best = -1, second = -1;
+        Move m;
+        for (uint64_t p = board.pieces[side]; p; p = clear_lsb(p)) {
+            int f = lsb_index(p);
+            for (uint64_t d = queen_attacks(f, occ); d; d = clear_lsb(d)) {
+                int t = lsb_index(d);
+                int v;
+                int a = prior.best_arrow(queen_attacks(t, (occ ^ (1ULL << f)) | (1ULL << t)), v);
+                int key = (prior.dest_score(t) + v) << 12 | f << 6 | t;
+                if (last >= 0 && key >= last) continue;
+                if (key > best) {
+                    second = best;
+                    best = key;
+                    m = Move(f, t, a);
+                } else if (key > second) {
+                    second = key;
+                }
+            }
+        }
+        pieces = (uint64_t)(best + 1);
+        if (second < 0) { // Every queen step has had its best arrow
+            kind = CURSOR_REST;
+            pieces = board.pieces[side];
+            dests = 0;
+            shots = 0;
+            refill(board);
+        }
+        return m;
+    }
+    
+
+    void next_piece(uint64_t occ) {
+        while (!dests && pieces) {
+            from = (uint8_t)random_bit(pieces);
+            pieces ^= 1ULL << from;
+            dests = queen_attacks(from, occ);
+        }
+    }
+    
+    void refill(const Board& board) {
+        uint64_t occ = board.occupied();
+        for (;;) {
+            next_piece(occ);
+            if (!dests) return;
+            to = (uint8_t)random_bit(dests);
+            dests ^= 1ULL << to;
+            // A queen that can move can always shoot back at its vacated square
+            shots = queen_attacks(to, (occ ^ (1ULL << from)) | (1ULL << to));
+            if (kind == CURSOR_FULL) return;
+            // CURSOR_REST: the best arrow of the step was drawn by CURSOR_PRIOR
+            MovePrior prior;
+            prior.init(board, (board.pieces[0] >> from & 1) ? 0 : 1);
+            int v;
+            shots ^= 1ULL << prior.best_arrow(shots, v);
+            if (shots) return;
+        }
+    }
+};
+
+// --- OPTIMIZED NODE (NO STL) ---
+// Cold half of a node in 16 bytes; wins/visits live in node_wins/node_visits.
+// There is no parent index: search() records the descent path instead. The
+// untried moves of a node are a MoveCursor in a per-thread side pool, taken at
+// the node's first expansion and given back when it runs dry, so the leaves
+// that make up most of the tree carry none. The progressive-widening cursor
+// needs nothing but the key of its last draw, which is kept in the node itself.
+const uint8_t NODE_HALF = 1;        // Queen step without its arrow; children are that player's shots
+const uint8_t NODE_ARROW = 2;       // Arrow shot of the parent's queen step
+const uint8_t NODE_BLACK_MOVED = 4; // player_just_moved is BLACK
+const uint8_t NODE_DRY = 8;         // No untried move left
+const uint8_t NODE_STARTED = 16;    // cursor is set up
+const uint8_t NODE_POOLED = 32;     // cursor indexes cursor_pool, else it is a CURSOR_PRIOR key
+const uint8_t NODE_SYMMETRIC = 64;  // Position equals its mirror image: only moves from rows 0-3 are expanded
+const uint8_t NODE_PRUNED = 128;    // Root moves cut by the prefilter: dry does not mean every move was tried
+
+// MCTSNode::proof, for player_just_moved (see MCTS SOLVER)
+const uint8_t PROOF_NONE = 0, PROOF_WIN = 1, PROOF_LOSS = 2;
+
+struct MCTSNode {
+    int first_child;      // Start of the child block, NO_NODE before the first expansion; free-list link in a free block
+    uint32_t cursor;      // Untried moves, see NODE_STARTED / NODE_POOLED
+    uint16_t child_count;
+    uint8_t child_class;  // Block holds 1 << child_class slots, NO_BLOCK if none
+    uint8_t flags;
+    Move move; // The move that got us here
+    uint8_t proof;
+    
+    void init(Move m, int pjm, uint8_t kind) {
+        first_child = NO_NODE;
+        child_count = 0;
+        child_class = NO_BLOCK;
+        flags = (uint8_t)(kind | (pjm == BLACK ? NODE_BLACK_MOVED : 0));
+        move = m;
+        proof = PROOF_NONE;
+    }
+    
+    inline bool half_move() const { return flags & NODE_HALF; }
+    inline int player_just_moved() const { return (flags & NODE_BLACK_MOVED) ? BLACK : WHITE; }
+    inline bool has_untried() const { return !(flags & NODE_DRY); }
+};
+static_assert(sizeof(MCTSNode) == 16, "MCTSNode must stay 16 bytes");
+
+// The arena is never bounds-checked: the RSS limits must end a search first
+static_assert((long long)MAX_NODES * (sizeof(MCTSNode) + 8) > (long long)RSS_HARD_LIMIT_MB << 20,
+              "MAX_NODES must outlast the RSS hard limit");
+
+// --- CURSOR POOL ---
+// Per thread; freed cursors are chained through MoveCursor::pieces. search()
+// stops before the pool can run out (cursors_left()).
+const uint32_t MAX_CURSORS = 1 << 22; // 4M x 32 bytes of address space, resident only as used
+const uint32_t NO_CURSOR = 0xFFFFFFFF;
+thread_local MoveCursor* cursor_pool = nullptr;
+thread_local uint32_t cursor_top = 0;
+thread_local uint32_t cursor_free = NO_CURSOR;
+thread_local uint32_t cursor_free_count = 0;
+
+inline uint32_t alloc_cursor() {
+    if (cursor_free == NO_CURSOR) return cursor_top++;
+    uint32_t c = cursor_free;
+    cursor_free = (uint32_t)cursor_pool[c].pieces;
+    cursor_free_count--;
+    return c;
+}
+
+inline void release_cursor(MCTSNode& n) {
+    if (!(n.flags & NODE_POOLED)) return;
+    cursor_pool[n.cursor].pieces = cursor_free;
+    cursor_free = n.cursor;
+    cursor_free_count++;
+    n.flags &= ~NODE_POOLED;
+}
+
+inline uint32_t cursors_left() {
+    return MAX_CURSORS - cursor_top + cursor_free_count;
+}
+
+inline void reset_stats(int n) {
+    node_wins[n] = 0.0f;
+    node_visits[n] = 0;
+}
+
+// --- CPU DISPATCH ---
+// Kernel sets, in the order they are preferred. Each SIMD kernel carries its own
+// target attribute, so the file itself still compiles for baseline x86-64.
+enum CpuLevel { CPU_SCALAR = 0, CPU_POPCNT = 1, CPU_AVX2 = 2 };
+int cpu_level = CPU_SCALAR;
+
+// Best level both compiled in and supported here; BOT_CPU_LEVEL=n in the
+// environment caps it (to exercise the fallbacks on a fast machine).
+int detect_cpu_level() {
+    int level = CPU_SCALAR;
+#if SIMD_LEVEL > 0
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("popcnt") && __builtin_cpu_supports("sse4.2")) level = CPU_POPCNT;
+#if SIMD_LEVEL > 1
+    if (level == CPU_POPCNT && __builtin_cpu_supports("avx2")) level = CPU_AVX2;
+#endif
+#endif
+    const char* cap = getenv("BOT_CPU_LEVEL");
+    if (cap && *cap >= '0' && *cap <= '9') level = min(level, atoi(cap));
+    return level;
+}
+
+// --- UCB KERNEL ---
+// score = w/v + C*sqrt(log(N+1)/v) is evaluated as r*(w*r + C*sqrt(log(N+1)))
+// with r = rsqrt(v): one table lookup per parent, one rsqrt per child.
+
+const int SQRT_LOG_SIZE = 1 << 16;
+const int UCB_PAD = 8; // Stat arrays are over-allocated so a kernel may read a full vector past a block
+float SQRT_LOG[SQRT_LOG_SIZE]; // SQRT_LOG[n] = sqrt(log(n + 1))
+
+void init_ucb_tables() {
+    for (int n = 0; n < SQRT_LOG_SIZE; n++) SQRT_LOG[n] = std::sqrt(std::log((float)n + 1.0f));
+}
+
+inline float sqrt_log(int n) {
+    return n < SQRT_LOG_SIZE ? SQRT_LOG[n] : std::sqrt(std::log((float)n + 1.0f));
+}
+
+// Exploration constant of a turn: base * exp(-decay * (turn - shift)), tunable
+float ucb_c_base = 0.177f, ucb_c_decay = 0.008f, ucb_c_shift = 1.41f;
+
+inline float exploration(int turn) {
+    return ucb_c_base * std::exp(-ucb_c_decay * (turn - ucb_c_shift));
+}
+
+int ucb_argmax_scalar(const float* w, const int* v, int count, float c_sqrt_log) {
+    int best = 0;
+    float best_score = -1e9f;
+    for (int i = 0; i < count; i++) {
+        float r = 1.0f / std::sqrt((float)v[i]);
+        float score = r * (w[i] * r + c_sqrt_log);
+        if (score > best_score) {
+            best_score = score;
+            best = i;
+        }
+    }
+    return best;
+}
+
+#if SIMD_LEVEL > 0
+
+// rsqrt estimate refined by one Newton step (~23 bits, vs 12 for the raw estimate)
+inline __m128 rsqrt_nr_sse(__m128 x) {
+    __m128 y = _mm_rsqrt_ps(x);
+    __m128 yy = _mm_mul_ps(y, y);
+    return _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), y),
+                      _mm_sub_ps(_mm_set1_ps(3.0f), _mm_mul_ps(x, yy)));
+}
+
+int ucb_argmax_sse(const float* w, const int* v, int count, float c_sqrt_log) {
+    const __m128 csl = _mm_set1_ps(c_sqrt_log);
+    const __m128i step = _mm_set1_epi32(4);
+    __m128i idx = _mm_setr_epi32(0, 1, 2, 3);
+    __m128i best_idx = idx;
+    __m128 best = _mm_set1_ps(-1e9f);
+    const __m128i n = _mm_set1_epi32(count);
+    for (int i = 0; i < count; i += 4) {
+        __m128 vf = _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)(v + i)));
+        __m128 r = rsqrt_nr_sse(vf);
+        __m128 score = _mm_mul_ps(r, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(w + i), r), csl));
+        // Lanes past count (pad or a neighbouring block) never win
+        __m128 gt = _mm_and_ps(_mm_cmpgt_ps(score, best), _mm_castsi128_ps(_mm_cmplt_epi32(idx, n)));
+        best = _mm_or_ps(_mm_and_ps(gt, score), _mm_andnot_ps(gt, best));
+        best_idx = _mm_castps_si128(_mm_or_ps(_mm_and_ps(gt, _mm_castsi128_ps(idx)),
+                                              _mm_andnot_ps(gt, _mm_castsi128_ps(best_idx))));
+        idx = _mm_add_epi32(idx, step);
+    }
+    float s[4];
+    int bi[4];
+    _mm_storeu_ps(s, best);
+    _mm_storeu_si128((__m128i*)bi, best_idx);
+    int b = 0;
+    for (int k = 1; k < 4; k++)
+        if (s[k] > s[b] || (s[k] == s[b] && bi[k] < bi[b])) b = k;
+    return bi[b];
+}
+
+#if SIMD_LEVEL > 1
+__attribute__((target("avx2")))
+int ucb_argmax_avx2(const float* w, const int* v, int count, float c_sqrt_log) {
+    const __m256 csl = _mm256_set1_ps(c_sqrt_log);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 three = _mm256_set1_ps(3.0f);
+    const __m256i step = _mm256_set1_epi32(8);
+    const __m256i n = _mm256_set1_epi32(count);
+    __m256i idx = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i best_idx = idx;
+    __m256 best = _mm256_set1_ps(-1e9f);
+    for (int i = 0; i < count; i += 8) {
+        __m256 vf = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(v + i)));
+        __m256 y = _mm256_rsqrt_ps(vf);
+        __m256 r = _mm256_mul_ps(_mm256_mul_ps(half, y),
+                                 _mm256_sub_ps(three, _mm256_mul_ps(vf, _mm256_mul_ps(y, y))));
+        __m256 score = _mm256_mul_ps(r, _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(w + i), r), csl));
+        __m256 gt = _mm256_and_ps(_mm256_cmp_ps(score, best, _CMP_GT_OQ),
+                                  _mm256_castsi256_ps(_mm256_cmpgt_epi32(n, idx)));
+        best = _mm256_blendv_ps(best, score, gt);
+        best_idx = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(best_idx),
+                                                        _mm256_castsi256_ps(idx), gt));
+        idx = _mm256_add_epi32(idx, step);
+    }
+    float s[8];
+    int bi[8];
+    _mm256_storeu_ps(s, best);
+    _mm256_storeu_si256((__m256i*)bi, best_idx);
+    int b = 0;
+    for (int k = 1; k < 8; k++)
+        if (s[k] > s[b] || (s[k] == s[b] && bi[k] < bi[b])) b = k;
+    return bi[b];
+}
+#endif
+#endif
+
+int (*ucb_argmax)(const float* w, const int* v, int count, float c_sqrt_log) = ucb_argmax_scalar;
+
+// Get best child using UCB over the packed statistics of one block
+int uct_select_child(int n, float C) {
+    const MCTSNode& node = node_pool[n];
+    const float* w = node_wins + node.first_child;
+    const int* v = node_visits + node.first_child;
+    float c_sqrt_log = C * sqrt_log(node_visits[n]);
+    return node.first_child + ucb_argmax(w, v, node.child_count, c_sqrt_log);
+}
+
+// --- PROGRESSIVE WIDENING ---
+// A node with N visits may hold PW_K * N^PW_ALPHA children; until it may have
+// another, selection goes on among the ones it has. Full-move nodes draw their
+// untried moves best prior first (CURSOR_PRIOR), so the few children a node
+// gets are the promising ones and the tree grows deeper instead of wider.
+#ifndef PROGRESSIVE_WIDENING
+#define PROGRESSIVE_WIDENING 1
+#endif
+
+const double PW_K = 2.0;
+const double PW_ALPHA = 0.5;
+const int MAX_CHILDREN = 1 << (NUM_BLOCK_CLASSES - 1);
+int pw_threshold[MAX_CHILDREN + 1]; // Visits a node needs before child c + 1 is added
+
+void init_widening() {
+    for (int c = 0; c <= MAX_CHILDREN; c++) {
+        double v = ceil(pow((c + 1) / PW_K, 1.0 / PW_ALPHA));
+        pw_threshold[c] = v < 2e9 ? (int)v : 2000000000;
+    }
+}
+
+inline bool can_widen(int n) {
+    return !PROGRESSIVE_WIDENING || node_visits[n] >= pw_threshold[node_pool[n].child_count];
+}
+
+// --- BLOCK ALLOCATOR ---
+inline void free_block(int start, int cls) {
+    node_pool[start].first_child = free_blocks[cls];
+    free_blocks[cls] = start;
+    free_count += 1 << cls;
+}
+
+// Drop this thread's whole tree: every chunk it owns becomes one free block
+void reset_pool() {
+    for (int k = 0; k < NUM_BLOCK_CLASSES; k++) free_blocks[k] = NO_NODE;
+    free_count = 0;
+    gc_top = 0;
+    cursor_top = 0;
+    cursor_free = NO_CURSOR;
+    cursor_free_count = 0;
+    chunk_next = chunk_end = 0;
+    for (int c : owned_chunks) free_block(c, NUM_BLOCK_CLASSES - 1);
+}
+
+// Fresh slots from the current chunk. When it cannot hold the block, its tail
+// goes to the free lists and a new chunk is reserved from the shared arena.
+int carve_block(int cls) {
+    int size = 1 << cls;
+    if (chunk_end - chunk_next < size) {
+        for (int k = NUM_BLOCK_CLASSES - 1; k >= 0; k--) {
+            if ((chunk_end - chunk_next) & (1 << k)) {
+                free_block(chunk_next, k);
+                chunk_next += 1 << k;
+            }
+        }
+        chunk_next = arena_top.fetch_add(ARENA_CHUNK, memory_order_relaxed);
+        chunk_end = chunk_next + ARENA_CHUNK;
+        owned_chunks.push_back(chunk_next);
+        arena_usage[thread_id].fetch_add(ARENA_CHUNK, memory_order_relaxed);
+    }
+    int start = chunk_next;
+    chunk_next += size;
+    return start;
+}
+
+// Smallest free block that fits (split down to size), else fresh arena memory
+int alloc_block(int cls) {
+    int k = cls;
+    while (k < NUM_BLOCK_CLASSES && free_blocks[k] == NO_NODE) k++;
+    if (k == NUM_BLOCK_CLASSES) return carve_block(cls);
+    int start = free_blocks[k];
+    free_blocks[k] = node_pool[start].first_child;
+    free_count -= 1 << k;
+    while (k > cls) {
+        k--;
+        free_block(start + (1 << k), k);
+    }
+    return start;
+}
+
+// Copy node `src` into slot `dst`; its children and cursor go with it
+void move_node(int src, int dst) {
+    node_pool[dst] = node_pool[src];
+    node_wins[dst] = node_wins[src];
+    node_visits[dst] = node_visits[src];
+}
+
+// Append a child slot to node n, doubling its block when full
+int add_child(int n) {
+    MCTSNode& node = node_pool[n];
+    if (node.child_class == NO_BLOCK || node.child_count == (1 << node.child_class)) {
+        int cls = node.child_class == NO_BLOCK ? 0 : node.child_class + 1;
+        int block = alloc_block(cls);
+        MCTSNode& grown = node_pool[n];
+        for (int i = 0; i < grown.child_count; i++) move_node(grown.first_child + i, block + i);
+        if (grown.child_class != NO_BLOCK) free_block(grown.first_child, grown.child_class);
+        grown.first_child = block;
+        grown.child_class = (uint8_t)cls;
+    }
+    MCTSNode& parent = node_pool[n];
+    return parent.first_child + parent.child_count++;
+}
+
+// Allocator wrapper: a root gets its own one-slot block
+int new_node(int parent, Move m, int pjm, bool half = false) {
+    int n = parent == NO_NODE ? alloc_block(0) : add_child(parent);
+    uint8_t kind = half ? NODE_HALF : (parent != NO_NODE && node_pool[parent].half_move()) ? NODE_ARROW : 0;
+    node_pool[n].init(m, pjm, kind);
+    reset_stats(n);
+    return n;
+}
+
+// Replay the edge leading into `node`. The side to move only changes once the
+// arrow is down, so a half-move node leaves current_player untouched.
+inline void apply_edge(Board& state, int n, int& current_player) {
+    const MCTSNode& node = node_pool[n];
+    if (node.half_move()) {
+        state.move_queen(node.move.from, node.move.to);
+        return;
+    }
+    if (node.flags & NODE_ARROW) state.shoot(node.move.arrow);
+    else state.apply_move(node.move);
+    current_player = -current_player;
+}
+
+// Mark a new node whose position is `state` dry if it has no move at all. A
+// queen can move (and then shoot back) iff a neighbouring square is empty; a
+// half move always has its arrows. The cursor waits for the first expansion.
+inline void init_untried(int n, const Board& state, int to_move) {
+    MCTSNode& node = node_pool[n];
+    if (node.half_move()) return;
+    if (!(king_step(state.pieces[Board::side(to_move)]) & ~state.occupied())) node.flags |= NODE_DRY;
+    else if (state.symmetric()) node.flags |= NODE_SYMMETRIC;
+}
+
+// Draw an untried move of node n, whose position is `state`; precondition: has_untried()
+Move next_untried(int n, const Board& state, int to_move) {
+    MCTSNode& node = node_pool[n];
+    const bool inline_prior = PROGRESSIVE_WIDENING && !TWO_LEVEL_TREE && !node.half_move();
+    if (!(node.flags & NODE_STARTED)) {
+        node.flags |= NODE_STARTED;
+        if (inline_prior) {
+            node.cursor = 0;
+        } else {
+            node.cursor = alloc_cursor();
+            node.flags |= NODE_POOLED;
+            MoveCursor& mc = cursor_pool[node.cursor];
+            if (node.half_move()) mc.init_arrow(state, node.move.from, node.move.to);
+            else if (TWO_LEVEL_TREE) mc.init_queen(state, to_move);
+            else mc.init(state, to_move);
+        }
+    }
+    if (node.flags & NODE_POOLED) {
+        MoveCursor& mc = cursor_pool[node.cursor];
+        Move m = mc.next(state);
+        if (!mc.has_next()) {
+            release_cursor(node);
+            node.flags |= NODE_DRY;
+        }
+        return m;
+    }
+    // Inline CURSOR_PRIOR; once the prior order runs out the rest goes to the pool
+    MoveCursor mc;
+    mc.resume_prior(to_move, node.cursor);
+    Move m = mc.next(state);
+    if (mc.kind == CURSOR_PRIOR) {
+        node.cursor = (uint32_t)mc.pieces;
+    } else if (mc.has_next()) {
+        node.cursor = alloc_cursor();
+        node.flags |= NODE_POOLED;
+        cursor_pool[node.cursor] = mc;
+    } else {
+        node.flags |= NODE_DRY;
+    }
+    return m;
+}
+
+// Inline function to estimate current RSS usage.
+// Sum of every thread's reserved slots, so reclaimed nodes are still counted.
+inline size_t estimate_used_memory() {
+    size_t slots = 0;
+    for (int t = 0; t < search_threads; t++) slots += arena_usage[t].load(memory_order_relaxed);
+    return slots * (sizeof(MCTSNode) + sizeof(float) + sizeof(int));
+}
+
+// --- MEMORY BUDGET ---
+// Samples the resident set size from /proc/self/statm (second field, in pages).
+// The descriptor stays open and is re-read with pread, so a sample is a single
+// syscall. Without /proc the pool estimate is used instead.
+struct MemoryBudget {
+    size_t soft_limit;
+    size_t hard_limit;
+    size_t page_size;
+    size_t rss;  // Last sample in bytes
+    int statm_fd;
+    
+    void init(size_t soft_mb, size_t hard_mb) {
+        soft_limit = soft_mb * 1024 * 1024;
+        hard_limit = hard_mb * 1024 * 1024;
+        page_size = (size_t)sysconf(_SC_PAGESIZE);
+        statm_fd = open("/proc/self/statm", O_RDONLY);
+        rss = 0;
+    }
+    
+    size_t sample() {
+        char buf[128];
+        ssize_t n = statm_fd >= 0 ? pread(statm_fd, buf, sizeof(buf) - 1, 0) : -1;
+        if (n <= 0) return rss = estimate_used_memory();
+        buf[n] = 0;
+        char* p = buf;
+        strtoull(p, &p, 10);                        // size
+        rss = strtoull(p, nullptr, 10) * page_size; // resident
+        return rss;
+    }
+};
+
+thread_local MemoryBudget memory; // Per thread, but every thread samples the whole process
+
+// --- TRANSPOSITION TABLE ---
+// The same position is often reached in several move orders (the same arrows
+// shot in another order). Every full-move node on a search path adds its result
+// to an entry keyed by the position hash, and the node's mean is replaced by the
+// entry's when the entry has seen more. A new node whose position is already in
+// the table starts from that mean instead of being evaluated.
+// Buckets of four entries fill one cache line. A store evicts the entry from the
+// oldest search generation and, among those, the one with the fewest visits.
+// Off by default: at 1 s per move the probes cost more iterations than the
+// shared statistics win back (-DTRANSPOSITION_TABLE=1 to enable).
+#ifndef TRANSPOSITION_TABLE
+#define TRANSPOSITION_TABLE 0
+#endif
+
+const int TT_BUCKET_BITS = 18;                    // 256K buckets x 64 bytes = 16 MB per thread
+const int TT_MIN_DEPTH = TWO_LEVEL_TREE ? 4 : 2;  // Plies below the root before transpositions exist
+const int MAX_PATH = 256;                         // Deeper than any game (92 moves, 2 plies each)
+
+struct TTEntry {
+    uint32_t check;   // High half of the hash
+    uint32_t gen;     // Search generation of the last access
+    float wins;       // For the player who just moved into the position
+    int visits;       // 0 = empty
+};
+
+struct TTBucket {
+    TTEntry e[4];
+};
+
+thread_local TTBucket* tt = nullptr;
+thread_local uint32_t tt_gen = 0;
+
+// map_pages with no prefault: the table stays untouched (zero pages) until
+// used, and is page aligned, so buckets sit on cache lines.
+void init_tt() {
+    tt = (TTBucket*)map_pages(((size_t)1 << TT_BUCKET_BITS) * sizeof(TTBucket), 0);
+}
+
+// Entry for `hash`, replacing a victim in its bucket if it is not present
+TTEntry* tt_probe(uint64_t hash) {
+    TTBucket& b = tt[hash & ((1 << TT_BUCKET_BITS) - 1)];
+    uint32_t check = (uint32_t)(hash >> 32);
+    TTEntry* victim = &b.e[0];
+    for (int i = 0; i < 4; i++) {
+        TTEntry& e = b.e[i];
+        if (e.check == check && e.visits) {
+            e.gen = tt_gen;
+            return &e;
+        }
+        if (e.gen < victim->gen || (e.gen == victim->gen && e.visits < victim->visits)) victim = &e;
+    }
+    victim->check = check;
+    victim->gen = tt_gen;
+    victim->wins = 0.0f;
+    victim->visits = 0;
+    return victim;
+}
+
+// Add one result to the position of node n and let the node share its mean
+inline void tt_update(uint64_t hash, int n, float result) {
+    TTEntry* e = tt_probe(hash);
+    e->wins += result;
+    e->visits++;
+    if (e->visits > node_visits[n]) node_wins[n] = e->wins * ((float)node_visits[n] / e->visits);
+}
+
+// --- TREE REUSE ---
+thread_local int tree_root = NO_NODE; // Root kept between turns in long-running mode
+
+// Queue the child block of a discarded node for reclamation
+inline void discard_children(const MCTSNode& n) {
+    if (n.child_class == NO_BLOCK) return;
+    GCBlock b = { n.first_child, n.child_count, n.child_class };
+    gc_stack[gc_top++] = b;
+}
+
+// Reclaim up to `budget` discarded nodes, one child block at a time
+void gc_collect_some(int budget) {
+    while (budget > 0 && gc_top > 0) {
+        GCBlock b = gc_stack[--gc_top];
+        for (int i = 0; i < b.count; i++) {
+            discard_children(node_pool[b.start + i]);
+            release_cursor(node_pool[b.start + i]);
+        }
+        free_block(b.start, b.cls);
+        budget -= 1 << b.cls;
+    }
+}
+
+inline int find_child(int n, int from, int to, int arrow) {
+    const MCTSNode& node = node_pool[n];
+    for (int i = 0; i < node.child_count; i++) {
+        const MCTSNode& c = node_pool[node.first_child + i];
+        if (c.move.from == from && c.move.to == to && (c.half_move() || c.move.arrow == arrow)) return node.first_child + i;
+    }
+    return NO_NODE;
+}
+
+// Follow a played move down the tree. The new root moves into a one-slot block
+// of its own, so the old root and every block off the played line become
+// garbage for gc_collect_some(); if the move was never expanded, the whole
+// pool is free again and is simply reset.
+void advance_root(const Move& m) {
+    if (tree_root == NO_NODE) return;
+    int next = find_child(tree_root, m.from, m.to, m.arrow);
+    if (next != NO_NODE && node_pool[next].half_move()) next = find_child(next, m.from, m.to, m.arrow);
+    if (next == NO_NODE) {
+        tree_root = NO_NODE;
+        reset_pool();
+        return;
+    }
+    
+    int root = alloc_block(0);
+    move_node(next, root);
+    node_pool[next].child_class = NO_BLOCK; // Its children and cursor now belong to the new root
+    node_pool[next].flags &= ~NODE_POOLED;
+    
+    discard_children(node_pool[tree_root]);
+    release_cursor(node_pool[tree_root]);
+    free_block(tree_root, 0);
+    tree_root = root;
+}
+
+// --- EVALUATION HELPERS ---
+// Distances are kept as layers: layers[d] is the bitboard of empty squares first
+// reached after d steps (layers[0] = the four amazons), so every term below is a
+// popcount per layer instead of a loop over squares.
+
+// Squares reached by sliding from any of srcs through empty squares in 8
+// directions, by Kogge-Stone occluded fills. Lane k shifts by FILL_SHIFT[k] up or
+// down; the masks clear the file a shift would wrap into.
+const uint64_t FILL_SHIFT[4] = { 1, 7, 8, 9 };
+const uint64_t FILL_MASK_UP[4]   = { 0xfefefefefefefefeULL, 0x7f7f7f7f7f7f7f7fULL, ~0ULL, 0xfefefefefefefefeULL };
+const uint64_t FILL_MASK_DOWN[4] = { 0x7f7f7f7f7f7f7f7fULL, 0xfefefefefefefefeULL, ~0ULL, 0x7f7f7f7f7f7f7f7fULL };
+
+inline uint64_t queen_fill_scalar(uint64_t srcs, uint64_t empty) {
+    uint64_t reach = 0;
+    for (int k = 0; k < 4; k++) {
+        uint64_t s = FILL_SHIFT[k];
+        uint64_t gen = srcs, pro = empty & FILL_MASK_UP[k];
+        gen |= pro & (gen << s); pro &= pro << s;
+        gen |= pro & (gen << 2 * s); pro &= pro << 2 * s;
+        gen |= pro & (gen << 4 * s);
+        reach |= gen;
+        gen = srcs; pro = empty & FILL_MASK_DOWN[k];
+        gen |= pro & (gen >> s); pro &= pro >> s;
+        gen |= pro & (gen >> 2 * s); pro &= pro >> 2 * s;
+        gen |= pro & (gen >> 4 * s);
+        reach |= gen;
+    }
+    return reach & empty;
+}
+
+#if SIMD_LEVEL > 1
+// Same fill with the four shift amounts side by side in one register per sign
+__attribute__((target("avx2")))
+uint64_t queen_fill_avx2(uint64_t srcs, uint64_t empty) {
+    const __m256i s1 = _mm256_setr_epi64x(1, 7, 8, 9);
+    const __m256i s2 = _mm256_add_epi64(s1, s1);
+    const __m256i s4 = _mm256_add_epi64(s2, s2);
+    const __m256i e = _mm256_set1_epi64x((long long)empty);
+    const __m256i src = _mm256_set1_epi64x((long long)srcs);
+    
+    __m256i pro = _mm256_and_si256(e, _mm256_loadu_si256((const __m256i*)FILL_MASK_UP));
+    __m256i up = _mm256_or_si256(src, _mm256_and_si256(pro, _mm256_sllv_epi64(src, s1)));
+    pro = _mm256_and_si256(pro, _mm256_sllv_epi64(pro, s1));
+    up = _mm256_or_si256(up, _mm256_and_si256(pro, _mm256_sllv_epi64(up, s2)));
+    pro = _mm256_and_si256(pro, _mm256_sllv_epi64(pro, s2));
+    up = _mm256_or_si256(up, _mm256_and_si256(pro, _mm256_sllv_epi64(up, s4)));
+    
+    pro = _mm256_and_si256(e, _mm256_loadu_si256((const __m256i*)FILL_MASK_DOWN));
+    __m256i down = _mm256_or_si256(src, _mm256_and_si256(pro, _mm256_srlv_epi64(src, s1)));
+    pro = _mm256_and_si256(pro, _mm256_srlv_epi64(pro, s1));
+    down = _mm256_or_si256(down, _mm256_and_si256(pro, _mm256_srlv_epi64(down, s2)));
+    pro = _mm256_and_si256(pro, _mm256_srlv_epi64(pro, s2));
+    down = _mm256_or_si256(down, _mm256_and_si256(pro, _mm256_srlv_epi64(down, s4)));
+    
+    __m256i r = _mm256_or_si256(up, down);
+    __m128i r2 = _mm_or_si128(_mm256_castsi256_si128(r), _mm256_extracti128_si256(r, 1));
+    return ((uint64_t)_mm_cvtsi128_si64(r2) | (uint64_t)_mm_extract_epi64(r2, 1)) & empty;
+}
+#endif
+
+template <int LEVEL>
+inline uint64_t queen_fill(uint64_t srcs, uint64_t empty) {
+#if SIMD_LEVEL > 1
+    if (LEVEL >= CPU_AVX2) return queen_fill_avx2(srcs, empty);
+#endif
+    return queen_fill_scalar(srcs, empty);
+}
+
+// Layered BFS from srcs; returns the number of layers (layers[0] = srcs)
+template <bool QUEEN, int LEVEL>
+inline int distance_layers(uint64_t srcs, uint64_t empty, uint64_t* layers) {
+    uint64_t seen = srcs, front = srcs;
+    int n = 0;
+    layers[n++] = srcs;
+    for (;;) {
+        front = (QUEEN ? queen_fill<LEVEL>(front, empty) : king_step(front) & empty) & ~seen;
+        if (!front) return n;
+        seen |= front;
+        layers[n++] = front;
+    }
+}
+
+static thread_local uint64_t layers_my[NUM_SQUARES + 1];
+static thread_local uint64_t layers_op[NUM_SQUARES + 1];
+static thread_local uint64_t qlayers_my[NUM_SQUARES + 1];
+static thread_local uint64_t qlayers_op[NUM_SQUARES + 1];
+
+// Squares strictly closer to me minus squares strictly closer to the opponent
+// (ties count for nobody). If kt is given, it also gets the sum of (4 - d) over
+// those squares with d < 4.
+inline int territory(const uint64_t* my, int n_my, const uint64_t* op, int n_op, int* kt) {
+    uint64_t reach_my = my[0], reach_op = op[0];
+    int t = 0;
+    for (int d = 1; d < n_my || d < n_op; d++) {
+        uint64_t m = d < n_my ? my[d] : 0;
+        uint64_t o = d < n_op ? op[d] : 0;
+        int diff = popcount(m & ~(reach_op | o)) - popcount(o & ~(reach_my | m));
+        reach_my |= m;
+        reach_op |= o;
+        t += diff;
+        if (kt && d < 4) *kt += (4 - d) * diff;
+    }
+    return t;
+}
+
+inline int calc_mobility(uint64_t occ, const int pieces[4]) {
+    int mob = 0;
+    for (int j = 0; j < 4; j++) {
+        mob += popcount(queen_attacks(pieces[j], occ));
+    }
+    return mob;
+}
+
+// Turn-based evaluation weights: qt, kt, qp, kp, mobility (tunable, so not const)
+double WEIGHTS_TABLE[28][5] = {
+    { 0.07747, 0.05755, 0.64627, 0.70431, 0.02438 }, { 0.05093, 0.06276, 0.69898, 0.66192, 0.02362 },
+    { 0.06036, 0.06253, 0.60094, 0.67719, 0.01873 }, { 0.07597, 0.06952, 0.69061, 0.67989, 0.02098 },
+    { 0.08083, 0.08815, 0.58981, 0.54664, 0.02318 }, { 0.09155, 0.08397, 0.56392, 0.54319, 0.02317 },
+    { 0.10653, 0.10479, 0.54840, 0.53023, 0.02084 }, { 0.11534, 0.11515, 0.53325, 0.52423, 0.02237 },
+    { 0.12943, 0.12673, 0.50841, 0.52208, 0.02490 }, { 0.12882, 0.13946, 0.49621, 0.51776, 0.03045 },
+    { 0.13701, 0.15338, 0.47601, 0.51500, 0.03249 }, { 0.14530, 0.15565, 0.45365, 0.50934, 0.03830 },
+    { 0.14521, 0.16388, 0.44531, 0.50517, 0.04864 }, { 0.13750, 0.16326, 0.43619, 0.50328, 0.05912 },
+    { 0.13565, 0.15529, 0.42382, 0.50288, 0.07437 }, { 0.12382, 0.10361, 0.50487, 0.55808, 0.02791 },
+    { 0.11809, 0.14632, 0.40738, 0.41782, 0.10308 }, { 0.10805, 0.15043, 0.40520, 0.43073, 0.10967 },
+    { 0.09668, 0.15666, 0.40215, 0.44165, 0.10906 }, { 0.10585, 0.16319, 0.38220, 0.45465, 0.10062 },
+    { 0.11123, 0.15516, 0.36904, 0.46534, 0.09118 }, { 0.12535, 0.10492, 0.35567, 0.48043, 0.08337 },
+    { 0.28657, 0.16655, 0.38060, 0.42472, 0.10316 }, { 0.07143, 0.16655, 0.36658, 0.39520, 0.02194 },
+    { 0.07143, 0.16655, 0.36658, 0.39520, 0.02194 }, { 0.07143, 0.16655, 0.36658, 0.39520, 0.02194 },
+    { 0.07143, 0.16655, 0.36658, 0.39520, 0.02194 }, { 0.07143, 0.14627, 0.36658, 0.39520, 0.02194 }
+};
+
+inline double fast_sigmoid(double x) {
+    return 0.5 * (x / (1.0 + std::abs(x)) + 1.0);
+}
+
+// EVAL_QUEEN_TERRITORY=1 takes the qt term from queen-move distances (the metric
+// the weights were fitted for); 0 keeps bot032's king-distance qt.
+#ifndef EVAL_QUEEN_TERRITORY
+#define EVAL_QUEEN_TERRITORY 1
+#endif
+
+// Mobility of root_player's amazons minus the opponent's
+inline int mobility_diff(const Board& board, int root_player) {
+    int my_pieces[4], opp_pieces[4];
+    int my_count = 0, opp_count = 0;
+    for (uint64_t b = board.pieces[Board::side(root_player)]; b; b = clear_lsb(b)) my_pieces[my_count++] = lsb_index(b);
+    for (uint64_t b = board.pieces[Board::side(-root_player)]; b; b = clear_lsb(b)) opp_pieces[opp_count++] = lsb_index(b);
+    uint64_t occ = board.occupied();
+    return calc_mobility(occ, my_pieces) - calc_mobility(occ, opp_pieces);
+}
+
+// Weighted score from king-step (k*) and queen-move (q*) distance layers. Layers
+// past a side's last one may be given as zeros; they add nothing.
+inline double score_layers(const uint64_t* km, int n_km, const uint64_t* ko, int n_ko,
+                           const uint64_t* qm, int n_qm, const uint64_t* qo, int n_qo, int mob, int turn) {
+    double scores[5] = {0,0,0,0,0}; // qt, kt, qp, kp, mob
+    static const double POW2[] = { 0, 0.5, 0.25, 0.125, 0.0625, 0.03125, 0.015625, 0.0078125, 0.00390625 };
+    static const double INV[] = { 1.0, 1.0/2, 1.0/3, 1.0/4, 1.0/5, 1.0/6 };
+    
+    int kt = 0;
+    int king_t = territory(km, n_km, ko, n_ko, &kt);
+    scores[1] = kt;
+    for (int d = 1; d < 9 && (d < n_km || d < n_ko); d++) {
+        int diff = (d < n_km ? popcount(km[d]) : 0) - (d < n_ko ? popcount(ko[d]) : 0);
+        scores[2] += diff * POW2[d];
+        if (d < 6) scores[3] += diff * INV[d];
+    }
+    
+#if EVAL_QUEEN_TERRITORY
+    (void)king_t;
+    scores[0] = territory(qm, n_qm, qo, n_qo, nullptr);
+#else
+    (void)qm; (void)n_qm; (void)qo; (void)n_qo;
+    scores[0] = king_t;
+#endif
+    
+    scores[4] = (double)mob;
+    
+    int idx = (turn >= 28) ? 27 : (turn - 1);
+    double total = 0;
+    for(int i=0; i<5; ++i) total += scores[i] * WEIGHTS_TABLE[idx][i];
+    
+    return fast_sigmoid(total * 0.2);
+}
+
+// --- TUNABLE PARAMETERS ---
+// WEIGHTS_TABLE and the exploration schedule as one flat list, for tuning
+// matches (tools/arena --tune): 28 x 5 weights "w<turn>_<term>", then ucb_c_base,
+// ucb_c_decay and ucb_c_shift. The bot itself never changes them.
+const int NUM_TUNABLES = 28 * 5 + 3;
+
+const char* tunable_name(int i) {
+    static const char* const TERMS[5] = { "qt", "kt", "qp", "kp", "mob" };
+    static const char* const UCB[3] = { "ucb_c_base", "ucb_c_decay", "ucb_c_shift" };
+    static char buf[16];
+    if (i >= 28 * 5) return UCB[i - 28 * 5];
+    snprintf(buf, sizeof(buf), "w%02d_%s", i / 5 + 1, TERMS[i % 5]);
+    return buf;
+}
+
+double get_tunable(int i) {
+    if (i < 28 * 5) return WEIGHTS_TABLE[i / 5][i % 5];
+    const float* ucb[3] = { &ucb_c_base, &ucb_c_decay, &ucb_c_shift };
+    return *ucb[i - 28 * 5];
+}
+
+void set_tunable(int i, double v) {
+    if (i < 28 * 5) {
+        WEIGHTS_TABLE[i / 5][i % 5] = v;
+        return;
+    }
+    float* ucb[3] = { &ucb_c_base, &ucb_c_decay, &ucb_c_shift };
+    *ucb[i - 28 * 5] = (float)v;
+}
+
+// --- REGION-CACHED LAYERS ---
+// Arrows never come down, so the arrow walls at the root of a search split the
+// board into regions that no position of that search can join again, and no
+// BFS leaves its region. A region a leaf's path left untouched (same amazons,
+// no new arrows) still has the root's distance layers, so a leaf only runs the
+// BFS in the regions its path changed and copies the rest from the root; a root
+// in one region keeps the full BFS per leaf. The batched AVX2 kernel ignores it.
+// Off by default: the fills run on all regions at once, so a BFS costs one fill
+// per layer whatever its area, and a path of both sides' moves usually dirties
+// the deepest regions; on the bench corpus the merge cost more than the shorter
+// BFS saved (-DREGION_CACHE=1 to enable).
+#ifndef REGION_CACHE
+#define REGION_CACHE 0
+#endif
+
+struct RootLayers {
+    bool active;              // Set by search() for its root, cleared when it ends
+    Board root;
+    int n_regions;
+    uint64_t region[8];       // Regions holding amazons (the others never change)
+    uint64_t king[2][NUM_SQUARES + 1], queen[2][NUM_SQUARES + 1]; // By Board::side
+    int n_king[2], n_queen[2];
+};
+static thread_local RootLayers root_layers;
+
+void init_root_layers(const Board& b) {
+    RootLayers& r = root_layers;
+    r.active = false;
+    if (!REGION_CACHE) return;
+    uint64_t open = ~b.arrows, left = b.pieces[0] | b.pieces[1];
+    r.n_regions = 0;
+    while (left) {
+        uint64_t reg = left & -left, prev;
+        do {
+            prev = reg;
+            reg = (reg | king_step(reg)) & open;
+        } while (reg != prev);
+        r.region[r.n_regions++] = reg;
+        left &= ~reg;
+    }
+    if (r.n_regions < 2) return;
+    r.root = b;
+    uint64_t empty = ~b.occupied();
+    for (int s = 0; s < 2; s++) {
+        r.n_king[s] = distance_layers<false, CPU_SCALAR>(b.pieces[s], empty, r.king[s]);
+        r.n_queen[s] = EVAL_QUEEN_TERRITORY ? distance_layers<true, CPU_SCALAR>(b.pieces[s], empty, r.queen[s]) : 0;
+    }
+    r.active = true;
+}
+
+// Union of the root regions where board differs from the root; ~0 when the
+// cache is off or every region changed
+inline uint64_t changed_regions(const Board& board) {
+    const RootLayers& r = root_layers;
+    if (!r.active) return ~0ULL;
+    uint64_t diff = (board.pieces[0] ^ r.root.pieces[0]) | (board.pieces[1] ^ r.root.pieces[1]) |
+                    (board.arrows ^ r.root.arrows);
+    uint64_t dirty = 0;
+    int clean = 0;
+    for (int i = 0; i < r.n_regions; i++) {
+        if (r.region[i] & diff) dirty |= r.region[i];
+        else clean++;
+    }
+    return clean ? dirty : ~0ULL;
+}
+
+// distance_layers within dirty, the root's layers (n_root of them) elsewhere
+template <bool QUEEN, int LEVEL>
+inline int repaired_layers(uint64_t srcs, uint64_t empty, uint64_t dirty,
+                           const uint64_t* root, int n_root, uint64_t* layers) {
+    int n = distance_layers<QUEEN, LEVEL>(srcs & dirty, empty & dirty, layers);
+    for (; n < n_root; n++) layers[n] = 0;
+    for (int d = 0; d < n_root; d++) layers[d] |= root[d] & ~dirty;
+    return n;
+}
+
+// Built once per kernel set below; inlined helpers pick up each caller's target
+template <int LEVEL>
+inline __attribute__((always_inline))
+double evaluate_impl(const Board& board, int root_player, int turn) {
+    uint64_t empty = ~board.occupied();
+    uint64_t my_bb = board.pieces[Board::side(root_player)];
+    uint64_t op_bb = board.pieces[Board::side(-root_player)];
+    
+    int n_km, n_ko, n_qm = 0, n_qo = 0;
+    uint64_t dirty = REGION_CACHE ? changed_regions(board) : ~0ULL;
+    if (dirty == ~0ULL) {
+        n_km = distance_layers<false, LEVEL>(my_bb, empty, layers_my);
+        n_ko = distance_layers<false, LEVEL>(op_bb, empty, layers_op);
+#if EVAL_QUEEN_TERRITORY
+        n_qm = distance_layers<true, LEVEL>(my_bb, empty, qlayers_my);
+        n_qo = distance_layers<true, LEVEL>(op_bb, empty, qlayers_op);
+#endif
+    } else {
+        const RootLayers& r = root_layers;
+        int sm = Board::side(root_player), so = Board::side(-root_player);
+        n_km = repaired_layers<false, LEVEL>(my_bb, empty, dirty, r.king[sm], r.n_king[sm], layers_my);
+        n_ko = repaired_layers<false, LEVEL>(op_bb, empty, dirty, r.king[so], r.n_king[so], layers_op);
+#if EVAL_QUEEN_TERRITORY
+        n_qm = repaired_layers<true, LEVEL>(my_bb, empty, dirty, r.queen[sm], r.n_queen[sm], qlayers_my);
+        n_qo = repaired_layers<true, LEVEL>(op_bb, empty, dirty, r.queen[so], r.n_queen[so], qlayers_op);
+#endif
+    }
+    return score_layers(layers_my, n_km, layers_op, n_ko, qlayers_my, n_qm, qlayers_op, n_qo,
+                        mobility_diff(board, root_player), turn);
+}
+
+double evaluate_scalar(const Board& board, int root_player, int turn) {
+    return evaluate_impl<CPU_SCALAR>(board, root_player, turn);
+}
+
+#if SIMD_LEVEL > 0
+__attribute__((target("popcnt,sse4.2")))
+double evaluate_popcnt(const Board& board, int root_player, int turn) {
+    return evaluate_impl<CPU_POPCNT>(board, root_player, turn);
+}
+#endif
+
+#if SIMD_LEVEL > 1
+__attribute__((target("avx2,popcnt")))
+double evaluate_avx2(const Board& board, int root_player, int turn) {
+    return evaluate_impl<CPU_AVX2>(board, root_player, turn);
+}
+#endif
+
+#if EVAL_NNUE
+// Network output from the accumulator; turn is implied by the arrow features
+double evaluate_nnue(const Board& board, int root_player, int) {
+    int32_t sum = NNUE_B2;
+    for (int j = 0; j < NNUE_HIDDEN; j++) sum += min(max((int)board.acc[j], 0), NNUE_QA) * NNUE_W2[j];
+    double x = (double)sum / (NNUE_QA * NNUE_QB);
+    return fast_sigmoid(root_player == BLACK ? x : -x);
+}
+#endif
+
+double (*evaluate)(const Board& board, int root_player, int turn) = evaluate_scalar;
+
+// --- BATCHED EVALUATION ---
+// evaluate() over a batch of leaves (LEAF_BATCH in search). The AVX2 kernel runs
+// the distance BFS of four boards at once, one board per 64-bit lane, so the
+// dependent fill steps of different boards overlap; lanes that finish early
+// carry zero layers until the deepest one is done. Scores match evaluate().
+const int EVAL_BATCH_MAX = 32;
+
+void evaluate_batch_single(const Board* const* boards, int n, int root_player, int turn, float* out) {
+    for (int i = 0; i < n; i++) out[i] = (float)evaluate(*boards[i], root_player, turn);
+}
+
+#if SIMD_LEVEL > 1
+__attribute__((target("avx2")))
+inline __m256i king_step_x4(__m256i b) {
+    const __m256i not_col0 = _mm256_set1_epi64x((long long)0xfefefefefefefefeULL);
+    const __m256i not_col7 = _mm256_set1_epi64x((long long)0x7f7f7f7f7f7f7f7fULL);
+    __m256i h = _mm256_or_si256(b, _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi64(b, 1), not_col7),
+                                                   _mm256_and_si256(_mm256_slli_epi64(b, 1), not_col0)));
+    return _mm256_or_si256(h, _mm256_or_si256(_mm256_slli_epi64(h, 8), _mm256_srli_epi64(h, 8)));
+}
+
+// queen_fill_scalar with one board per lane
+__attribute__((target("avx2")))
+inline __m256i queen_fill_x4(__m256i srcs, __m256i empty) {
+    __m256i reach = _mm256_setzero_si256();
+    for (int k = 0; k < 4; k++) {
+        __m128i s1 = _mm_cvtsi32_si128((int)FILL_SHIFT[k]);
+        __m128i s2 = _mm_cvtsi32_si128(2 * (int)FILL_SHIFT[k]);
+        __m128i s4 = _mm_cvtsi32_si128(4 * (int)FILL_SHIFT[k]);
+        __m256i pro = _mm256_and_si256(empty, _mm256_set1_epi64x((long long)FILL_MASK_UP[k]));
+        __m256i gen = _mm256_or_si256(srcs, _mm256_and_si256(pro, _mm256_sll_epi64(srcs, s1)));
+        pro = _mm256_and_si256(pro, _mm256_sll_epi64(pro, s1));
+        gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_sll_epi64(gen, s2)));
+        pro = _mm256_and_si256(pro, _mm256_sll_epi64(pro, s2));
+        gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_sll_epi64(gen, s4)));
+        reach = _mm256_or_si256(reach, gen);
+        pro = _mm256_and_si256(empty, _mm256_set1_epi64x((long long)FILL_MASK_DOWN[k]));
+        gen = _mm256_or_si256(srcs, _mm256_and_si256(pro, _mm256_srl_epi64(srcs, s1)));
+        pro = _mm256_and_si256(pro, _mm256_srl_epi64(pro, s1));
+        gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_srl_epi64(gen, s2)));
+        pro = _mm256_and_si256(pro, _mm256_srl_epi64(pro, s2));
+        gen = _mm256_or_si256(gen, _mm256_and_si256(pro, _mm256_srl_epi64(gen, s4)));
+        reach = _mm256_or_si256(reach, gen);
+    }
+    return _mm256_and_si256(reach, empty);
+}
+
+// distance_layers for four boards; layers[lane][d], returns the deepest lane's count
+template <bool QUEEN>
+__attribute__((target("avx2")))
+inline int distance_layers_x4(__m256i srcs, __m256i empty, uint64_t (*layers)[NUM_SQUARES + 1]) {
+    alignas(32) uint64_t lane[4];
+    __m256i seen = srcs, front = srcs;
+    int n = 0;
+    for (;;) {
+        _mm256_store_si256((__m256i*)lane, front);
+        for (int k = 0; k < 4; k++) layers[k][n] = lane[k];
+        n++;
+        front = _mm256_andnot_si256(seen, QUEEN ? queen_fill_x4(front, empty)
+                                                : _mm256_and_si256(king_step_x4(front), empty));
+        if (_mm256_testz_si256(front, front)) return n;
+        seen = _mm256_or_si256(seen, front);
+    }
+}
+
+static thread_local uint64_t batch_layers[4][4][NUM_SQUARES + 1]; // [king my, king op, queen my, queen op][lane]
+
+__attribute__((target("avx2,popcnt")))
+void evaluate_batch_avx2(const Board* const* boards, int n, int root_player, int turn, float* out) {
+    int me = Board::side(root_player);
+    for (int g = 0; g < n; g += 4) {
+        alignas(32) uint64_t my[4], op[4], empty[4];
+        for (int k = 0; k < 4; k++) {
+            const Board& b = *boards[g + k < n ? g + k : g]; // Short last group: repeat its first board
+            my[k] = b.pieces[me];
+            op[k] = b.pieces[me ^ 1];
+            empty[k] = ~b.occupied();
+        }
+        __m256i e = _mm256_load_si256((const __m256i*)empty);
+        __m256i m = _mm256_load_si256((const __m256i*)my);
+        __m256i o = _mm256_load_si256((const __m256i*)op);
+        int n_km = distance_layers_x4<false>(m, e, batch_layers[0]);
+        int n_ko = distance_layers_x4<false>(o, e, batch_layers[1]);
+        int n_qm = 0, n_qo = 0;
+#if EVAL_QUEEN_TERRITORY
+        n_qm = distance_layers_x4<true>(m, e, batch_layers[2]);
+        n_qo = distance_layers_x4<true>(o, e, batch_layers[3]);
+#endif
+        for (int k = 0; k < 4 && g + k < n; k++) {
+            out[g + k] = (float)score_layers(batch_layers[0][k], n_km, batch_layers[1][k], n_ko,
+                                             batch_layers[2][k], n_qm, batch_layers[3][k], n_qo,
+                                             mobility_diff(*boards[g + k], root_player), turn);
+        }
+    }
+}
+#endif
+
+void (*evaluate_batch)(const Board* const* boards, int n, int root_player, int turn, float* out) = evaluate_batch_single;
+
+// Point every dispatched kernel at the best variant for this CPU
+void init_cpu_dispatch() {
+    cpu_level = detect_cpu_level();
+    ucb_argmax = ucb_argmax_scalar;
+    evaluate = evaluate_scalar;
+#if SIMD_LEVEL > 0
+    if (cpu_level >= CPU_POPCNT) {
+        ucb_argmax = ucb_argmax_sse;
+        evaluate = evaluate_popcnt;
+    }
+#endif
+#if SIMD_LEVEL > 1
+    if (cpu_level >= CPU_AVX2) {
+        ucb_argmax = ucb_argmax_avx2;
+        evaluate = evaluate_avx2;
+        evaluate_batch = evaluate_batch_avx2;
+    }
+#endif
+#if EVAL_NNUE
+    evaluate = evaluate_nnue;
+    evaluate_batch = evaluate_batch_single;
+#endif
+}
+
+// --- ROLLOUTS ---
+// A short greedy playout from a new leaf before evaluate(). The side to move
+// takes the destination with the most empty neighbours over all its amazons
+// (random among ties) and shoots next to an opponent amazon when the queen
+// reaches such a square, else at a random reachable one: queen_attacks and
+// king_step on bitboards, about one BFS layer per amazon and ply. Plies by
+// phase: ROLLOUT_OPENING for turns 1-10, ROLLOUT_MIDGAME for 11-20 and
+// ROLLOUT_ENDGAME after, all ROLLOUT_PLIES unless set; 0 (the default) leaves
+// evaluate() to score the leaf itself. Four plies make an opening iteration
+// 2.5x as slow (tools/bench) and cost strength at every move time measured
+// (tools/arena, 200 games: -205 Elo at 30 ms per move, -111 at 100 ms).
+#ifndef ROLLOUT_PLIES
+#define ROLLOUT_PLIES 0
+#endif
+#ifndef ROLLOUT_OPENING
+#define ROLLOUT_OPENING ROLLOUT_PLIES
+#endif
+#ifndef ROLLOUT_MIDGAME
+#define ROLLOUT_MIDGAME ROLLOUT_PLIES
+#endif
+#ifndef ROLLOUT_ENDGAME
+#define ROLLOUT_ENDGAME ROLLOUT_PLIES
+#endif
+
+inline int rollout_plies(int turn) {
+    return turn <= 10 ? ROLLOUT_OPENING : turn <= 20 ? ROLLOUT_MIDGAME : ROLLOUT_ENDGAME;
+}
+
+// Play up to plies greedy full moves on state, to_move first; returns the side
+// left without a move, 0 if every ply had one
+int rollout(Board& state, int to_move, int plies) {
+    for (int p = 0; p < plies; p++, to_move = -to_move) {
+        uint64_t occ = state.occupied();
+        uint32_t r = fast_rand();
+        int best_from = -1, best_to = -1, best_score = -1;
+        for (uint64_t a = state.pieces[Board::side(to_move)]; a; a = clear_lsb(a)) {
+            int from = lsb_index(a);
+            uint64_t empty = ~occ | (1ULL << from);
+            for (uint64_t d = queen_attacks(from, occ); d; d = clear_lsb(d)) {
+                int to = lsb_index(d);
+                int score = popcount(king_step(1ULL << to) & empty) * 8 + (int)((r >> (to & 15)) & 7);
+                if (score > best_score) {
+                    best_score = score;
+                    best_from = from;
+                    best_to = to;
+                }
+            }
+        }
+        if (best_from < 0) return to_move;
+        // The vacated square is always a target, so there is a shot
+        uint64_t shots = queen_attacks(best_to, occ ^ (1ULL << best_from) ^ (1ULL << best_to));
+        uint64_t near = shots & king_step(state.pieces[Board::side(-to_move)]);
+        state.move_queen(best_from, best_to);
+        state.shoot(random_bit(near ? near : shots));
+    }
+    return 0;
+}
+
+// --- ENDGAME SOLVER ---
+// Late in the game the arrows wall the board into regions no amazon can leave.
+// A region holding amazons of one color only is private: all that matters is how
+// many moves its owner can still make there (its filling count), found by a
+// memoized depth-first search. Regions holding both colors are searched together
+// as one small game in which a side may also spend a move of its private reserve.
+// With nothing contested the side to move wins iff its reserve is the larger one.
+// A proved result is played at once; positions over the size, node or time
+// limits are left to MCTS.
+#ifndef ENDGAME_SOLVER
+#define ENDGAME_SOLVER 1
+#endif
+
+const int CONTESTED_MAX_EMPTY = 12;           // Largest contested area the game search takes on
+const int SOLVER_CACHE_BITS = 18;             // 256K entries x 32 bytes = 8 MB, allocated on first use
+const uint32_t SOLVER_NODE_LIMIT = 4000000;   // Per turn
+const double ENDGAME_TIME_SHARE = 0.3;        // Of the turn; the search gets what is left
+
+// Exact values only, so entries stay valid across turns. extra tells the two
+// kinds apart: -1 for a filling count, 1 + reserves for a game result.
+struct SolverEntry {
+    uint64_t empty, mine, theirs;
+    int32_t extra;
+    int32_t value;
+};
+
+SolverEntry* solver_cache = nullptr;
+uint32_t solver_nodes;
+bool solver_aborted;
+chrono::steady_clock::time_point solver_deadline;
+
+inline SolverEntry& solver_slot(uint64_t empty, uint64_t mine, uint64_t theirs, int32_t extra) {
+    uint64_t h = empty * 0x9E3779B97F4A7C15ULL ^ mine * 0xBF58476D1CE4E5B9ULL
+               ^ theirs * 0x94D049BB133111EBULL ^ (uint64_t)(uint32_t)extra * 0xD6E8FEB86659FD93ULL;
+    return solver_cache[h >> (64 - SOLVER_CACHE_BITS)];
+}
+
+inline bool solver_lookup(uint64_t empty, uint64_t mine, uint64_t theirs, int32_t extra, int& value) {
+    const SolverEntry& e = solver_slot(empty, mine, theirs, extra);
+    if (e.extra != extra || e.empty != empty || e.mine != mine || e.theirs != theirs) return false;
+    value = e.value;
+    return true;
+}
+
+inline void solver_store(uint64_t empty, uint64_t mine, uint64_t theirs, int32_t extra, int value) {
+    SolverEntry& e = solver_slot(empty, mine, theirs, extra);
+    e.empty = empty;
+    e.mine = mine;
+    e.theirs = theirs;
+    e.extra = extra;
+    e.value = value;
+}
+
+// Count a node; false once the node or time limit is hit
+inline bool solver_tick() {
+    if (++solver_nodes > SOLVER_NODE_LIMIT) solver_aborted = true;
+    else if ((solver_nodes & 0xFFF) == 0 && !deterministic_search() && chrono::steady_clock::now() >= solver_deadline)
+        solver_aborted = true;
+    return !solver_aborted;
+}
+
+// Squares of `area` king-connected to seed (amazons block nobody for good: they move away)
+inline uint64_t flood(uint64_t seed, uint64_t area) {
+    uint64_t r = seed, prev;
+    do {
+        prev = r;
+        r = king_step(r) & area;
+    } while (r != prev);
+    return r;
+}
+
+// Most moves `amazons` can make on their own in `empty`; -1 past the limits.
+// best, if given, receives a first move of such a sequence.
+int fill_count(uint64_t amazons, uint64_t empty, Move* best = nullptr) {
+    if (!amazons) return 0;
+    // Independent parts are counted separately
+    uint64_t comp = flood(amazons & -amazons, amazons | empty);
+    if (amazons & ~comp) {
+        int a = fill_count(amazons & comp, empty & comp, best);
+        if (a < 0) return -1;
+        int b = fill_count(amazons & ~comp, empty & ~comp, a > 0 ? nullptr : best);
+        return b < 0 ? -1 : a + b;
+    }
+    empty &= comp; // Squares cut off from every amazon never come back
+    int bound = popcount(empty);
+    int value = 0;
+    if (bound == 0) return 0;
+    if (!best && solver_lookup(empty, amazons, 0, -1, value)) return value;
+    if (!solver_tick()) return -1;
+    for (uint64_t p = amazons; p && value < bound; p = clear_lsb(p)) {
+        int from = lsb_index(p);
+        for (uint64_t d = queen_attacks(from, ~empty); d && value < bound; d = clear_lsb(d)) {
+            int to = lsb_index(d);
+            uint64_t after = (empty ^ (1ULL << to)) | (1ULL << from);
+            uint64_t moved = amazons ^ (1ULL << from) ^ (1ULL << to);
+            for (uint64_t s = queen_attacks(to, ~after); s && value < bound; s = clear_lsb(s)) {
+                int arrow = lsb_index(s);
+                int v = fill_count(moved, after ^ (1ULL << arrow));
+                if (v < 0) return -1;
+                if (v + 1 > value) {
+                    value = v + 1;
+                    if (best) *best = Move(from, to, arrow);
+                }
+            }
+        }
+    }
+    solver_store(empty, amazons, 0, -1, value);
+    return value;
+}
+
+// 1 if the side to move wins, 0 if it loses, -1 past the limits. mine/theirs/empty
+// describe the area still in play; r_mine/r_theirs are the moves each side has in
+// private regions elsewhere. At the root best receives the winning move, with
+// from = 255 when the win is to spend a reserve move.
+int game_search(uint64_t mine, uint64_t theirs, uint64_t empty, int r_mine, int r_theirs, Move* best = nullptr) {
+    // Regions of the area that became private move into the reserves
+    uint64_t contested = 0;
+    for (uint64_t left = mine | theirs; left; ) {
+        uint64_t comp = flood(left & -left, mine | theirs | empty);
+        left &= ~comp;
+        if ((mine & comp) && (theirs & comp)) { contested |= comp; continue; }
+        int f = fill_count((mine | theirs) & comp, empty & comp);
+        if (f < 0) return -1;
+        if (mine & comp) r_mine += f; else r_theirs += f;
+    }
+    mine &= contested;
+    theirs &= contested;
+    empty &= contested;
+    // Spending reserves alone already wins, or cannot catch up even with the whole area
+    int e = popcount(empty);
+    if (r_mine > r_theirs + e) { if (best) best->from = 255; return 1; }
+    if (r_theirs >= r_mine + e) return 0;
+
+    int32_t extra = 1 + (r_mine << 8 | r_theirs);
+    int value = 0;
+    if (!best && solver_lookup(empty, mine, theirs, extra, value)) return value;
+    if (!solver_tick()) return -1;
+    for (uint64_t p = mine; p && !value; p = clear_lsb(p)) {
+        int from = lsb_index(p);
+        for (uint64_t d = queen_attacks(from, ~empty); d && !value; d = clear_lsb(d)) {
+            int to = lsb_index(d);
+            uint64_t after = (empty ^ (1ULL << to)) | (1ULL << from);
+            uint64_t moved = mine ^ (1ULL << from) ^ (1ULL << to);
+            for (uint64_t s = queen_attacks(to, ~after); s && !value; s = clear_lsb(s)) {
+                int arrow = lsb_index(s);
+                int v = game_search(theirs, moved, after ^ (1ULL << arrow), r_theirs, r_mine);
+                if (v < 0) return -1;
+                if (v == 0) {
+                    value = 1;
+                    if (best) *best = Move(from, to, arrow);
+                }
+            }
+        }
+    }
+    if (!value && r_mine > 0) {
+        int v = game_search(theirs, mine, empty, r_theirs, r_mine - 1);
+        if (v < 0) return -1;
+        if (v == 0) {
+            value = 1;
+            if (best) best->from = 255;
+        }
+    }
+    solver_store(empty, mine, theirs, extra, value);
+    return value;
+}
+
+// Proved move for color, or false to leave the position to MCTS. Once no region
+// is contested the best move is any move keeping a private filling count, win or
+// lose; with a contested area only a proved win is played.
+bool solve_endgame(const Board& board, int color, chrono::steady_clock::time_point start, double budget, Move& out) {
+    uint64_t mine = board.pieces[Board::side(color)];
+    uint64_t theirs = board.pieces[Board::side(-color)];
+    uint64_t empty = ~board.occupied();
+    uint64_t contested = 0;
+    int contested_empty = 0;
+    for (uint64_t left = mine | theirs; left; ) {
+        uint64_t comp = flood(left & -left, mine | theirs | empty);
+        left &= ~comp;
+        if ((mine & comp) && (theirs & comp)) {
+            contested |= comp;
+            contested_empty += popcount(empty & comp);
+        }
+    }
+    if (contested_empty > CONTESTED_MAX_EMPTY) return false;
+
+    if (!solver_cache) solver_cache = (SolverEntry*)calloc(1 << SOLVER_CACHE_BITS, sizeof(SolverEntry));
+    solver_nodes = 0;
+    solver_aborted = false;
+    solver_deadline = start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(budget));
+
+    // Reserves, and a move that keeps ours whole
+    Move reserve_move(255, 255, 255);
+    int r_mine = 0, r_theirs = 0;
+    for (uint64_t left = (mine | theirs) & ~contested; left; ) {
+        uint64_t comp = flood(left & -left, mine | theirs | empty);
+        left &= ~comp;
+        bool own_side = (mine & comp) != 0;
+        Move m(255, 255, 255);
+        int f = fill_count((mine | theirs) & comp, empty & comp, own_side && reserve_move.from == 255 ? &m : nullptr);
+        if (f < 0) return false;
+        if (own_side) {
+            r_mine += f;
+            if (f > 0 && reserve_move.from == 255) reserve_move = m;
+        } else {
+            r_theirs += f;
+        }
+    }
+
+    if (!contested) {
+        out = reserve_move;
+        return out.from != 255; // No move at all is for the search to report
+    }
+    Move m(255, 255, 255);
+    if (game_search(mine & contested, theirs & contested, empty & contested, r_mine, r_theirs, &m) != 1) return false;
+    out = m.from == 255 ? reserve_move : m;
+    return out.from != 255;
+}
+
+// --- SEARCH ---
+// LEAF_BATCH leaves are selected per step under virtual loss, evaluated together
+// (evaluate_batch) and backed up together; 1 is plain one-leaf-at-a-time MCTS.
+#ifndef LEAF_BATCH
+#define LEAF_BATCH 1
+#endif
+
+// --- TIME MANAGEMENT ---
+// The turn limit is only an upper bound. At every clock check the search
+// projects how many more iterations it will run before the deadline (or the
+// node limit) at the rate since the search started, and stops once the runner-up root
+// child could not catch the most visited one even if it got every one of them.
+// A root child that ends the game in our favour, or at most one legal move,
+// ends the turn at once; a proved endgame never reaches the search (choose_move).
+// -DEARLY_STOP=0 always spends the full limit.
+#ifndef EARLY_STOP
+#define EARLY_STOP 1
+#endif
+
+const int EARLY_STOP_MIN_ITERATIONS = 1024; // Before this the rate estimate is noise
+
+// Whether the most visited root child can no longer be overtaken this turn;
+// children proven lost (MCTS solver below) are out of the race
+bool root_decided(int root, int iterations, chrono::steady_clock::time_point start,
+                  chrono::steady_clock::time_point now, chrono::steady_clock::time_point deadline) {
+    if (iterations < EARLY_STOP_MIN_ITERATIONS) return false;
+    const MCTSNode& r = node_pool[root];
+    int first = -1, second = 0;
+    for (int i = 0; i < r.child_count; i++) {
+        if (node_pool[r.first_child + i].proof == PROOF_LOSS) continue;
+        int v = node_visits[r.first_child + i];
+        if (v > first) {
+            second = max(first, 0);
+            first = v;
+        } else if (v > second) {
+            second = v;
+        }
+    }
+    double elapsed = chrono::duration<double>(now - start).count();
+    double left = chrono::duration<double>(deadline - now).count();
+    double remaining = elapsed > 0 ? iterations * left / elapsed : 1e18;
+    if (search_node_limit) remaining = (double)search_node_limit - iterations; // Reproducible in fixed-node matches
+    // Unexpanded moves would start from zero visits, so the runner-up bound covers them
+    return first - second > remaining;
+}
+
+// --- MCTS SOLVER ---
+// A node whose side to move is stuck is a proven win for its player_just_moved,
+// and proofs climb the search path: the side to move at a node has won once a
+// child is a proven win for it, and has lost once it has tried every move (dry
+// and not prefiltered) and every child is a proven loss for it. A node proven
+// lost for its player_just_moved gets PROOF_LOSS_WINS as its wins, so UCB never
+// picks it again; a proven win proves its parent, so selection does not enter
+// either. The search ends as soon as the root is proven, in every thread.
+// -DMCTS_SOLVER=0 only scores terminal leaves.
+#ifndef MCTS_SOLVER
+#define MCTS_SOLVER 1
+#endif
+
+const float PROOF_LOSS_WINS = -1e9f;
+const int PROVEN_VISITS = 1 << 24; // Reported for a proven winning root move, so every merge picks it,
+                                   // and negated for a proven losing one, so none does unless all are
+atomic<bool> root_solved(false);   // Some thread has proven its root; the main thread clears it per search
+
+inline void set_proof(int n, uint8_t proof) {
+    node_pool[n].proof = proof;
+    if (proof == PROOF_LOSS) node_wins[n] = PROOF_LOSS_WINS;
+}
+
+// path[d] was just proven: prove its ancestors as far as it decides them
+void propagate_proof(const int* path, int d) {
+    for (; d > 0; d--) {
+        const MCTSNode& child = node_pool[path[d]];
+        const MCTSNode& parent = node_pool[path[d - 1]];
+        if (parent.proof) return;
+        int mover = child.player_just_moved();
+        bool mover_wins = child.proof == PROOF_WIN;
+        if (!mover_wins) {
+            if (parent.has_untried() || (parent.flags & NODE_PRUNED)) return;
+            for (int i = 0; i < parent.child_count; i++)
+                if (node_pool[parent.first_child + i].proof != PROOF_LOSS) return;
+        }
+        set_proof(path[d - 1], mover_wins == (mover == parent.player_just_moved()) ? PROOF_WIN : PROOF_LOSS);
+    }
+}
+
+// Child of n that is a proven win for the side to move at n, NO_NODE if none
+inline int proven_child(int n) {
+    const MCTSNode& node = node_pool[n];
+    for (int i = 0; i < node.child_count; i++)
+        if (node_pool[node.first_child + i].proof == PROOF_WIN) return node.first_child + i;
+    return NO_NODE;
+}
+
+// Most visited child of n that is not a proven loss for the side to move at n,
+// the most visited child if all are; NO_NODE if n has none. A proven loss keeps
+// the visits it took before its proof, so the raw count alone could pick it.
+int most_visited_child(int n) {
+    const MCTSNode& node = node_pool[n];
+    int best = NO_NODE, best_any = NO_NODE;
+    for (int i = 0; i < node.child_count; i++) {
+        int c = node.first_child + i;
+        if (best_any == NO_NODE || node_visits[c] > node_visits[best_any]) best_any = c;
+        if (node_pool[c].proof != PROOF_LOSS && (best == NO_NODE || node_visits[c] > node_visits[best])) best = c;
+    }
+    return best != NO_NODE ? best : best_any;
+}
+
+// The complete move of a root child; a two-level queen step is finished with
+// its proven or most visited arrow that is not proven lost
+Move full_move(int child, const Board& root_state) {
+    const MCTSNode& b = node_pool[child];
+    if (!b.half_move()) return b.move;
+    int best_arrow = most_visited_child(child);
+    if (MCTS_SOLVER && proven_child(child) != NO_NODE) best_arrow = proven_child(child);
+    if (best_arrow != NO_NODE) return node_pool[best_arrow].move;
+    Board state = root_state;
+    state.move_queen(b.move.from, b.move.to);
+    return Move(b.move.from, b.move.to, lsb_index(queen_attacks(b.move.to, state.occupied())));
+}
+
+// Most visited root child, as a position in the root's block; it may have been
+// proven lost since, which search() checks before playing it
+thread_local int best_child_offset = -1;
+thread_local int max_visits_global = -1;
+
+// Set while the main thread ponders; the input reader raises reply_pending
+// when the opponent's move arrives and the search stops at its next check
+thread_local bool pondering = false;
+atomic<bool> reply_pending(false);
+
+// --- ROOT PREFILTER ---
+// At the start of a search every root move that is not a child yet gets a one-
+// ply score: squares only our amazons reach in one queen move minus squares
+// only the opponent's reach (twice), plus the mobility difference, all from
+// queen_attacks on the position after the move. The root then expands the best
+// K of them, K growing with the time of the search, in that order, followed by
+// PREFILTER_SAMPLE random others so a move the score misjudges can still come
+// up; the rest are never tried. Positions with few moves, and searches long
+// enough to reach every move anyway, keep the widening order.
+// -DROOT_PREFILTER=0 turns it off.
+#ifndef ROOT_PREFILTER
+#define ROOT_PREFILTER 1
+#endif
+
+const int PREFILTER_MIN_MOVES = 256;     // Below this the root keeps every move
+const int PREFILTER_MIN_K = 128;
+const double PREFILTER_K_PER_SECOND = 256;
+const int PREFILTER_SAMPLE = 16;
+
+// One-ply score of m for the side owning its amazon
+inline int prefilter_score(const Board& board, int side, const Move& m) {
+    uint64_t moved = (1ULL << m.from) | (1ULL << m.to);
+    uint64_t occ = (board.occupied() ^ moved) | (1ULL << m.arrow);
+    uint64_t mine = board.pieces[side] ^ moved, theirs = board.pieces[side ^ 1];
+    uint64_t my_reach = 0, op_reach = 0;
+    int mobility = 0;
+    for (uint64_t p = mine; p; p = clear_lsb(p)) {
+        uint64_t a = queen_attacks(lsb_index(p), occ);
+        my_reach |= a;
+        mobility += popcount(a);
+    }
+    for (uint64_t p = theirs; p; p = clear_lsb(p)) {
+        uint64_t a = queen_attacks(lsb_index(p), occ);
+        op_reach |= a;
+        mobility -= popcount(a);
+    }
+    return 2 * (popcount(my_reach & ~op_reach) - popcount(op_reach & ~my_reach)) + mobility;
+}
+
+// Replace the untried moves of the root by the prefiltered list
+void prefilter_root(int root, const Board& state, int color, double timeout) {
+    MCTSNode& node = node_pool[root];
+    if (!ROOT_PREFILTER || TWO_LEVEL_TREE || !node.has_untried()) return;
+    static thread_local Move moves[MAX_MOVES];
+    static thread_local int keys[MAX_MOVES];
+    static thread_local uint64_t is_child[NUM_SQUARES * NUM_SQUARES]; // Arrow bits by (from, to)
+    int count = generate_moves(state, color, moves);
+    if (count < PREFILTER_MIN_MOVES) return;
+    int k_max = max(PREFILTER_MIN_K, (int)(timeout * PREFILTER_K_PER_SECOND)) - node.child_count;
+    if (k_max + PREFILTER_SAMPLE >= count) return;
+    
+    for (int i = 0; i < node.child_count; i++) {
+        const Move& c = node_pool[node.first_child + i].move;
+        is_child[c.from * NUM_SQUARES + c.to] |= 1ULL << c.arrow;
+    }
+    int side = Board::side(color), n = 0;
+    bool symmetric = node.flags & NODE_SYMMETRIC;
+    for (int i = 0; i < count; i++) {
+        const Move& m = moves[i];
+        if ((is_child[m.from * NUM_SQUARES + m.to] >> m.arrow & 1) || (symmetric && m.from >= NUM_SQUARES / 2))
+            continue;
+        // Low bits break ties at random
+        keys[n] = prefilter_score(state, side, m) * 1024 + (int)(fast_rand() & 1023);
+        moves[n++] = m;
+    }
+    for (int i = 0; i < node.child_count; i++) {
+        const Move& c = node_pool[node.first_child + i].move;
+        is_child[c.from * NUM_SQUARES + c.to] = 0;
+    }
+    
+    // Best k_max by key into root_list, then a random sample of the rest
+    static thread_local int order[MAX_MOVES];
+    for (int i = 0; i < n; i++) order[i] = i;
+    int k = max(0, min(k_max, n));
+    partial_sort(order, order + k, order + n, [](int a, int b) { return keys[a] > keys[b]; });
+    int listed = 0;
+    for (int i = 0; i < k; i++) root_list[listed++] = moves[order[i]];
+    for (int i = k; i < n && i < k + PREFILTER_SAMPLE; i++) {
+        swap(order[i], order[i + (int)(fast_rand() % (uint32_t)(n - i))]);
+        root_list[listed++] = moves[order[i]];
+    }
+    
+    release_cursor(node);
+    node.flags |= NODE_STARTED | NODE_PRUNED;
+    if (!listed) {
+        node.flags |= NODE_DRY;
+        return;
+    }
+    node.cursor = alloc_cursor();
+    node.flags |= NODE_POOLED;
+    cursor_pool[node.cursor].init_list(listed);
+}
+
+// --- SEARCH STATISTICS ---
+// -DSEARCH_STATS=1 counts cycles in each phase of an MCTS iteration and prints
+// one line per turn on stderr (Botzone keeps it as the debug log):
+//   SEARCH_STATS turn=12 engine=mcts time_ms=979.6 iterations=301056 nodes=...
+//     peak_nodes=... max_depth=14 avg_depth=6.21 rss_mb=212.4 faults=... stop=deadline
+//     select_ms=... expand_ms=... evaluate_ms=... backup_ms=...
+// Phase times split the wall time in proportion to their cycle counts, so the
+// TSC frequency is not needed. scripts/tournament copies the fields into the
+// profile CSV. nodes are live tree slots (bot033 keeps no move pool). Without
+// SEARCH_STATS every STATS(...) is empty and nothing is counted.
+#ifndef SEARCH_STATS
+#define SEARCH_STATS 0
+#endif
+#if SEARCH_STATS
+#define STATS(x) x
+#else
+#define STATS(x)
+#endif
+
+enum StatPhase { STAT_SELECT, STAT_EXPAND, STAT_EVALUATE, STAT_BACKUP, NUM_STAT_PHASES };
+enum StopReason { STOP_NONE, STOP_DEADLINE, STOP_NODE_LIMIT, STOP_MEMORY, STOP_SOLVED, STOP_DECIDED };
+const char* const STAT_PHASE_NAMES[NUM_STAT_PHASES] = { "select", "expand", "evaluate", "backup" };
+const char* const STOP_NAMES[] = { "none", "deadline", "node_limit", "memory", "solved", "decided" };
+
+struct SearchStats {
+    uint64_t cycles[NUM_STAT_PHASES];
+    uint64_t depth_sum;
+    int max_depth;
+    int peak_nodes;
+    int stop;
+    long fault_base; // page_faults() when the search started, 0 outside MCTS
+};
+
+thread_local SearchStats search_stats;
+
+inline uint64_t stat_clock() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return (uint64_t)chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+// Charge the cycles since mark to phase and restart the mark
+inline void stat_lap(int phase, uint64_t& mark) {
+    uint64_t now = stat_clock();
+    search_stats.cycles[phase] += now - mark;
+    mark = now;
+}
+
+// Tree slots in use by this thread: reserved chunks minus free lists and the unused chunk tail
+inline int live_nodes() {
+    return arena_usage[thread_id].load(memory_order_relaxed) - free_count - (chunk_end - chunk_next);
+}
+
+void report_search_stats(int turn, const char* engine, chrono::steady_clock::time_point start, int iterations) {
+    const SearchStats& st = search_stats;
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    uint64_t total = 0;
+    for (int k = 0; k < NUM_STAT_PHASES; k++) total += st.cycles[k];
+    fprintf(stderr, "SEARCH_STATS turn=%d engine=%s time_ms=%.1f iterations=%d nodes=%d peak_nodes=%d "
+            "max_depth=%d avg_depth=%.2f rss_mb=%.1f faults=%ld stop=%s", turn, engine, ms, iterations, live_nodes(),
+            st.peak_nodes, st.max_depth, iterations ? (double)st.depth_sum / iterations : 0.0,
+            memory.sample() / 1048576.0, st.fault_base ? page_faults() - st.fault_base : 0L, STOP_NAMES[st.stop]);
+    for (int k = 0; k < NUM_STAT_PHASES; k++)
+        fprintf(stderr, " %s_ms=%.1f", STAT_PHASE_NAMES[k], total ? ms * st.cycles[k] / total : 0.0);
+    fprintf(stderr, "\n");
+}
+
+Move search(const Board& root_state, int root_player, int turn, chrono::steady_clock::time_point start, double timeout) {
+    if (tree_root == NO_NODE) {
+        tree_root = new_node(NO_NODE, Move(), -root_player);
+        init_untried(tree_root, root_state, root_player);
+    }
+    const int root = tree_root;
+    if (thread_id == 0) root_solved.store(false); // parallel_search clears it before the helpers start too
+    if (deterministic_search()) seed_rng(thread_id);
+    prefilter_root(root, root_state, root_player, timeout);
+    
+    best_child_offset = -1;
+    max_visits_global = -1;
+    for (int i = 0; i < node_pool[root].child_count; i++) {
+        if (node_visits[node_pool[root].first_child + i] > max_visits_global) {
+            max_visits_global = node_visits[node_pool[root].first_child + i];
+            best_child_offset = i;
+        }
+    }
+    
+    int iterations = 0, next_check = 0;
+    bool won = false; // A root move leaves the opponent without a move
+    Move winning_move;
+    float C = exploration(turn);
+    init_root_layers(root_state);
+    const int rollout_len = rollout_plies(turn);
+    tt_gen++;
+    STATS(memset(&search_stats, 0, sizeof(search_stats)));
+    STATS(search_stats.fault_base = page_faults());
+    // Leaves of one batch. Selection pushes every node of a leaf's path and its
+    // offset in the parent's block; a later leaf of the batch may move a block
+    // on the path, so batched paths are re-resolved from the offsets before
+    // backup. The path hashes are only kept for the transposition table.
+    int leaf_depth[LEAF_BATCH];
+    static thread_local int path_node[LEAF_BATCH][MAX_PATH];
+    static thread_local uint16_t path_offset[LEAF_BATCH][MAX_PATH];
+    float leaf_value[LEAF_BATCH];
+    bool leaf_done[LEAF_BATCH];
+    Board leaf_state[LEAF_BATCH];
+    const Board* pending[LEAF_BATCH];
+    float pending_value[LEAF_BATCH];
+    static thread_local uint64_t path_hash[TRANSPOSITION_TABLE ? LEAF_BATCH : 1][MAX_PATH];
+    
+    // A visit is counted on the way down, so leaves later in a batch see the
+    // ones before them as pending losses (virtual loss) and spread out.
+    
+    auto deadline = start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(timeout));
+    auto search_start = chrono::steady_clock::now(); // Iteration rate is measured from here
+    
+    while(true) {
+        if (search_node_limit && (uint32_t)iterations >= search_node_limit) {
+            STATS(search_stats.stop = STOP_NODE_LIMIT);
+            break;
+        }
+        if (iterations >= next_check) {
+            next_check += 256;
+            STATS(search_stats.peak_nodes = max(search_stats.peak_nodes, live_nodes()));
+            if (pondering && reply_pending.load(memory_order_relaxed)) break;
+            if (MCTS_SOLVER && root_solved.load(memory_order_relaxed)) {
+                STATS(search_stats.stop = STOP_SOLVED);
+                break;
+            }
+            auto now = chrono::steady_clock::now();
+            if (now >= deadline && !deterministic_search()) {
+                STATS(search_stats.stop = STOP_DEADLINE);
+                break;
+            }
+            if (EARLY_STOP && !pondering && root_decided(root, iterations, search_start, now, deadline)) {
+                STATS(search_stats.stop = STOP_DECIDED);
+                break;
+            }
+            // RSS-based memory check: past the soft limit keep going only on reclaimed nodes
+            size_t rss = memory.sample();
+            if (rss > memory.hard_limit || cursors_left() < 2 * 256) {
+                STATS(search_stats.stop = STOP_MEMORY);
+                break;
+            }
+            if (rss > memory.soft_limit && free_count < 256) {
+                if (gc_top == 0) {
+                    STATS(search_stats.stop = STOP_MEMORY);
+                    break;
+                }
+                gc_collect_some(GC_SLICE_FULL);
+            } else {
+                gc_collect_some(GC_SLICE);
+            }
+        }
+        STATS(uint64_t mark = stat_clock());
+        
+        int n_pending = 0;
+        for (int b = 0; b < LEAF_BATCH; b++) {
+            int node = root;
+            Board& state = leaf_state[b];
+            state = root_state;
+            int current_player = root_player;
+            int depth = 0;
+            int* path = path_node[b];
+            uint16_t* offsets = path_offset[b];
+            uint64_t* hashes = path_hash[TRANSPOSITION_TABLE ? b : 0];
+            path[0] = root;
+            
+            // Select
+            while (!(MCTS_SOLVER && node_pool[node].proof) && node_pool[node].child_count != 0 &&
+                   !(node_pool[node].has_untried() && can_widen(node))) {
+                int child = uct_select_child(node, C);
+                node_visits[node]++;
+                offsets[++depth] = (uint16_t)(child - node_pool[node].first_child);
+                path[depth] = child;
+                node = child;
+                apply_edge(state, node, current_player);
+                if (TRANSPOSITION_TABLE) hashes[depth] = canonical_hash(state.hash);
+            }
+            STATS(stat_lap(STAT_SELECT, mark));
+            
+            float win_prob = 0.0f;
+            bool terminal = false;
+            
+            // Expand
+            if (MCTS_SOLVER && node_pool[node].proof) {
+                // Proven node on the path (a batch proved it, or all its siblings are proven too)
+                win_prob = ((node_pool[node].proof == PROOF_WIN) == (node_pool[node].player_just_moved() == root_player)) ? 1.0f : 0.0f;
+                terminal = true;
+            } else if (node_pool[node].has_untried()) {
+                // Pull the next untried move from the node's cursor
+                Move m = next_untried(node, state, current_player);
+                // A mirrored pair of moves from a symmetric position: keep the one
+                // from rows 0-3 (the last draw of a node stays even if it is not)
+                if (node_pool[node].flags & NODE_SYMMETRIC)
+                    while (m.from >= NUM_SQUARES / 2 && node_pool[node].has_untried())
+                        m = next_untried(node, state, current_player);
+                bool half = TWO_LEVEL_TREE && !node_pool[node].half_move();
+                
+                int new_n = new_node(node, m, current_player, half);
+                node_visits[node]++;
+                offsets[++depth] = (uint16_t)(new_n - node_pool[node].first_child);
+                path[depth] = new_n;
+                apply_edge(state, new_n, current_player);
+                init_untried(new_n, state, current_player);
+                if (TRANSPOSITION_TABLE) hashes[depth] = canonical_hash(state.hash);
+                
+                // Terminal check (a half move always has at least one arrow)
+                if (!node_pool[new_n].has_untried()) {
+                    // Current player stuck -> Previous player (who just moved) wins
+                    win_prob = (current_player == root_player) ? 0.0f : 1.0f;
+                    terminal = true;
+                    if (MCTS_SOLVER) {
+                        set_proof(new_n, PROOF_WIN);
+                        propagate_proof(path, depth);
+                    }
+                    if (node == root) {
+                        won = true;
+                        winning_move = m;
+                    }
+                } else if (TRANSPOSITION_TABLE && depth >= TT_MIN_DEPTH && !half) {
+                    // Transposition: take the known mean of this position instead of evaluating
+                    TTEntry* e = tt_probe(canonical_hash(state.hash));
+                    if (e->visits) {
+                        float mean = e->wins / e->visits;
+                        win_prob = (node_pool[new_n].player_just_moved() == root_player) ? mean : 1.0f - mean;
+                        terminal = true;
+                    }
+                }
+                
+                node = new_n;
+            } else if (node_pool[node].child_count == 0) {
+                // Terminal: no moves and no children -> player_just_moved wins
+                win_prob = (node_pool[node].player_just_moved() == root_player) ? 1.0f : 0.0f;
+                terminal = true;
+                if (MCTS_SOLVER) {
+                    set_proof(node, PROOF_WIN);
+                    propagate_proof(path, depth);
+                }
+            }
+            node_visits[node]++;
+            // Root child of this path: the only one whose count changed
+            if (depth > 0 && node_visits[path[1]] > max_visits_global) {
+                max_visits_global = node_visits[path[1]];
+                best_child_offset = offsets[1];
+            }
+            STATS(stat_lap(STAT_EXPAND, mark));
+            STATS(search_stats.depth_sum += depth);
+            STATS(search_stats.max_depth = max(search_stats.max_depth, depth));
+            if (rollout_len && !terminal && !node_pool[node].half_move()) {
+                int stuck = rollout(state, current_player, rollout_len);
+                if (stuck) {
+                    win_prob = (stuck == root_player) ? 0.0f : 1.0f;
+                    terminal = true;
+                }
+                STATS(stat_lap(STAT_EVALUATE, mark));
+            }
+            
+            leaf_depth[b] = depth;
+            leaf_value[b] = win_prob;
+            leaf_done[b] = terminal;
+            if (!terminal) pending[n_pending++] = &state;
+        }
+        
+        // Sim/Eval
+        if (n_pending == 1) pending_value[0] = (float)evaluate(*pending[0], root_player, turn);
+        else if (n_pending) evaluate_batch(pending, n_pending, root_player, turn, pending_value);
+        STATS(stat_lap(STAT_EVALUATE, mark));
+        
+        // Backprop: win_prob is relative to root; store wins for player who just moved
+        // Without the two-level tree the mover alternates by depth (the root's
+        // player_just_moved is the opponent), so only node_wins is touched.
+        for (int b = 0, k = 0; b < LEAF_BATCH; b++) {
+            float win_prob = leaf_done[b] ? leaf_value[b] : pending_value[k++];
+            int* path = path_node[b];
+            if (LEAF_BATCH > 1)
+                for (int d = 1; d <= leaf_depth[b]; d++) path[d] = node_pool[path[d - 1]].first_child + path_offset[b][d];
+            for (int d = leaf_depth[b]; d >= 0; d--) {
+                int node = path[d];
+                bool mover = TWO_LEVEL_TREE ? node_pool[node].player_just_moved() == root_player : (d & 1);
+                float result = mover ? win_prob : 1.0f - win_prob;
+                node_wins[node] += result;
+                if (TRANSPOSITION_TABLE && d >= TT_MIN_DEPTH && !node_pool[node].half_move() && !node_pool[node].proof)
+                    tt_update(path_hash[b][d], node, result);
+            }
+        }
+        
+        STATS(stat_lap(STAT_BACKUP, mark));
+        iterations += LEAF_BATCH;
+        if (EARLY_STOP && won) {
+            STATS(search_stats.stop = STOP_SOLVED);
+            break;
+        }
+        if (MCTS_SOLVER && node_pool[root].proof) {
+            root_solved.store(true, memory_order_relaxed);
+            STATS(search_stats.stop = STOP_SOLVED);
+            break;
+        }
+    }
+    STATS(if (thread_id == 0) report_search_stats(turn, pondering ? "ponder" : "mcts", start, iterations));
+    root_layers.active = false;
+    
+    if (node_pool[root].child_count == 0) return Move(255, 255, 255); // Invalid move marker
+    if (EARLY_STOP && won) return winning_move;
+    if (MCTS_SOLVER && node_pool[root].proof == PROOF_LOSS) return full_move(proven_child(root), root_state);
+    int best = node_pool[root].first_child + (best_child_offset >= 0 ? best_child_offset : 0);
+    if (node_pool[best].proof == PROOF_LOSS) best = most_visited_child(root);
+    return full_move(best, root_state);
+}
+
+// --- ALPHA-BETA SEARCH ---
+// Second search backend on the same Board, Move and evaluate(): iterative
+// deepening principal-variation search over complete moves. Moves are tried in
+// the order TT move, two killers per ply, then history of the queen step plus
+// score_move. The transposition table lives as long as the engine, so scores
+// carry over between iterations and turns. The search stops at the same
+// deadline as MCTS and plays the best move of the deepest finished iteration.
+const int AB_MAX_PLY = 64;
+const int AB_INF = 32767;
+const int AB_WIN = 32000;          // AB_WIN - ply: the side to move has won at ply
+const int AB_EVAL_SCALE = 30000;   // evaluate() 0..1 maps to -30000..30000
+const int AB_TT_BITS = 20;         // 1M entries x 12 bytes
+
+enum Bound : uint8_t { BOUND_EXACT, BOUND_LOWER, BOUND_UPPER };
+
+struct ABEntry {
+    uint32_t check;  // High half of the hash
+    int16_t score;   // Wins are stored relative to this position
+    uint8_t depth;
+    uint8_t bound;
+    Move move;
+    uint8_t gen;
+};
+
+struct ScoredMove {
+    Move move;
+    int score;
+};
+
+class PVSEngine {
+public:
+    PVSEngine() : tt(1 << AB_TT_BITS), raw_moves(AB_MAX_PLY * MAX_MOVES), moves(AB_MAX_PLY * MAX_MOVES), gen(0) {
+        memset(history, 0, sizeof(history));
+    }
+
+    Move search(const Board& root, int color, int turn, chrono::steady_clock::time_point start, double timeout) {
+        deadline = start + chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(timeout));
+        eval_turn = turn;
+        nodes = 0;
+        stopped = false;
+        gen++;
+        for (int p = 0; p < AB_MAX_PLY; p++) killers[p][0] = killers[p][1] = Move(255, 255, 255);
+        for (int s = 0; s < 2; s++)
+            for (int k = 0; k < 4096; k++) history[s][k] >>= 1;
+
+        Move best(255, 255, 255); // Invalid move marker if there is no legal move
+        for (int depth = 1; depth < AB_MAX_PLY; depth++) {
+            root_best = Move(255, 255, 255);
+            Board b = root;
+            int score = pvs(b, color, depth, 0, -AB_INF, AB_INF);
+            if (root_best.from != 255) best = root_best; // A partial iteration searched its best move first
+            if (stopped || abs(score) >= AB_WIN - AB_MAX_PLY) break;
+        }
+        if (best.from == 255 && generate_moves(root, color, &raw_moves[0]) > 0) best = raw_moves[0];
+        return best;
+    }
+
+private:
+    vector<ABEntry> tt;
+    vector<Move> raw_moves;     // AB_MAX_PLY slices of MAX_MOVES each
+    vector<ScoredMove> moves;
+    Move killers[AB_MAX_PLY][2];
+    int history[2][4096];       // [side][from << 6 | to]
+    uint8_t gen;
+    chrono::steady_clock::time_point deadline;
+    int eval_turn;
+    uint32_t nodes;
+    bool stopped;
+    Move root_best;
+
+    inline ABEntry& tt_slot(uint64_t hash) {
+        return tt[hash & ((1 << AB_TT_BITS) - 1)];
+    }
+
+    // Evaluation from the side to move
+    inline int static_score(const Board& b, int color) {
+        return (int)((evaluate(b, color, eval_turn) - 0.5) * 2 * AB_EVAL_SCALE);
+    }
+
+    int pvs(Board& b, int color, int depth, int ply, int alpha, int beta) {
+        if ((++nodes & 0x7FF) == 0 && !deterministic_search() && chrono::steady_clock::now() >= deadline) stopped = true;
+        if (search_node_limit && nodes >= search_node_limit) stopped = true;
+        if (stopped) return 0;
+        int side = Board::side(color);
+        uint64_t occ = b.occupied();
+        if (!(king_step(b.pieces[side]) & ~occ)) return -(AB_WIN - ply); // No move left
+
+        ABEntry& e = tt_slot(b.hash);
+        Move tt_move(255, 255, 255);
+        if (e.check == (uint32_t)(b.hash >> 32)) {
+            tt_move = e.move;
+            int s = e.score;
+            if (s >= AB_WIN - AB_MAX_PLY) s -= ply;
+            else if (s <= -(AB_WIN - AB_MAX_PLY)) s += ply;
+            if (ply > 0 && e.depth >= depth &&
+                (e.bound == BOUND_EXACT || (e.bound == BOUND_LOWER && s >= beta) || (e.bound == BOUND_UPPER && s <= alpha)))
+                return s;
+        }
+        if (depth == 0) return static_score(b, color);
+
+        ScoredMove* list = &moves[ply * MAX_MOVES];
+        Move* gen_buf = &raw_moves[ply * MAX_MOVES];
+        int n = generate_moves(b, color, gen_buf);
+        uint64_t opp = b.pieces[side ^ 1];
+        uint64_t opp_reach = queen_reach(opp, occ);
+        for (int i = 0; i < n; i++) {
+            Move m = gen_buf[i];
+            int s;
+            if (m == tt_move) s = 1 << 30;
+            else if (m == killers[ply][0]) s = (1 << 29) + 1;
+            else if (m == killers[ply][1]) s = 1 << 29;
+            else s = history[side][m.from << 6 | m.to] * 32 + score_move(m, opp, opp_reach);
+            list[i].move = m;
+            list[i].score = s;
+        }
+        sort(list, list + n, [](const ScoredMove& x, const ScoredMove& y) { return x.score > y.score; });
+
+        int alpha0 = alpha;
+        int best_score = -AB_INF;
+        Move best_move = list[0].move;
+        for (int i = 0; i < n; i++) {
+            Move m = list[i].move;
+            Board c = b;
+            c.apply_move(m);
+            int s;
+            if (i == 0) {
+                s = -pvs(c, -color, depth - 1, ply + 1, -beta, -alpha);
+            } else {
+                s = -pvs(c, -color, depth - 1, ply + 1, -alpha - 1, -alpha);
+                if (s > alpha && s < beta) s = -pvs(c, -color, depth - 1, ply + 1, -beta, -alpha);
+            }
+            if (stopped) return 0;
+            if (s > best_score) {
+                best_score = s;
+                best_move = m;
+                if (ply == 0) root_best = m;
+            }
+            if (s > alpha) alpha = s;
+            if (alpha >= beta) {
+                if (!(m == killers[ply][0])) {
+                    killers[ply][1] = killers[ply][0];
+                    killers[ply][0] = m;
+                }
+                history[side][m.from << 6 | m.to] += depth * depth;
+                break;
+            }
+        }
+
+        int stored = best_score;
+        if (stored >= AB_WIN - AB_MAX_PLY) stored += ply;
+        else if (stored <= -(AB_WIN - AB_MAX_PLY)) stored -= ply;
+        if (e.gen != gen || depth >= e.depth) {
+            e.check = (uint32_t)(b.hash >> 32);
+            e.score = (int16_t)stored;
+            e.depth = (uint8_t)depth;
+            e.bound = best_score >= beta ? BOUND_LOWER : best_score > alpha0 ? BOUND_EXACT : BOUND_UPPER;
+            e.move = best_move;
+            e.gen = gen;
+        }
+        return best_score;
+    }
+};
+
+// Which backend picks the move (SEARCH_ENGINE, --engine)
+enum SearchEngine { ENGINE_MCTS, ENGINE_PVS, ENGINE_HYBRID };
+const int HYBRID_MAX_MOVES = 300; // Hybrid: alpha-beta from this root move count down
+int search_engine = SEARCH_ENGINE;
+PVSEngine* pvs_engine = nullptr; // Built on first use (22 MB)
+
+// --- PARALLEL SEARCH ---
+// Root parallelism: helper threads run search() on their own trees, which are
+// kept across turns like the main one. At the deadline root visit counts are
+// summed by move over all trees and the most visited move is played.
+struct RootStat {
+    Move move;  // Complete move (a queen step carries its thread's best arrow)
+    int visits;
+};
+
+struct SearchJob {
+    Board board;
+    int color, turn;
+    chrono::steady_clock::time_point start;
+    double timeout;
+    vector<Move> advance; // Moves played since the previous job, replayed into every tree
+};
+
+vector<vector<RootStat> > worker_stats; // [0] is the main thread
+vector<Move> pending_moves;              // Moves the helper trees have not seen yet
+SearchJob job;
+int job_generation = 0;
+int workers_done = 0;
+// Never destroyed: helpers are still blocked on job_cv when main() returns
+mutex& job_mutex = *new mutex;
+condition_variable& job_cv = *new condition_variable;
+condition_variable& done_cv = *new condition_variable;
+
+// Allocate the shared node arena (once, before any search thread starts)
+static_assert(is_trivial<MCTSNode>::value, "the arena is raw mapped memory, never constructed");
+
+void init_arena() {
+    const size_t node_bytes = sizeof(MCTSNode) + sizeof(float) + sizeof(int);
+    size_t nodes = min((size_t)MAX_NODES, (size_t)(RSS_SOFT_LIMIT_MB * PREFAULT_SHARE * 1048576 / node_bytes));
+    node_pool = (MCTSNode*)map_pages(MAX_NODES * sizeof(MCTSNode), nodes * sizeof(MCTSNode));
+    node_wins = (float*)map_pages((MAX_NODES + UCB_PAD) * sizeof(float), nodes * sizeof(float));
+    node_visits = (int*)map_pages((MAX_NODES + UCB_PAD) * sizeof(int), nodes * sizeof(int));
+}
+
+// Set up this thread's free lists, GC stack, memory budget and RNG stream
+void init_thread_state(int id) {
+    thread_id = id;
+    gc_stack = new GCBlock[MAX_NODES];
+    cursor_pool = (MoveCursor*)map_pages(MAX_CURSORS * sizeof(MoveCursor), 0);
+    if (TRANSPOSITION_TABLE) init_tt();
+    reset_pool();
+    memory.init(RSS_SOFT_LIMIT_MB, RSS_HARD_LIMIT_MB);
+    seed_rng(id);
+}
+
+void collect_root_stats(const Board& root_state, vector<RootStat>& out) {
+    out.clear();
+    if (tree_root == NO_NODE) return;
+    const MCTSNode& r = node_pool[tree_root];
+    for (int i = 0; i < r.child_count; i++) {
+        int c = r.first_child + i;
+        int visits = node_pool[c].proof == PROOF_WIN ? PROVEN_VISITS
+                   : node_pool[c].proof == PROOF_LOSS ? -PROVEN_VISITS : node_visits[c];
+        RootStat st = { full_move(c, root_state), visits };
+        out.push_back(st);
+    }
+}
+
+void worker_main(int id) {
+    init_thread_state(id);
+    int seen = 0;
+    for (;;) {
+        SearchJob j;
+        {
+            unique_lock<mutex> lk(job_mutex);
+            job_cv.wait(lk, [&] { return job_generation != seen; });
+            seen = job_generation;
+            j = job;
+        }
+        for (const Move& m : j.advance) advance_root(m);
+        search(j.board, j.color, j.turn, j.start, j.timeout);
+        collect_root_stats(j.board, worker_stats[id]);
+        {
+            lock_guard<mutex> lk(job_mutex);
+            workers_done++;
+        }
+        done_cv.notify_one();
+    }
+}
+
+void start_workers() {
+    worker_stats.assign(search_threads, vector<RootStat>());
+    for (int id = 1; id < search_threads; id++) thread(worker_main, id).detach();
+}
+
+// Keep every tree in step with a move that was played
+void advance_all(const Move& m) {
+    advance_root(m);
+    if (search_threads > 1) pending_moves.push_back(m);
+}
+
+// Merge key: the full move, or only the queen step in the two-level tree
+inline int stat_key(const Move& m) {
+    return TWO_LEVEL_TREE ? (m.from << 6 | m.to) : (m.from << 12 | m.to << 6 | m.arrow);
+}
+
+Move parallel_search(const Board& board, int color, int turn, chrono::steady_clock::time_point start, double timeout) {
+    if (search_threads <= 1 || deterministic_search()) return search(board, color, turn, start, timeout);
+    root_solved.store(false);
+    {
+        lock_guard<mutex> lk(job_mutex);
+        job.board = board;
+        job.color = color;
+        job.turn = turn;
+        job.start = start;
+        job.timeout = timeout;
+        job.advance.swap(pending_moves);
+        pending_moves.clear();
+        workers_done = 0;
+        job_generation++;
+    }
+    job_cv.notify_all();
+    search(board, color, turn, start, timeout);
+    collect_root_stats(board, worker_stats[0]);
+    {
+        unique_lock<mutex> lk(job_mutex);
+        done_cv.wait(lk, [] { return workers_done == search_threads - 1; });
+    }
+    
+    static vector<int> total(1 << 18);
+    for (const vector<RootStat>& stats : worker_stats)
+        for (const RootStat& st : stats) total[stat_key(st.move)] = 0;
+    for (const vector<RootStat>& stats : worker_stats)
+        for (const RootStat& st : stats) total[stat_key(st.move)] += st.visits;
+    
+    // Highest merged count; the arrow comes from the tree that searched it most
+    Move best(255, 255, 255); // Invalid move marker if no tree has a child
+    int best_total = -1, best_single = -1;
+    for (const vector<RootStat>& stats : worker_stats) {
+        for (const RootStat& st : stats) {
+            int k = stat_key(st.move);
+            if (total[k] > best_total || (k == stat_key(best) && st.visits > best_single)) {
+                best_total = total[k];
+                best_single = st.visits;
+                best = st.move;
+            }
+        }
+    }
+    return best;
+}
+
+// --- OPENING BOOK ---
+// Positions of the first BOOK_MAX_TURN turns with the move a long search chose
+// there, sorted by canonical hash (init_zobrist's fixed seed keeps the keys
+// stable between builds), so a probe is one binary search. An entry holds the
+// move in the orientation of its canonical hash and serves the mirror image
+// too. A hit is played only if it is legal in the actual position, which also
+// covers hash collisions. The table is written by tools/book_gen.cpp;
+// -DOPENING_BOOK=0 always searches.
+#ifndef OPENING_BOOK
+#define OPENING_BOOK 1
+#endif
+
+const int BOOK_MAX_TURN = 4;
+
+struct BookEntry {
+    uint64_t hash;
+    uint8_t from, to, arrow;
+};
+
+// BEGIN OPENING BOOK
+// tools/book_gen.cpp: 8 plies, width 2, 3 s per position
+constexpr BookEntry BOOK[] = {
+    {0x0007ee428bcf3886ULL, 2, 10, 28},
+    {0x0086c39b48c9b77bULL, 42, 51, 53},
+    {0x00f414a3beb01d9bULL, 20, 11, 14},
+    {0x011bb4638bd9ae6aULL, 25, 43, 25},
+    {0x01417958be760128ULL, 47, 20, 16},
+    {0x01859eed3f3555eaULL, 61, 53, 44},
+    {0x01948025f2b22523ULL, 51, 42, 28},
+    {0x02153a79450c5fb8ULL, 58, 61, 25},
+    {0x030e9baf2196f12bULL, 40, 8, 40},
+    {0x0378f2ad4d791aedULL, 33, 42, 21},
+    {0x038407127e4d6d38ULL, 5, 21, 3},
+    {0x040075a7e5746dc0ULL, 12, 21, 35},
+    {0x05357e3def32ef01ULL, 21, 12, 10},
+    {0x060084a4f5eefe14ULL, 51, 49, 51},
+    {0x0603e2b4ac9b4f1bULL, 54, 49, 51},
+    {0x074f677e694e78d2ULL, 5, 12, 30},
+    {0x07a2f6894a87584aULL, 51, 50, 32},
+    {0x07a433e38a8e576fULL, 47, 38, 2},
+    {0x08701694c4bab5deULL, 20, 18, 2},
+    {0x08a8fe893d6e154aULL, 2, 26, 28},
+    {0x09620e1744ef10feULL, 5, 12, 4},
+    {0x096aa98b2bc02524ULL, 61, 59, 50},
+    {0x09af78b52f7b9f26ULL, 47, 20, 44},
+    {0x09cf12b5c8ca10d5ULL, 23, 14, 28},
+    {0x09e3a4be5d22cf80ULL, 40, 24, 40},
+    {0x0a35a60cc6203e0dULL, 58, 51, 33},
+    {0x0b5839134e8766cbULL, 33, 42, 14},
+    {0x0ba27c4a7f80357bULL, 23, 31, 15},
+    {0x0c14a8537545fa60ULL, 5, 13, 20},
+    {0x0c54677a4337d5b4ULL, 5, 12, 26},
+    {0x0cd22edbcd3e132fULL, 52, 43, 44},
+    {0x0cef632d9046a531ULL, 18, 10, 2},
+    {0x0d330fb8220916ddULL, 44, 42, 10},
+    {0x0f38cac4c3420f0cULL, 52, 54, 53},
+    {0x0f6296c76a29220fULL, 47, 54, 53},
+    {0x0f62f22fde34e3b2ULL, 52, 53, 50},
+    {0x0f799e8f80e54235ULL, 25, 17, 41},
+    {0x10c19e0d3a3715e3ULL, 47, 46, 30},
+    {0x114657b1833c832eULL, 5, 12, 28},
+    {0x11b51002fda07f5fULL, 5, 13, 12},
+    {0x11c75c261a4c77d2ULL, 5, 14, 35},
+    {0x12683b201e961a33ULL, 23, 30, 28},
+    {0x12921264d43afa1dULL, 51, 50, 26},
+    {0x12a56b08be5bc7beULL, 2, 20, 38},
+    {0x12e0c4f9390cf935ULL, 5, 12, 60},
+    {0x13b320c697e7d910ULL, 51, 50, 54},
+    {0x1430d68ce387fab8ULL, 47, 54, 51},
+    {0x1483bbe8d4b70d6bULL, 33, 17, 33},
+    {0x14bcc4c5389792bdULL, 25, 28, 1},
+    {0x14febb4e6ce67d65ULL, 61, 25, 9},
+    {0x161e7fa56dd87b2aULL, 25, 17, 41},
+    {0x174008aa7b1ffaeeULL, 47, 54, 9},
+    {0x17a8ca5bed42abbaULL, 47, 54, 51},
+    {0x18182c389c0fda78ULL, 23, 18, 11},
+    {0x18c8a925f49e1308ULL, 5, 14, 12},
+    {0x195c503e90d7ed32ULL, 61, 59, 62},
+    {0x19def0d2ea7855f7ULL, 8, 9, 10},
+    {0x19fb8ff074df764cULL, 20, 12, 21},
+    {0x1c0afd8f44899beaULL, 13, 12, 36},
+    {0x1c90c2192a122efeULL, 23, 14, 28},
+    {0x1ca952de585a8bc7ULL, 61, 52, 4},
+    {0x1ce69e947b465a73ULL, 5, 19, 1},
+    {0x1dca64cf551f625eULL, 47, 38, 39},
+    {0x1e57ad80a0a6e255ULL, 58, 50, 26},
+    {0x1eb0051287b22063ULL, 33, 34, 50},
+    {0x1ee86923a9440813ULL, 58, 44, 26},
+    {0x1fddf4d626154e51ULL, 58, 42, 60},
+    {0x2092c0d0bcd19f8eULL, 23, 51, 37},
+    {0x212616b7b4188d8fULL, 23, 14, 23},
+    {0x21f0f0d4816dda4cULL, 25, 11, 32},
+    {0x228b984839aada7dULL, 61, 52, 12},
+    {0x22e51d128c258b2dULL, 58, 60, 56},
+    {0x2322f3ae32817b26ULL, 11, 25, 52},
+    {0x239d0850f946dfa8ULL, 61, 25, 49},
+    {0x249dc399dae93f43ULL, 16, 17, 22},
+    {0x24a3eaf42f140467ULL, 47, 55, 15},
+    {0x25517396f8c5db5cULL, 61, 45, 43},
+    {0x260f5f2f50effac9ULL, 5, 12, 13},
+    {0x271c9fb25275baa3ULL, 61, 53, 35},
+    {0x27cf927f39537d2dULL, 13, 20, 36},
+    {0x282bc31f5d2d88fbULL, 16, 32, 16},
+    {0x283742dbcd33f6c6ULL, 58, 60, 46},
+    {0x29a42d51a703e09bULL, 47, 54, 0},
+    {0x2a1752ed40656391ULL, 47, 38, 35},
+    {0x2b0810fbacde85d1ULL, 5, 40, 58},
+    {0x2b9747ef6c0cf14dULL, 23, 14, 9},
+    {0x2c6282f6f1d5895fULL, 25, 17, 41},
+    {0x2d28c2bf9472bcb3ULL, 47, 54, 18},
+    {0x2dfa0557d8ca077aULL, 2, 5, 33},
+    {0x2f794701d341886cULL, 2, 9, 12},
+    {0x3105eeea4f43c6ebULL, 58, 50, 59},
+    {0x31079234a08d4471ULL, 53, 51, 11},
+    {0x31743e903b98b8a5ULL, 61, 52, 34},
+    {0x31853993b63c3ebbULL, 47, 54, 27},
+    {0x3200e24b45f338efULL, 5, 2, 38},
+    {0x320e3180b490bc56ULL, 58, 51, 30},
+    {0x33054c08e634b138ULL, 46, 54, 46},
+    {0x33c00714fe7a763dULL, 2, 20, 60},
+    {0x3467657da275e45cULL, 23, 14, 11},
+    {0x34736e8a57367105ULL, 23, 51, 37},
+    {0x34a9e42eaf6c13e6ULL, 47, 54, 9},
+    {0x35088dc6ef60488eULL, 5, 12, 26},
+    {0x35867d1ef46a40eaULL, 25, 49, 53},
+    {0x35ca3676d353af90ULL, 23, 44, 42},
+    {0x36ef365857537ca0ULL, 33, 40, 49},
+    {0x378c4aae693ae0acULL, 33, 19, 33},
+    {0x3851ce056721c27cULL, 13, 11, 13},
+    {0x39a79c784c8d84ccULL, 25, 41, 34},
+    {0x3af74aabd0470f68ULL, 5, 12, 15},
+    {0x3b9b4030b04c9c88ULL, 5, 21, 19},
+    {0x3bac0dc4ea7e568bULL, 18, 27, 19},
+    {0x3bd8394baf1fe6f0ULL, 21, 35, 32},
+    {0x3d2376a682887015ULL, 20, 17, 44},
+    {0x3d242c8bbcf8df62ULL, 47, 38, 22},
+    {0x3d3573f8fc5da353ULL, 11, 9, 11},
+    {0x3d56151253809cc0ULL, 58, 50, 32},
+    {0x3f84b79892926568ULL, 2, 11, 43},
+    {0x3f9c258c902182a9ULL, 5, 3, 10},
+    {0x401869ff5b7570e7ULL, 25, 34, 38},
+    {0x419f56e39b7879fdULL, 16, 2, 7},
+    {0x41ccd9cda2753364ULL, 5, 3, 17},
+    {0x42dddb987c4bbd0dULL, 20, 12, 28},
+    {0x43d20ed79c626432ULL, 2, 11, 35},
+    {0x441244a6e61e8209ULL, 47, 38, 45},
+    {0x442a38ae8e08ecadULL, 46, 54, 52},
+    {0x44cf57ff92173c4eULL, 20, 18, 10},
+    {0x48649a3f660ea28dULL, 47, 54, 36},
+    {0x486a346ba3bb7a10ULL, 23, 14, 13},
+    {0x4872256c8aa441a2ULL, 23, 37, 23},
+    {0x49416154ff960b9cULL, 61, 52, 48},
+    {0x4a63d6557bdf97efULL, 53, 52, 28},
+    {0x4a6b5be1da92da58ULL, 33, 9, 13},
+    {0x4ab5fad77ef12c29ULL, 2, 4, 12},
+    {0x4b00eb687c70927aULL, 45, 53, 45},
+    {0x4b9a9a3e72d41589ULL, 58, 30, 54},
+    {0x4c75bde3ee072b9bULL, 2, 5, 7},
+    {0x4d2a0e8e9b8a5ef4ULL, 5, 12, 40},
+    {0x4dd07e59e6dd06b9ULL, 61, 53, 50},
+    {0x4e53acc3bc50f529ULL, 2, 9, 16},
+    {0x4ecb3efacfac78b8ULL, 26, 53, 49},
+    {0x4f45069fde77f727ULL, 51, 60, 51},
+    {0x4f5a62414f5a6241ULL, 16, 22, 46},
+    {0x4f6c5fbf5139e5f1ULL, 13, 12, 10},
+    {0x4fb1dac4773b78bbULL, 58, 50, 26},
+    {0x505c9ee28bc4b190ULL, 16, 21, 61},
+    {0x5192e655cdfac383ULL, 2, 4, 12},
+    {0x52ae73776ff88a63ULL, 4, 22, 14},
+    {0x52cdc88a9e9486b4ULL, 5, 4, 18},
+    {0x548b19dc9e3fb35bULL, 23, 44, 41},
+    {0x54e0f6a7592fe74fULL, 23, 14, 13},
+    {0x54f27d27f147c652ULL, 23, 14, 49},
+    {0x558f551dcb7f0db7ULL, 47, 20, 17},
+    {0x559eb95ce6184da5ULL, 61, 53, 50},
+    {0x55a07a49b853d6b9ULL, 5, 13, 5},
+    {0x56efcc0bcca50b56ULL, 58, 60, 12},
+    {0x56f57baafcd6f667ULL, 54, 53, 49},
+    {0x57c8a8839d039b1aULL, 40, 45, 27},
+    {0x59ded4cefe4c4cc1ULL, 5, 13, 20},
+    {0x59f17ad47efbbb09ULL, 23, 51, 11},
+    {0x5a0d3073ccfac90fULL, 23, 14, 21},
+    {0x5b3612ddc7675a6cULL, 45, 53, 45},
+    {0x5bf332da637990a5ULL, 11, 9, 11},
+    {0x5d63f183612daf97ULL, 16, 40, 32},
+    {0x5feb1c639a3d74e9ULL, 5, 21, 39},
+    {0x6073a78b9e6ed3d1ULL, 18, 27, 19},
+    {0x621d4a9e6cc21588ULL, 58, 51, 55},
+    {0x6272547a9ef704c1ULL, 14, 9, 8},
+    {0x644a50299f81abe2ULL, 47, 11, 35},
+    {0x65184800d5793c36ULL, 47, 54, 51},
+    {0x656a60d198d16e15ULL, 40, 46, 41},
+    {0x68a770706a98062eULL, 23, 30, 28},
+    {0x68c101f492a681eeULL, 21, 12, 19},
+    {0x68ea8e71c57d5e17ULL, 23, 14, 28},
+    {0x698f7271be373f2bULL, 47, 20, 17},
+    {0x6a1b82c6c434eec1ULL, 47, 54, 53},
+    {0x6b54cacaf8b29108ULL, 18, 50, 34},
+    {0x6bbe7574f1ff342bULL, 25, 41, 59},
+    {0x6db305e79044e084ULL, 23, 22, 17},
+    {0x702c18a6f38ef484ULL, 20, 11, 13},
+    {0x7165c945a7f734f5ULL, 40, 41, 27},
+    {0x7183aa11c831ede2ULL, 40, 49, 35},
+    {0x7184bee1b86ed9e1ULL, 12, 14, 12},
+    {0x71acbb94a5422b1aULL, 33, 26, 30},
+    {0x74a88a5e8f9d9e46ULL, 33, 19, 17},
+    {0x75859a90a46b3190ULL, 19, 12, 4},
+    {0x771015b8de64918dULL, 58, 60, 39},
+    {0x77208f22bcd57c55ULL, 61, 45, 41},
+    {0x774b0e55f601a88cULL, 33, 17, 33},
+    {0x78fdeba097811254ULL, 16, 32, 33},
+    {0x7951e9fc97c46ab0ULL, 21, 17, 21},
+    {0x798f6bca8deccec3ULL, 25, 32, 50},
+    {0x7bd417fde861f272ULL, 47, 54, 27},
+    {0x7ccee1a6c2b45ffdULL, 5, 3, 17},
+    {0x81b68f3f885759ceULL, 2, 20, 13},
+    {0x824133199e034e12ULL, 25, 17, 20},
+    {0x830313d5abafb9d4ULL, 51, 19, 21},
+    {0x8341b49887d610c4ULL, 2, 5, 23},
+    {0x83c539edeafc763aULL, 58, 61, 25},
+    {0x84d12b73c7b9be0dULL, 42, 50, 53},
+    {0x871c11d3f320a48aULL, 33, 19, 16},
+    {0x8bbe5049e54f718cULL, 14, 13, 10},
+    {0x8c46ab1af3f400ccULL, 58, 60, 46},
+    {0x8c854566e286ecbaULL, 61, 53, 48},
+    {0x8e5896b9a29a088aULL, 40, 41, 34},
+    {0x9012ceecd4d816fdULL, 2, 4, 52},
+    {0x91755ab0962c4fd4ULL, 40, 41, 47},
+    {0x9313662eb3aa2a6cULL, 5, 12, 28},
+    {0x93b6d678a6368ef9ULL, 2, 11, 15},
+    {0x954ea135f36d2f77ULL, 23, 14, 13},
+    {0x95f5e656ad1d3fdcULL, 61, 52, 50},
+    {0x96e1d791bdce7b3cULL, 52, 53, 50},
+    {0x9aa8b58ce8db300fULL, 2, 11, 13},
+    {0x9aa974bafadbb898ULL, 22, 14, 12},
+    {0x9aab6722aea076f4ULL, 40, 41, 20},
+    {0x9b299c49f20c213dULL, 47, 38, 2},
+    {0x9c58f05abe90d5dfULL, 40, 41, 20},
+    {0x9c87dfe4db05e5d9ULL, 33, 34, 50},
+    {0x9cbe930ed1560cc8ULL, 40, 49, 48},
+    {0x9e20fdb2e8a3fa23ULL, 61, 13, 48},
+    {0x9feae73be21923cfULL, 5, 3, 17},
+    {0xa0904d92b99c85bdULL, 47, 20, 18},
+    {0xa0d2c7e4d0924e97ULL, 58, 60, 12},
+    {0xa0ed4746ffbae793ULL, 61, 54, 50},
+    {0xa2659c44c87d6b09ULL, 61, 53, 52},
+    {0xa83d4b6ad75fca21ULL, 14, 49, 35},
+    {0xa8890b90a8b361f9ULL, 23, 14, 42},
+    {0xab7f5b44c29f38c8ULL, 5, 12, 4},
+    {0xaf4734acf16ad3c6ULL, 61, 53, 52},
+    {0xb0316b58d2fea2ffULL, 2, 18, 21},
+    {0xb242c388ddcdd155ULL, 51, 50, 34},
+    {0xb243cad1fadb11dbULL, 61, 59, 41},
+    {0xb5fdd55bda872758ULL, 58, 61, 25},
+    {0xb8d64296cc15432eULL, 5, 12, 13},
+    {0xbaa79806c7f7b24aULL, 2, 38, 33},
+    {0xbb388459d91f3b8fULL, 16, 21, 12},
+    {0xbb8c448ef01128daULL, 59, 11, 51},
+    {0xbdc45528eaf3d4a8ULL, 47, 46, 41},
+    {0xbe573f84bf8c3fd1ULL, 61, 53, 44},
+    {0xbecc02b3d01a8b61ULL, 58, 50, 32},
+    {0xbfce4e41cdf3e9a0ULL, 51, 54, 36},
+    {0xc50fbc35f425c1f4ULL, 61, 52, 53},
+    {0xc599c844fc330936ULL, 61, 63, 15},
+    {0xc7ff8ff3deaa11ebULL, 23, 30, 39},
+    {0xc8284674fdd4b6d0ULL, 47, 54, 55},
+    {0xc86309d1f52b1ea2ULL, 58, 49, 40},
+    {0xca146b2bdb7b49f1ULL, 25, 26, 8},
+    {0xca5dee9dff0cbfaaULL, 61, 53, 44},
+    {0xcfb16816da7f8d7dULL, 18, 20, 41},
+    {0xd1e64dafd7efe2dfULL, 45, 52, 53},
+    {0xda6b6d75fd61aca8ULL, 23, 51, 53},
+    {0xdbf127b2fa3f0648ULL, 58, 50, 55},
+    {0xdebfab72fc594a75ULL, 23, 14, 28},
+    {0xe794b3bde7dea119ULL, 25, 34, 10},
+    {0xea251d0dfdbefff8ULL, 47, 54, 51},
+    {0xf12ddd79f14afb37ULL, 61, 13, 15},
+};
+// END OPENING BOOK
+
+const int BOOK_SIZE = sizeof(BOOK) / sizeof(BOOK[0]);
+
+// The book move for board if it has one among the legal moves
+bool probe_book(const Board& board, const Move* moves, int count, Move& out) {
+    uint64_t key = canonical_hash(board.hash);
+    const BookEntry* e = lower_bound(BOOK, BOOK + BOOK_SIZE, key,
+                                     [](const BookEntry& a, uint64_t h) { return a.hash < h; });
+    if (e == BOOK + BOOK_SIZE || e->hash != key) return false;
+    Move m(e->from, e->to, e->arrow);
+    if (key != board.hash) m = mirror_move(m);
+    for (int i = 0; i < count; i++) {
+        if (moves[i] == m) {
+            out = m;
+            return true;
+        }
+    }
+    return false;
+}
+
+// --- MOVE CHOICE ---
+// A forced, book or proved endgame move if there is one, else the configured backend
+Move choose_move(const Board& board, int color, int turn, chrono::steady_clock::time_point start, double timeout) {
+    static Move root_moves[MAX_MOVES];
+    int root_count = generate_moves(board, color, root_moves);
+    if (EARLY_STOP && root_count <= 1) {
+        STATS(memset(&search_stats, 0, sizeof(search_stats)));
+        STATS(search_stats.stop = STOP_DECIDED);
+        STATS(report_search_stats(turn, "forced", start, 0));
+        return root_count ? root_moves[0] : Move(255, 255, 255);
+    }
+    Move book;
+    if (OPENING_BOOK && turn <= BOOK_MAX_TURN && probe_book(board, root_moves, root_count, book)) {
+        STATS(memset(&search_stats, 0, sizeof(search_stats)));
+        STATS(report_search_stats(turn, "book", start, 0));
+        return book;
+    }
+    Move solved;
+    if (ENDGAME_SOLVER && solve_endgame(board, color, start, timeout * ENDGAME_TIME_SHARE, solved)) {
+        STATS(memset(&search_stats, 0, sizeof(search_stats)));
+        STATS(search_stats.stop = STOP_SOLVED);
+        STATS(report_search_stats(turn, "solver", start, 0));
+        return solved;
+    }
+    if (search_engine != ENGINE_MCTS) {
+        if (search_engine == ENGINE_PVS || root_count <= HYBRID_MAX_MOVES) {
+            if (!pvs_engine) pvs_engine = new PVSEngine;
+            Move m = pvs_engine->search(board, color, turn, start, timeout);
+            STATS(memset(&search_stats, 0, sizeof(search_stats)));
+            STATS(report_search_stats(turn, "pvs", start, 0));
+            return m;
+        }
+    }
+    return parallel_search(board, color, turn, start, timeout);
+}
+
+// --- BOTZONE I/O ---
+// Requests are parsed in place out of a fixed buffer filled by read(0) and
+// moves are applied as their lines come in; replies are formatted into a
+// char array and go out in one write(1). No strings, streams or heap, and
+// neither cin nor cout is used, so nothing else buffers fd 0 or fd 1.
+class RequestReader {
+public:
+    // Integers of the next line into c, keeping the first max; -1 at end of input
+    int read_line(int* c, int max) {
+        int n = 0;
+        for (;;) {
+            int ch = next_char();
+            if (ch < 0) return n ? n : -1;
+            if (ch == '\n') return n;
+            if (ch != '-' && (ch < '0' || ch > '9')) continue; // Spaces and \r
+            bool negative = ch == '-';
+            int v = negative ? 0 : ch - '0';
+            while ((ch = peek_char()) >= '0' && ch <= '9') {
+                v = v * 10 + ch - '0';
+                pos++;
+            }
+            if (n < max) c[n++] = negative ? -v : v;
+        }
+    }
+    
+private:
+    char buf[1 << 16];
+    int pos = 0, len = 0;
+    
+    bool fill() {
+        ssize_t r;
+        do r = read(0, buf, sizeof(buf));
+        while (r < 0 && errno == EINTR);
+        if (r <= 0) return false;
+        pos = 0;
+        len = (int)r;
+        return true;
+    }
+    inline int next_char() {
+        if (pos == len && !fill()) return -1;
+        return (unsigned char)buf[pos++];
+    }
+    inline int peek_char() {
+        if (pos == len && !fill()) return -1;
+        return (unsigned char)buf[pos];
+    }
+};
+
+RequestReader request_reader;
+
+// A line of six coordinates "x0 y0 x1 y1 x2 y2" as a move; false for the
+// "-1 ..." first-move marker and for the bare turn-number lines
+inline bool line_move(const int* c, int n, Move& m) {
+    if (n != 6 || c[0] == -1) return false;
+    // Convert coordinates to square indices
+    m = Move(c[0] * 8 + c[1], c[2] * 8 + c[3], c[4] * 8 + c[5]);
+    return true;
+}
+
+void write_out(const char* s, size_t n) {
+    while (n) {
+        ssize_t w = write(1, s, n);
+        if (w < 0 && errno == EINTR) continue;
+        if (w <= 0) return;
+        s += w;
+        n -= (size_t)w;
+    }
+}
+
+// Print a move in Botzone coordinates; returns false for the no-move marker
+bool print_move(const Move& best) {
+    if (best.from == 255) {
+        write_out("-1 -1 -1 -1 -1 -1\n", 18);
+        return false;
+    }
+    // Convert square indices back to coordinates, one digit each
+    const int sq[3] = { best.from, best.to, best.arrow };
+    char out[12];
+    for (int k = 0; k < 3; k++) {
+        out[4 * k] = (char)('0' + sq[k] / 8);
+        out[4 * k + 1] = ' ';
+        out[4 * k + 2] = (char)('0' + sq[k] % 8);
+        out[4 * k + 3] = ' ';
+    }
+    out[11] = '\n';
+    write_out(out, sizeof(out));
+    return true;
+}
+
+// --- PONDERING ---
+// Long-running mode only. Once our move is out a reader thread owns stdin and
+// the main thread keeps searching the tree from the opponent's side until the
+// reply arrives; the reply then advances the root as usual, so the next turn
+// starts on the subtree grown in the meantime. The reader notes when the reply
+// arrived, which is when Botzone starts our clock. Helper search threads do not
+// ponder. -DPONDER=0 waits idle as before.
+#ifndef PONDER
+#define PONDER 1
+#endif
+
+const double PONDER_MAX_SECONDS = 30; // Memory limits usually end a ponder first
+
+struct Reply {
+    mutex lock;
+    condition_variable arrived_cv;
+    bool ready = false, eof = false;
+    Move move;
+    chrono::steady_clock::time_point arrived;
+};
+
+Reply& reply = *new Reply; // Never destroyed: the reader may still be in read() at exit
+
+void input_reader() {
+    int c[6], n;
+    while ((n = request_reader.read_line(c, 6)) >= 0) {
+        Move m;
+        if (!line_move(c, n, m)) continue;
+        {
+            lock_guard<mutex> lk(reply.lock);
+            reply.move = m;
+            reply.arrived = chrono::steady_clock::now();
+            reply.ready = true;
+        }
+        reply_pending.store(true);
+        reply.arrived_cv.notify_one();
+    }
+    {
+        lock_guard<mutex> lk(reply.lock);
+        reply.eof = true;
+    }
+    reply_pending.store(true);
+    reply.arrived_cv.notify_one();
+}
+
+// Ponder on board (opponent to move) until the opponent's reply is in; false at end of input
+bool await_reply(const Board& board, int color, int turn, Move& m, chrono::steady_clock::time_point& arrived) {
+    if (PONDER && search_engine == ENGINE_MCTS && !reply_pending.load()) {
+        pondering = true;
+        search(board, color, turn, chrono::steady_clock::now(), PONDER_MAX_SECONDS);
+        pondering = false;
+    }
+    unique_lock<mutex> lk(reply.lock);
+    reply.arrived_cv.wait(lk, [] { return reply.ready || reply.eof; });
+    if (!reply.ready) return false;
+    m = reply.move;
+    arrived = reply.arrived;
+    reply.ready = false;
+    reply_pending.store(false);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    auto start_time = chrono::steady_clock::now();
+    
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--threads") == 0) search_threads = min(max(1, atoi(argv[i + 1])), MAX_SEARCH_THREADS);
+        if (strcmp(argv[i], "--engine") == 0) {
+            if (strcmp(argv[i + 1], "mcts") == 0) search_engine = ENGINE_MCTS;
+            else if (strcmp(argv[i + 1], "pvs") == 0) search_engine = ENGINE_PVS;
+            else if (strcmp(argv[i + 1], "hybrid") == 0) search_engine = ENGINE_HYBRID;
+        }
+    }
+    
+    init_zobrist();
+    init_ucb_tables();
+    init_widening();
+    init_cpu_dispatch();
+    init_arena();
+    init_thread_state(0);
+    start_workers();
+    
+    Board board;
+    int c[6];
+    if (request_reader.read_line(c, 6) < 1) return 0;
+    int turn = c[0];
+    
+    // 2 * turn - 1 move lines; black's first one is the "-1 ..." marker
+    int my_color = WHITE;
+    for (int i = 0; i < 2 * turn - 1; i++) {
+        int n = request_reader.read_line(c, 6);
+        if (n < 0) break;
+        if (i == 0 && n > 0 && c[0] == -1) my_color = BLACK;
+        Move m;
+        if (line_move(c, n, m)) board.apply_move(m);
+    }
+    
+    double limit = (turn == 1) ? 1.96 : 0.98;
+    Move best = choose_move(board, my_color, turn, start_time, limit);
+    if (!print_move(best)) return 0;
+    if (!LONG_RUNNING) return 0;
+    
+    // Long-running mode: only the opponent's reply arrives from now on
+    thread(input_reader).detach();
+    while (true) {
+        board.apply_move(best);
+        advance_all(best);
+        static const char KEEP_RUNNING[] = ">>>BOTZONE_REQUEST_KEEP_RUNNING<<<\n";
+        write_out(KEEP_RUNNING, sizeof(KEEP_RUNNING) - 1);
+        
+        // Botzone starts our clock when the request is delivered
+        Move opp;
+        if (!await_reply(board, -my_color, turn, opp, start_time)) return 0;
+        board.apply_move(opp);
+        advance_all(opp);
+        turn++;
+        
+        best = choose_move(board, my_color, turn, start_time, 0.98);
+        if (!print_move(best)) return 0;
+    }
+}
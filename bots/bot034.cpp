@@ -0,0 +1,820 @@
+// Generated by scripts/utils/amalgamate.py from engine/bots/bot034.cpp - do not edit
+// bot034 - bitboard MCTS built from the engine core (engine/*.h)
+// BitBoard, bot033's five-term TerritoryEval and the scheduled UCB1 with
+// progressive widening. Botzone needs one file: bots/bot034.cpp is generated by
+//     python3 scripts/utils/amalgamate.py engine/bots/bot034.cpp bots/bot034.cpp
+// ---- begin botzone.h ----
+// botzone.h - Botzone traditional protocol with long-running mode for any core engine
+// EngineT needs play(Move) and think(deadline); see mcts.h.
+#ifndef AMAZONS_BOTZONE_H
+#define AMAZONS_BOTZONE_H
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// ---- begin board.h ----
+// board.h - bitboard geometry, Move and the BitBoard board policy
+// Square index is row * 8 + col, bit i of a bitboard is square i.
+//
+// A board policy for Engine<> (mcts.h) provides:
+//   Board()                               start position
+//   static int side(int color)            0 for BLACK, 1 for WHITE
+//   void apply(const Move& m)             queen step and arrow
+//   int generate(int color, Move* out)    every legal move, out holds MAX_MOVES
+//   bool can_move(int color)              false when color has lost
+// BitBoard is below; occupancy.h has opponent.cpp's layout, OccupancyBoard.
+#ifndef AMAZONS_BOARD_H
+#define AMAZONS_BOARD_H
+
+#include <cstdint>
+#include <cstring>
+
+namespace amazons {
+
+const int NUM_SQUARES = 64;
+const int BLACK = 1;
+const int WHITE = -1;
+const int MAX_MOVES = 4 * 27 * 27;
+
+// 2D Directions for row,col movement: N, S, W, E, NW, NE, SW, SE
+constexpr int DIRECTIONS[8][2] = {
+    {-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {-1, 1}, {1, -1}, {1, 1}
+};
+
+#pragma pack(push, 1)
+struct Move {
+    uint8_t from, to, arrow;
+
+    Move() = default;
+    Move(int from_sq, int to_sq, int arrow_sq) : from(from_sq), to(to_sq), arrow(arrow_sq) {}
+
+    bool operator==(const Move& o) const {
+        return from == o.from && to == o.to && arrow == o.arrow;
+    }
+};
+#pragma pack(pop)
+static_assert(sizeof(Move) == 3, "Move must be 3 bytes");
+
+const Move NO_MOVE(255, 255, 255);
+
+inline int popcount(uint64_t b) {
+    return __builtin_popcountll(b);
+}
+
+inline int lsb_index(uint64_t b) {
+    return __builtin_ctzll(b);
+}
+
+inline int msb_index(uint64_t b) {
+    return 63 - __builtin_clzll(b);
+}
+
+inline uint64_t clear_lsb(uint64_t b) {
+    return b & (b - 1);
+}
+
+// --- GEOMETRY TABLES ---
+// Built by the compiler, as in bot033: SquareTable<T> is an array indexed by
+// square that a C++11 constexpr function can return.
+template <typename T>
+struct SquareTable {
+    T v[NUM_SQUARES];
+    constexpr const T& operator[](int sq) const { return v[sq]; }
+};
+
+template <int... S> struct SquareList {};
+template <int N, int... S> struct MakeSquares : MakeSquares<N - 1, N - 1, S...> {};
+template <int... S> struct MakeSquares<0, S...> { typedef SquareList<S...> type; };
+typedef MakeSquares<NUM_SQUARES>::type Squares;
+
+constexpr bool on_board(int r, int c) {
+    return r >= 0 && r < 8 && c >= 0 && c < 8;
+}
+
+constexpr uint64_t ray_from(int r, int c, int dr, int dc) {
+    return on_board(r + dr, c + dc) ? (1ULL << ((r + dr) * 8 + c + dc)) | ray_from(r + dr, c + dc, dr, dc) : 0;
+}
+
+template <int... S>
+constexpr SquareTable<uint64_t> make_rays(int d, SquareList<S...>) {
+    return SquareTable<uint64_t>{ { ray_from(S / 8, S % 8, DIRECTIONS[d][0], DIRECTIONS[d][1])... } };
+}
+
+// RAYS[d][sq]: every square reachable from sq in direction d on an empty board (sq excluded)
+constexpr SquareTable<uint64_t> RAYS[8] = {
+    make_rays(0, Squares()), make_rays(1, Squares()), make_rays(2, Squares()), make_rays(3, Squares()),
+    make_rays(4, Squares()), make_rays(5, Squares()), make_rays(6, Squares()), make_rays(7, Squares())
+};
+
+// Directions that step towards higher square indices (S, E, SW, SE)
+constexpr bool RAY_POSITIVE[8] = { false, true, false, true, false, false, true, true };
+
+// Squares a queen on sq can slide to, stopping before the first occupied square
+inline uint64_t queen_attacks(int sq, uint64_t occ) {
+    uint64_t attacks = 0;
+    for (int d = 0; d < 8; d++) {
+        uint64_t ray = RAYS[d][sq];
+        uint64_t blockers = ray & occ;
+        if (blockers) {
+            int b = RAY_POSITIVE[d] ? lsb_index(blockers) : msb_index(blockers);
+            ray ^= RAYS[d][b] | (1ULL << b);
+        }
+        attacks |= ray;
+    }
+    return attacks;
+}
+
+// One king step in all 8 directions (destination masks stop file wrap-around)
+inline uint64_t king_step(uint64_t b) {
+    const uint64_t NOT_COL0 = 0xfefefefefefefefeULL, NOT_COL7 = 0x7f7f7f7f7f7f7f7fULL;
+    uint64_t h = b | ((b >> 1) & NOT_COL7) | ((b << 1) & NOT_COL0);
+    return h | (h << 8) | (h >> 8);
+}
+
+// --- BITBOARD BOARD ---
+// One bitboard per color plus the arrows (bot033's layout)
+struct BitBoard {
+    uint64_t pieces[2]; // [0] = BLACK, [1] = WHITE
+    uint64_t arrows;
+
+    BitBoard() {
+        pieces[0] = pieces[1] = arrows = 0;
+        const int black[4] = { 2, 16, 40, 58 }, white[4] = { 5, 23, 47, 61 };
+        for (int k = 0; k < 4; k++) {
+            pieces[0] |= 1ULL << black[k];
+            pieces[1] |= 1ULL << white[k];
+        }
+    }
+
+    static inline int side(int color) {
+        return color == BLACK ? 0 : 1;
+    }
+
+    inline uint64_t occupied() const {
+        return pieces[0] | pieces[1] | arrows;
+    }
+
+    inline void apply(const Move& m) {
+        uint64_t from = 1ULL << m.from;
+        int s = (pieces[0] & from) ? 0 : 1;
+        pieces[s] ^= from | (1ULL << m.to);
+        arrows |= 1ULL << m.arrow;
+    }
+
+    int generate(int color, Move* out) const {
+        uint64_t occ = occupied();
+        int n = 0;
+        for (uint64_t p = pieces[side(color)]; p; p = clear_lsb(p)) {
+            int from = lsb_index(p);
+            for (uint64_t d = queen_attacks(from, occ); d; d = clear_lsb(d)) {
+                int to = lsb_index(d);
+                uint64_t after = (occ ^ (1ULL << from)) | (1ULL << to);
+                for (uint64_t s = queen_attacks(to, after); s; s = clear_lsb(s)) out[n++] = Move(from, to, lsb_index(s));
+            }
+        }
+        return n;
+    }
+
+    // Any queen step leaves a square to shoot back into, so a free neighbour is enough
+    inline bool can_move(int color) const {
+        return (king_step(pieces[side(color)]) & ~occupied()) != 0;
+    }
+};
+
+} // namespace amazons
+
+#endif
+// ---- end board.h ----
+
+namespace amazons {
+
+// Parse "x0 y0 x1 y1 x2 y2"; false for lines that are not a move
+inline bool parse_move(const std::string& l, Move& m) {
+    std::stringstream ss(l);
+    int c[6];
+    for (int k = 0; k < 6; ++k) {
+        if (!(ss >> c[k])) return false;
+    }
+    if (c[0] == -1) return false;
+    m = Move(c[0] * 8 + c[1], c[2] * 8 + c[3], c[4] * 8 + c[5]);
+    return true;
+}
+
+// Print a move in Botzone coordinates; false for NO_MOVE
+inline bool print_move(const Move& m) {
+    if (m.from == 255) {
+        std::cout << "-1 -1 -1 -1 -1 -1" << std::endl;
+        return false;
+    }
+    std::cout << m.from / 8 << " " << m.from % 8 << " " << m.to / 8 << " " << m.to % 8 << " "
+              << m.arrow / 8 << " " << m.arrow % 8 << std::endl;
+    return true;
+}
+
+// Play one Botzone game on stdin/stdout. Limits are seconds per turn measured
+// from the arrival of the request (from process start on the first turn).
+template <class EngineT>
+int run_botzone(double first_limit = 1.96, double limit = 0.98, bool long_running = true) {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
+    static EngineT engine; // Pools are far too large for the stack
+    std::string line;
+    if (!std::getline(std::cin, line)) return 0;
+    int turn = std::stoi(line);
+    for (int i = 0; i < 2 * turn - 1; i++) {
+        Move m;
+        if (!std::getline(std::cin, line)) return 0;
+        if (parse_move(line, m)) engine.play(m);
+    }
+
+    double budget = turn == 1 ? first_limit : limit;
+    for (;;) {
+        Clock::time_point deadline = start + std::chrono::duration_cast<Clock::duration>(
+                                                 std::chrono::duration<double>(budget));
+        Move best = engine.think(deadline);
+        if (!print_move(best)) return 0;
+        if (!long_running) return 0;
+        engine.play(best);
+        std::cout << ">>>BOTZONE_REQUEST_KEEP_RUNNING<<<" << std::endl;
+
+        Move opp;
+        bool found = false;
+        while (!found) {
+            if (!std::getline(std::cin, line)) return 0;
+            found = parse_move(line, opp); // Skips the bare turn-number lines
+        }
+        start = Clock::now();
+        engine.play(opp);
+        budget = limit;
+    }
+}
+
+} // namespace amazons
+
+#endif
+// ---- end botzone.h ----
+// ---- begin mcts.h ----
+// mcts.h - header-only MCTS core templated on board, evaluator and policy
+// Engine<Board, Eval, Policy, Config> is one search specialized at compile time:
+// every call into the policies is static and inlined, nothing in the per-
+// iteration loop is virtual. See board.h, eval.h and policy.h for what each
+// parameter provides; Config fixes the pool size and the limits.
+//
+// Nodes are structure-of-arrays in one bump-allocated pool. A node's children
+// form one contiguous block that doubles (is copied to a new block twice the
+// size) when it fills; no move lists are stored: an expansion regenerates the
+// node's moves and draws one that is not a child yet. Descent records its path,
+// so nodes keep no parent index and blocks can move freely. The clock and the
+// RSS are checked every Config::CHECK_INTERVAL iterations.
+// Tree reuse: play() moves the root to the matching child. The pool is not
+// compacted; when it is three quarters full a turn starts from a fresh tree.
+// Phases: Eval and Policy may be SwitchAt<TURN, Before, After> schedules.
+// think() resolves them for its turn once and runs the search loop compiled for
+// that evaluator and policy, so the hot loop never looks at the turn; the tree
+// carries over a switch.
+#ifndef AMAZONS_MCTS_H
+#define AMAZONS_MCTS_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+
+// ---- begin board.h ----
+// ---- end board.h ----
+// ---- begin eval.h ----
+// eval.h - evaluator policies over BitBoard
+// An evaluator for Engine<> provides
+//   static double evaluate(const Board& b, int color, int turn)
+// returning the probability in [0, 1] that color wins the position.
+#ifndef AMAZONS_EVAL_H
+#define AMAZONS_EVAL_H
+
+#include <cmath>
+
+// ---- begin board.h ----
+// ---- end board.h ----
+
+namespace amazons {
+
+inline double fast_sigmoid(double x) {
+    return 0.5 * (x / (1.0 + std::abs(x)) + 1.0);
+}
+
+// Squares reached by sliding from any of srcs through empty squares in 8
+// directions, by Kogge-Stone occluded fills (bot033's queen_fill_scalar)
+inline uint64_t queen_fill(uint64_t srcs, uint64_t empty) {
+    static const uint64_t SHIFT[4] = { 1, 7, 8, 9 };
+    static const uint64_t MASK_UP[4] = { 0xfefefefefefefefeULL, 0x7f7f7f7f7f7f7f7fULL, ~0ULL, 0xfefefefefefefefeULL };
+    static const uint64_t MASK_DOWN[4] = { 0x7f7f7f7f7f7f7f7fULL, 0xfefefefefefefefeULL, ~0ULL, 0x7f7f7f7f7f7f7f7fULL };
+    uint64_t reach = 0;
+    for (int k = 0; k < 4; k++) {
+        uint64_t s = SHIFT[k];
+        uint64_t gen = srcs, pro = empty & MASK_UP[k];
+        gen |= pro & (gen << s); pro &= pro << s;
+        gen |= pro & (gen << 2 * s); pro &= pro << 2 * s;
+        gen |= pro & (gen << 4 * s);
+        reach |= gen;
+        gen = srcs; pro = empty & MASK_DOWN[k];
+        gen |= pro & (gen >> s); pro &= pro >> s;
+        gen |= pro & (gen >> 2 * s); pro &= pro >> 2 * s;
+        gen |= pro & (gen >> 4 * s);
+        reach |= gen;
+    }
+    return reach & empty;
+}
+
+// Layered BFS from srcs; returns the number of layers (layers[0] = srcs)
+template <bool QUEEN>
+inline int distance_layers(uint64_t srcs, uint64_t empty, uint64_t* layers) {
+    uint64_t seen = srcs, front = srcs;
+    int n = 0;
+    layers[n++] = srcs;
+    for (;;) {
+        front = (QUEEN ? queen_fill(front, empty) : king_step(front) & empty) & ~seen;
+        if (!front) return n;
+        seen |= front;
+        layers[n++] = front;
+    }
+}
+
+// Squares strictly closer to me minus squares strictly closer to the opponent;
+// kt, if given, also gets the sum of (4 - d) over those squares with d < 4
+inline int territory(const uint64_t* my, int n_my, const uint64_t* op, int n_op, int* kt) {
+    uint64_t reach_my = my[0], reach_op = op[0];
+    int t = 0;
+    for (int d = 1; d < n_my || d < n_op; d++) {
+        uint64_t m = d < n_my ? my[d] : 0;
+        uint64_t o = d < n_op ? op[d] : 0;
+        int diff = popcount(m & ~(reach_op | o)) - popcount(o & ~(reach_my | m));
+        reach_my |= m;
+        reach_op |= o;
+        t += diff;
+        if (kt && d < 4) *kt += (4 - d) * diff;
+    }
+    return t;
+}
+
+inline int mobility(uint64_t pieces, uint64_t occ) {
+    int mob = 0;
+    for (uint64_t p = pieces; p; p = clear_lsb(p)) mob += popcount(queen_attacks(lsb_index(p), occ));
+    return mob;
+}
+
+// Weights of the five terms by turn (row turn - 1, the last row from turn 28
+// on): opponent.cpp's table, shared by every evaluator built on those terms
+const double TURN_WEIGHTS[28][5] = {
+    { 0.07747, 0.05755, 0.64627, 0.70431, 0.02438 }, { 0.05093, 0.06276, 0.69898, 0.66192, 0.02362 },
+    { 0.06036, 0.06253, 0.60094, 0.67719, 0.01873 }, { 0.07597, 0.06952, 0.69061, 0.67989, 0.02098 },
+    { 0.08083, 0.08815, 0.58981, 0.54664, 0.02318 }, { 0.09155, 0.08397, 0.56392, 0.54319, 0.02317 },
+    { 0.10653, 0.10479, 0.54840, 0.53023, 0.02084 }, { 0.11534, 0.11515, 0.53325, 0.52423, 0.02237 },
+    { 0.12943, 0.12673, 0.50841, 0.52208, 0.02490 }, { 0.12882, 0.13946, 0.49621, 0.51776, 0.03045 },
+    { 0.13701, 0.15338, 0.47601, 0.51500, 0.03249 }, { 0.14530, 0.15565, 0.45365, 0.50934, 0.03830 },
+    { 0.14521, 0.16388, 0.44531, 0.50517, 0.04864 }, { 0.13750, 0.16326, 0.43619, 0.50328, 0.05912 },
+    { 0.13565, 0.15529, 0.42382, 0.50288, 0.07437 }, { 0.12382, 0.10361, 0.50487, 0.55808, 0.02791 },
+    { 0.11809, 0.14632, 0.40738, 0.41782, 0.10308 }, { 0.10805, 0.15043, 0.40520, 0.43073, 0.10967 },
+    { 0.09668, 0.15666, 0.40215, 0.44165, 0.10906 }, { 0.10585, 0.16319, 0.38220, 0.45465, 0.10062 },
+    { 0.11123, 0.15516, 0.36904, 0.46534, 0.09118 }, { 0.12535, 0.10492, 0.35567, 0.48043, 0.08337 },
+    { 0.28657, 0.16655, 0.38060, 0.42472, 0.10316 }, { 0.07143, 0.16655, 0.36658, 0.39520, 0.02194 },
+    { 0.07143, 0.16655, 0.36658, 0.39520, 0.02194 }, { 0.07143, 0.16655, 0.36658, 0.39520, 0.02194 },
+    { 0.07143, 0.16655, 0.36658, 0.39520, 0.02194 }, { 0.07143, 0.14627, 0.36658, 0.39520, 0.02194 }
+};
+
+// Queen moves available to color minus the opponent's, squashed
+struct MobilityEval {
+    static double evaluate(const BitBoard& b, int color, int turn) {
+        (void)turn;
+        uint64_t occ = b.occupied();
+        int diff = mobility(b.pieces[BitBoard::side(color)], occ) - mobility(b.pieces[BitBoard::side(-color)], occ);
+        return fast_sigmoid(diff * 0.02);
+    }
+};
+
+// bot033's five-term evaluation: queen territory, king territory, queen and
+// king position, mobility, weighted by turn
+struct TerritoryEval {
+    static double evaluate(const BitBoard& b, int color, int turn) {
+        static const double POW2[] = { 0, 0.5, 0.25, 0.125, 0.0625, 0.03125, 0.015625, 0.0078125, 0.00390625 };
+        static const double INV[] = { 1.0, 1.0 / 2, 1.0 / 3, 1.0 / 4, 1.0 / 5, 1.0 / 6 };
+
+        uint64_t empty = ~b.occupied();
+        uint64_t my_bb = b.pieces[BitBoard::side(color)], op_bb = b.pieces[BitBoard::side(-color)];
+        uint64_t km[NUM_SQUARES + 1], ko[NUM_SQUARES + 1], qm[NUM_SQUARES + 1], qo[NUM_SQUARES + 1];
+        int n_km = distance_layers<false>(my_bb, empty, km);
+        int n_ko = distance_layers<false>(op_bb, empty, ko);
+        int n_qm = distance_layers<true>(my_bb, empty, qm);
+        int n_qo = distance_layers<true>(op_bb, empty, qo);
+
+        double scores[5] = { 0, 0, 0, 0, 0 }; // qt, kt, qp, kp, mob
+        int kt = 0;
+        territory(km, n_km, ko, n_ko, &kt);
+        scores[0] = territory(qm, n_qm, qo, n_qo, nullptr);
+        scores[1] = kt;
+        for (int d = 1; d < 9 && (d < n_km || d < n_ko); d++) {
+            int diff = (d < n_km ? popcount(km[d]) : 0) - (d < n_ko ? popcount(ko[d]) : 0);
+            scores[2] += diff * POW2[d];
+            if (d < 6) scores[3] += diff * INV[d];
+        }
+        scores[4] = mobility(my_bb, ~empty) - mobility(op_bb, ~empty);
+
+        const double* w = TURN_WEIGHTS[turn >= 28 ? 27 : turn - 1];
+        double total = 0;
+        for (int i = 0; i < 5; i++) total += scores[i] * w[i];
+        return fast_sigmoid(total * 0.2);
+    }
+};
+
+} // namespace amazons
+
+#endif
+// ---- end eval.h ----
+// ---- begin policy.h ----
+// policy.h - selection policies for Engine<>
+// A policy provides
+//   static float exploration(int turn)              UCB constant for the turn
+//   static bool can_expand(int expanded, int visits) whether a node visited
+//       `visits` times may take another child while it still has untried moves
+// Selection itself is the UCB1 scan in select_ucb(), shared by every policy.
+#ifndef AMAZONS_POLICY_H
+#define AMAZONS_POLICY_H
+
+#include <cmath>
+
+namespace amazons {
+
+// Child of the block [wins, visits) x n with the highest UCB1 score; n > 0
+inline int select_ucb(const float* wins, const int* visits, int n, int parent_visits, float c) {
+    float c_log = c * std::sqrt(std::log((float)parent_visits + 1));
+    int best = 0;
+    float best_score = -1;
+    for (int i = 0; i < n; i++) {
+        float v = (float)visits[i];
+        float s = wins[i] / v + c_log / std::sqrt(v);
+        if (s > best_score) {
+            best_score = s;
+            best = i;
+        }
+    }
+    return best;
+}
+
+// bot032's schedule: C = 0.177 * exp(-0.008 * (turn - 1.41)), every untried move
+// expanded before any child is selected twice
+struct ScheduledUCB {
+    static float exploration(int turn) {
+        return 0.177f * std::exp(-0.008f * (turn - 1.41f));
+    }
+    static bool can_expand(int expanded, int visits) {
+        (void)expanded;
+        (void)visits;
+        return true;
+    }
+};
+
+// Same schedule with progressive widening: at most 2 * sqrt(visits) children
+struct WideningUCB {
+    static float exploration(int turn) {
+        return ScheduledUCB::exploration(turn);
+    }
+    static bool can_expand(int expanded, int visits) {
+        return expanded * expanded < 4 * (visits + 1);
+    }
+};
+
+// Both from the constants of S, for compile-time profiles (profiles.h):
+// C = S::UCB_BASE * exp(-S::UCB_DECAY * (turn - S::UCB_SHIFT)) and, when
+// S::WIDENING > 0, at most S::WIDENING * sqrt(visits + 1) children
+template <class S>
+struct ParamUCB {
+    static float exploration(int turn) {
+        return S::UCB_BASE * std::exp(-S::UCB_DECAY * (turn - S::UCB_SHIFT));
+    }
+    static bool can_expand(int expanded, int visits) {
+        return S::WIDENING <= 0 || expanded * expanded < S::WIDENING * S::WIDENING * (visits + 1);
+    }
+};
+
+} // namespace amazons
+
+#endif
+// ---- end policy.h ----
+
+namespace amazons {
+
+// --- PHASES ---
+// Before for turns below TURN, After from TURN on; After may be another SwitchAt
+template <int TURN, class Before, class After>
+struct SwitchAt {};
+
+// PhaseAt<T>::apply(turn, f) calls f.run<U>() with U the policy T selects at turn
+template <class T>
+struct PhaseAt {
+    template <class F>
+    static void apply(int turn, F& f) {
+        (void)turn;
+        f.template run<T>();
+    }
+};
+
+template <int TURN, class Before, class After>
+struct PhaseAt<SwitchAt<TURN, Before, After> > {
+    template <class F>
+    static void apply(int turn, F& f) {
+        if (turn < TURN) PhaseAt<Before>::apply(turn, f);
+        else PhaseAt<After>::apply(turn, f);
+    }
+};
+
+struct DefaultConfig {
+    static const int MAX_NODES = 8000000;   // Only used nodes consume RSS
+    static const int CHECK_INTERVAL = 256;  // Iterations between clock and RSS checks
+    static const int RSS_LIMIT_MB = 480;    // Search stops here (Botzone limit 512 MB)
+    static const int MAX_DEPTH = 96;        // Longest game is 92 plies
+};
+
+// Resident set size in bytes from /proc/self/statm, 0 if unavailable
+inline size_t resident_bytes() {
+    static int fd = open("/proc/self/statm", O_RDONLY);
+    char buf[128];
+    ssize_t n = fd >= 0 ? pread(fd, buf, sizeof(buf) - 1, 0) : -1;
+    if (n <= 0) return 0;
+    buf[n] = 0;
+    char* p = buf;
+    strtoull(p, &p, 10); // size
+    return strtoull(p, nullptr, 10) * (size_t)sysconf(_SC_PAGESIZE);
+}
+
+template <class Board, class Eval, class Policy, class Config = DefaultConfig>
+class Engine {
+public:
+    typedef std::chrono::steady_clock Clock;
+    typedef Board BoardType;
+
+    Engine()
+        : move_(new Move[Config::MAX_NODES]), first_(new int[Config::MAX_NODES]),
+          count_(new uint16_t[Config::MAX_NODES]), expanded_(new uint16_t[Config::MAX_NODES]),
+          capacity_(new uint16_t[Config::MAX_NODES]),
+          wins_(new float[Config::MAX_NODES]), visits_(new int[Config::MAX_NODES]) {
+        seed((uint32_t)Clock::now().time_since_epoch().count());
+        reset();
+    }
+
+    ~Engine() {
+        delete[] move_;
+        delete[] first_;
+        delete[] count_;
+        delete[] expanded_;
+        delete[] capacity_;
+        delete[] wins_;
+        delete[] visits_;
+    }
+
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    void seed(uint32_t s) {
+        rng_ = s ? s : 0xDEADBEEF;
+    }
+
+    // New game from the start position
+    void reset() {
+        board_ = Board();
+        color_ = BLACK;
+        ply_ = 0;
+        clear_tree();
+    }
+
+    // Apply a move of the side to move, keeping the matching subtree
+    void play(const Move& m) {
+        board_.apply(m);
+        color_ = -color_;
+        ply_++;
+        int next = -1;
+        if (first_[root_] >= 0)
+            for (int i = 0; i < expanded_[root_] && next < 0; i++)
+                if (move_[first_[root_] + i] == m) next = first_[root_] + i;
+        if (next < 0) clear_tree();
+        else root_ = next;
+    }
+
+    // Best move of the side to move, searching until deadline or max_iterations
+    // (0 for no cap); NO_MOVE if it has none
+    Move think(Clock::time_point deadline, uint32_t max_iterations = 0) {
+        if (top_ > Config::MAX_NODES / 4 * 3) clear_tree();
+        iterations_ = 0;
+        EvalPhase phase = { this, deadline, max_iterations, ply_ / 2 + 1 };
+        PhaseAt<Eval>::apply(phase.turn, phase);
+
+        int best = -1;
+        if (first_[root_] >= 0)
+            for (int i = 0; i < expanded_[root_]; i++) {
+                int ch = first_[root_] + i;
+                if (best < 0 || visits_[ch] > visits_[best]) best = ch;
+            }
+        if (best >= 0) return move_[best];
+        Move moves[MAX_MOVES];
+        return board_.generate(color_, moves) ? moves[0] : NO_MOVE;
+    }
+
+    // Moves and visit counts of the root's children; returns how many
+    int root_stats(Move* moves, int* visits) const {
+        int n = first_[root_] >= 0 ? expanded_[root_] : 0;
+        for (int i = 0; i < n; i++) {
+            moves[i] = move_[first_[root_] + i];
+            visits[i] = visits_[first_[root_] + i];
+        }
+        return n;
+    }
+
+    const Board& position() const { return board_; }
+    int side_to_move() const { return color_; }
+    int ply() const { return ply_; }
+    uint32_t iterations() const { return iterations_; }
+    int tree_nodes() const { return top_; }
+
+private:
+    static const uint16_t UNKNOWN = 0xFFFF;
+
+    Move* move_;        // Move into the node
+    int* first_;        // Child block, -1 before the first expansion
+    uint16_t* count_;   // Legal moves, UNKNOWN before the first expansion
+    uint16_t* expanded_; // Children in the block
+    uint16_t* capacity_; // Slots in the block
+    float* wins_;       // For the player who made move_
+    int* visits_;
+    int root_, top_;
+    Board board_;
+    int color_, ply_;
+    uint32_t rng_, iterations_;
+    Move scratch_[MAX_MOVES];
+
+    // think() with the evaluator E and the policy P of the current phase
+    template <class E, class P>
+    void search(Clock::time_point deadline, uint32_t max_iterations, int turn) {
+        const float c = P::exploration(turn);
+        for (;;) {
+            if (max_iterations && iterations_ >= max_iterations) break;
+            if (iterations_ % Config::CHECK_INTERVAL == 0 &&
+                (Clock::now() >= deadline || resident_bytes() > (size_t)Config::RSS_LIMIT_MB << 20))
+                break;
+            if (!iterate<E, P>(turn, c)) break;
+            iterations_++;
+        }
+    }
+
+    template <class E>
+    struct PolicyPhase {
+        Engine* engine;
+        Clock::time_point deadline;
+        uint32_t max_iterations;
+        int turn;
+        template <class P>
+        void run() {
+            engine->template search<E, P>(deadline, max_iterations, turn);
+        }
+    };
+
+    struct EvalPhase {
+        Engine* engine;
+        Clock::time_point deadline;
+        uint32_t max_iterations;
+        int turn;
+        template <class E>
+        void run() {
+            PolicyPhase<E> next = { engine, deadline, max_iterations, turn };
+            PhaseAt<Policy>::apply(turn, next);
+        }
+    };
+
+    inline uint32_t next_rand() {
+        uint32_t x = rng_;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        return rng_ = x;
+    }
+
+    void clear_tree() {
+        root_ = 0;
+        top_ = 1;
+        init_node(0, NO_MOVE);
+    }
+
+    inline void init_node(int n, const Move& m) {
+        move_[n] = m;
+        first_[n] = -1;
+        count_[n] = UNKNOWN;
+        expanded_[n] = capacity_[n] = 0;
+        wins_[n] = 0;
+        visits_[n] = 0;
+    }
+
+    inline void copy_node(int dst, int src) {
+        move_[dst] = move_[src];
+        first_[dst] = first_[src];
+        count_[dst] = count_[src];
+        expanded_[dst] = expanded_[src];
+        capacity_[dst] = capacity_[src];
+        wins_[dst] = wins_[src];
+        visits_[dst] = visits_[src];
+    }
+
+    inline bool is_child(int n, const Move& m) const {
+        for (int i = 0; i < expanded_[n]; i++)
+            if (move_[first_[n] + i] == m) return true;
+        return false;
+    }
+
+    // Add a random untried move of b as a child of n; -1 once the pool is full
+    int expand(int n, const Board& b, int to_move) {
+        int cnt = b.generate(to_move, scratch_);
+        int e = expanded_[n];
+        if (e == capacity_[n]) {
+            int cap = e ? 2 * e : 4;
+            if (cap > cnt) cap = cnt;
+            if (top_ + cap > Config::MAX_NODES) return -1;
+            for (int i = 0; i < e; i++) copy_node(top_ + i, first_[n] + i);
+            first_[n] = top_;
+            capacity_[n] = (uint16_t)cap;
+            top_ += cap;
+        }
+        Move m = scratch_[next_rand() % (uint32_t)cnt];
+        if (2 * e < cnt) {
+            while (is_child(n, m)) m = scratch_[next_rand() % (uint32_t)cnt];
+        } else if (is_child(n, m)) {
+            // Mostly expanded: the k-th untried move in generation order
+            int k = (int)(next_rand() % (uint32_t)(cnt - e));
+            for (int i = 0; i < cnt; i++) {
+                if (is_child(n, scratch_[i])) continue;
+                if (k-- == 0) {
+                    m = scratch_[i];
+                    break;
+                }
+            }
+        }
+        int slot = first_[n] + e;
+        init_node(slot, m);
+        expanded_[n]++;
+        return slot;
+    }
+
+    // One selection, expansion, evaluation and backup; false once the pool is full
+    template <class E, class P>
+    bool iterate(int turn, float c) {
+        int path[Config::MAX_DEPTH + 1];
+        int depth = 0;
+        Board b = board_;
+        int to_move = color_;
+        int n = root_;
+        path[depth++] = n;
+        double value; // For the player who moved into the last node of the path
+        for (;;) {
+            if (count_[n] == UNKNOWN) count_[n] = (uint16_t)b.generate(to_move, scratch_);
+            if (count_[n] == 0) {
+                value = 1; // The side to move is stuck: the last mover has won
+                break;
+            }
+            int e = expanded_[n];
+            if (e < count_[n] && (e == 0 || P::can_expand(e, visits_[n]))) {
+                int slot = expand(n, b, to_move);
+                if (slot < 0) return false;
+                b.apply(move_[slot]);
+                path[depth++] = slot;
+                value = E::evaluate(b, to_move, turn);
+                break;
+            }
+            int ch = first_[n] + select_ucb(wins_ + first_[n], visits_ + first_[n], e, visits_[n], c);
+            b.apply(move_[ch]);
+            to_move = -to_move;
+            n = ch;
+            path[depth++] = n;
+            if (depth > Config::MAX_DEPTH) {
+                value = E::evaluate(b, -to_move, turn);
+                break;
+            }
+        }
+        for (int k = depth - 1; k >= 0; k--) {
+            visits_[path[k]]++;
+            wins_[path[k]] += (float)value;
+            value = 1 - value;
+        }
+        return true;
+    }
+};
+
+} // namespace amazons
+
+#endif
+// ---- end mcts.h ----
+
+typedef amazons::Engine<amazons::BitBoard, amazons::TerritoryEval, amazons::WideningUCB> Bot;
+
+int main() {
+    return amazons::run_botzone<Bot>();
+}
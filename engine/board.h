@@ -0,0 +1,171 @@
+// board.h - bitboard geometry, Move and the BitBoard board policy
+// Square index is row * 8 + col, bit i of a bitboard is square i.
+//
+// A board policy for Engine<> (mcts.h) provides:
+//   Board()                               start position
+//   static int side(int color)            0 for BLACK, 1 for WHITE
+//   void apply(const Move& m)             queen step and arrow
+//   int generate(int color, Move* out)    every legal move, out holds MAX_MOVES
+//   bool can_move(int color)              false when color has lost
+// BitBoard is below; occupancy.h has opponent.cpp's layout, OccupancyBoard.
+#ifndef AMAZONS_BOARD_H
+#define AMAZONS_BOARD_H
+
+#include <cstdint>
+#include <cstring>
+
+namespace amazons {
+
+const int NUM_SQUARES = 64;
+const int BLACK = 1;
+const int WHITE = -1;
+const int MAX_MOVES = 4 * 27 * 27;
+
+// 2D Directions for row,col movement: N, S, W, E, NW, NE, SW, SE
+constexpr int DIRECTIONS[8][2] = {
+    {-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {-1, 1}, {1, -1}, {1, 1}
+};
+
+#pragma pack(push, 1)
+struct Move {
+    uint8_t from, to, arrow;
+
+    Move() = default;
+    Move(int from_sq, int to_sq, int arrow_sq) : from(from_sq), to(to_sq), arrow(arrow_sq) {}
+
+    bool operator==(const Move& o) const {
+        return from == o.from && to == o.to && arrow == o.arrow;
+    }
+};
+#pragma pack(pop)
+static_assert(sizeof(Move) == 3, "Move must be 3 bytes");
+
+const Move NO_MOVE(255, 255, 255);
+
+inline int popcount(uint64_t b) {
+    return __builtin_popcountll(b);
+}
+
+inline int lsb_index(uint64_t b) {
+    return __builtin_ctzll(b);
+}
+
+inline int msb_index(uint64_t b) {
+    return 63 - __builtin_clzll(b);
+}
+
+inline uint64_t clear_lsb(uint64_t b) {
+    return b & (b - 1);
+}
+
+// --- GEOMETRY TABLES ---
+// Built by the compiler, as in bot033: SquareTable<T> is an array indexed by
+// square that a C++11 constexpr function can return.
+template <typename T>
+struct SquareTable {
+    T v[NUM_SQUARES];
+    constexpr const T& operator[](int sq) const { return v[sq]; }
+};
+
+template <int... S> struct SquareList {};
+template <int N, int... S> struct MakeSquares : MakeSquares<N - 1, N - 1, S...> {};
+template <int... S> struct MakeSquares<0, S...> { typedef SquareList<S...> type; };
+typedef MakeSquares<NUM_SQUARES>::type Squares;
+
+constexpr bool on_board(int r, int c) {
+    return r >= 0 && r < 8 && c >= 0 && c < 8;
+}
+
+constexpr uint64_t ray_from(int r, int c, int dr, int dc) {
+    return on_board(r + dr, c + dc) ? (1ULL << ((r + dr) * 8 + c + dc)) | ray_from(r + dr, c + dc, dr, dc) : 0;
+}
+
+template <int... S>
+constexpr SquareTable<uint64_t> make_rays(int d, SquareList<S...>) {
+    return SquareTable<uint64_t>{ { ray_from(S / 8, S % 8, DIRECTIONS[d][0], DIRECTIONS[d][1])... } };
+}
+
+// RAYS[d][sq]: every square reachable from sq in direction d on an empty board (sq excluded)
+constexpr SquareTable<uint64_t> RAYS[8] = {
+    make_rays(0, Squares()), make_rays(1, Squares()), make_rays(2, Squares()), make_rays(3, Squares()),
+    make_rays(4, Squares()), make_rays(5, Squares()), make_rays(6, Squares()), make_rays(7, Squares())
+};
+
+// Directions that step towards higher square indices (S, E, SW, SE)
+constexpr bool RAY_POSITIVE[8] = { false, true, false, true, false, false, true, true };
+
+// Squares a queen on sq can slide to, stopping before the first occupied square
+inline uint64_t queen_attacks(int sq, uint64_t occ) {
+    uint64_t attacks = 0;
+    for (int d = 0; d < 8; d++) {
+        uint64_t ray = RAYS[d][sq];
+        uint64_t blockers = ray & occ;
+        if (blockers) {
+            int b = RAY_POSITIVE[d] ? lsb_index(blockers) : msb_index(blockers);
+            ray ^= RAYS[d][b] | (1ULL << b);
+        }
+        attacks |= ray;
+    }
+    return attacks;
+}
+
+// One king step in all 8 directions (destination masks stop file wrap-around)
+inline uint64_t king_step(uint64_t b) {
+    const uint64_t NOT_COL0 = 0xfefefefefefefefeULL, NOT_COL7 = 0x7f7f7f7f7f7f7f7fULL;
+    uint64_t h = b | ((b >> 1) & NOT_COL7) | ((b << 1) & NOT_COL0);
+    return h | (h << 8) | (h >> 8);
+}
+
+// --- BITBOARD BOARD ---
+// One bitboard per color plus the arrows (bot033's layout)
+struct BitBoard {
+    uint64_t pieces[2]; // [0] = BLACK, [1] = WHITE
+    uint64_t arrows;
+
+    BitBoard() {
+        pieces[0] = pieces[1] = arrows = 0;
+        const int black[4] = { 2, 16, 40, 58 }, white[4] = { 5, 23, 47, 61 };
+        for (int k = 0; k < 4; k++) {
+            pieces[0] |= 1ULL << black[k];
+            pieces[1] |= 1ULL << white[k];
+        }
+    }
+
+    static inline int side(int color) {
+        return color == BLACK ? 0 : 1;
+    }
+
+    inline uint64_t occupied() const {
+        return pieces[0] | pieces[1] | arrows;
+    }
+
+    inline void apply(const Move& m) {
+        uint64_t from = 1ULL << m.from;
+        int s = (pieces[0] & from) ? 0 : 1;
+        pieces[s] ^= from | (1ULL << m.to);
+        arrows |= 1ULL << m.arrow;
+    }
+
+    int generate(int color, Move* out) const {
+        uint64_t occ = occupied();
+        int n = 0;
+        for (uint64_t p = pieces[side(color)]; p; p = clear_lsb(p)) {
+            int from = lsb_index(p);
+            for (uint64_t d = queen_attacks(from, occ); d; d = clear_lsb(d)) {
+                int to = lsb_index(d);
+                uint64_t after = (occ ^ (1ULL << from)) | (1ULL << to);
+                for (uint64_t s = queen_attacks(to, after); s; s = clear_lsb(s)) out[n++] = Move(from, to, lsb_index(s));
+            }
+        }
+        return n;
+    }
+
+    // Any queen step leaves a square to shoot back into, so a free neighbour is enough
+    inline bool can_move(int color) const {
+        return (king_step(pieces[side(color)]) & ~occupied()) != 0;
+    }
+};
+
+} // namespace amazons
+
+#endif
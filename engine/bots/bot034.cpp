@@ -0,0 +1,12 @@
+// bot034 - bitboard MCTS built from the engine core (engine/*.h)
+// BitBoard, bot033's five-term TerritoryEval and the scheduled UCB1 with
+// progressive widening. Botzone needs one file: bots/bot034.cpp is generated by
+//     python3 scripts/utils/amalgamate.py engine/bots/bot034.cpp bots/bot034.cpp
+#include "../botzone.h"
+#include "../mcts.h"
+
+typedef amazons::Engine<amazons::BitBoard, amazons::TerritoryEval, amazons::WideningUCB> Bot;
+
+int main() {
+    return amazons::run_botzone<Bot>();
+}
@@ -0,0 +1,24 @@
+// bot035 - opponent.cpp's search state and evaluation on the engine core
+// OccupancyBoard and OpponentEval (engine/occupancy.h: opponent.cpp's board
+// layout and AVX2 evaluation kernels) with the scheduled UCB1 and progressive
+// widening of bot034. opponent.cpp's own policy, every move of a node expanded
+// before any child is searched twice (ScheduledUCB), lost 7-33 to it at 100 ms
+// per move. SEARCH_THREADS engines search in parallel from the root (engine/
+// parallel.h); the RSS limit of DefaultConfig covers all their pools. Botzone
+// needs one file: bots/bot035.cpp is generated by
+//     python3 scripts/utils/amalgamate.py engine/bots/bot035.cpp bots/bot035.cpp
+#include "../botzone.h"
+#include "../mcts.h"
+#include "../occupancy.h"
+#include "../parallel.h"
+
+#ifndef SEARCH_THREADS
+#define SEARCH_THREADS 1
+#endif
+
+typedef amazons::Engine<amazons::OccupancyBoard, amazons::OpponentEval, amazons::WideningUCB> Search;
+typedef amazons::RootParallel<Search, SEARCH_THREADS> Bot;
+
+int main() {
+    return amazons::run_botzone<Bot>();
+}
@@ -0,0 +1,12 @@
+// profile.cpp - a bot from any named profile of engine/profiles.h
+// AMAZONS_PROFILE picks it (Bot034Profile by default); see profiles.h for the
+// g++ and amalgamate.py lines that build one.
+#include "../profiles.h"
+
+#ifndef AMAZONS_PROFILE
+#define AMAZONS_PROFILE Bot034Profile
+#endif
+
+int main() {
+    return amazons::run_profile<amazons::AMAZONS_PROFILE>();
+}
@@ -0,0 +1,81 @@
+// botzone.h - Botzone traditional protocol with long-running mode for any core engine
+// EngineT needs play(Move) and think(deadline); see mcts.h.
+#ifndef AMAZONS_BOTZONE_H
+#define AMAZONS_BOTZONE_H
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "board.h"
+
+namespace amazons {
+
+// Parse "x0 y0 x1 y1 x2 y2"; false for lines that are not a move
+inline bool parse_move(const std::string& l, Move& m) {
+    std::stringstream ss(l);
+    int c[6];
+    for (int k = 0; k < 6; ++k) {
+        if (!(ss >> c[k])) return false;
+    }
+    if (c[0] == -1) return false;
+    m = Move(c[0] * 8 + c[1], c[2] * 8 + c[3], c[4] * 8 + c[5]);
+    return true;
+}
+
+// Print a move in Botzone coordinates; false for NO_MOVE
+inline bool print_move(const Move& m) {
+    if (m.from == 255) {
+        std::cout << "-1 -1 -1 -1 -1 -1" << std::endl;
+        return false;
+    }
+    std::cout << m.from / 8 << " " << m.from % 8 << " " << m.to / 8 << " " << m.to % 8 << " "
+              << m.arrow / 8 << " " << m.arrow % 8 << std::endl;
+    return true;
+}
+
+// Play one Botzone game on stdin/stdout. Limits are seconds per turn measured
+// from the arrival of the request (from process start on the first turn).
+template <class EngineT>
+int run_botzone(double first_limit = 1.96, double limit = 0.98, bool long_running = true) {
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point start = Clock::now();
+    std::ios::sync_with_stdio(false);
+    std::cin.tie(nullptr);
+
+    static EngineT engine; // Pools are far too large for the stack
+    std::string line;
+    if (!std::getline(std::cin, line)) return 0;
+    int turn = std::stoi(line);
+    for (int i = 0; i < 2 * turn - 1; i++) {
+        Move m;
+        if (!std::getline(std::cin, line)) return 0;
+        if (parse_move(line, m)) engine.play(m);
+    }
+
+    double budget = turn == 1 ? first_limit : limit;
+    for (;;) {
+        Clock::time_point deadline = start + std::chrono::duration_cast<Clock::duration>(
+                                                 std::chrono::duration<double>(budget));
+        Move best = engine.think(deadline);
+        if (!print_move(best)) return 0;
+        if (!long_running) return 0;
+        engine.play(best);
+        std::cout << ">>>BOTZONE_REQUEST_KEEP_RUNNING<<<" << std::endl;
+
+        Move opp;
+        bool found = false;
+        while (!found) {
+            if (!std::getline(std::cin, line)) return 0;
+            found = parse_move(line, opp); // Skips the bare turn-number lines
+        }
+        start = Clock::now();
+        engine.play(opp);
+        budget = limit;
+    }
+}
+
+} // namespace amazons
+
+#endif
@@ -0,0 +1,143 @@
+// eval.h - evaluator policies over BitBoard
+// An evaluator for Engine<> provides
+//   static double evaluate(const Board& b, int color, int turn)
+// returning the probability in [0, 1] that color wins the position.
+#ifndef AMAZONS_EVAL_H
+#define AMAZONS_EVAL_H
+
+#include <cmath>
+
+#include "board.h"
+
+namespace amazons {
+
+inline double fast_sigmoid(double x) {
+    return 0.5 * (x / (1.0 + std::abs(x)) + 1.0);
+}
+
+// Squares reached by sliding from any of srcs through empty squares in 8
+// directions, by Kogge-Stone occluded fills (bot033's queen_fill_scalar)
+inline uint64_t queen_fill(uint64_t srcs, uint64_t empty) {
+    static const uint64_t SHIFT[4] = { 1, 7, 8, 9 };
+    static const uint64_t MASK_UP[4] = { 0xfefefefefefefefeULL, 0x7f7f7f7f7f7f7f7fULL, ~0ULL, 0xfefefefefefefefeULL };
+    static const uint64_t MASK_DOWN[4] = { 0x7f7f7f7f7f7f7f7fULL, 0xfefefefefefefefeULL, ~0ULL, 0x7f7f7f7f7f7f7f7fULL };
+    uint64_t reach = 0;
+    for (int k = 0; k < 4; k++) {
+        uint64_t s = SHIFT[k];
+        uint64_t gen = srcs, pro = empty & MASK_UP[k];
+        gen |= pro & (gen << s); pro &= pro << s;
+        gen |= pro & (gen << 2 * s); pro &= pro << 2 * s;
+        gen |= pro & (gen << 4 * s);
+        reach |= gen;
+        gen = srcs; pro = empty & MASK_DOWN[k];
+        gen |= pro & (gen >> s); pro &= pro >> s;
+        gen |= pro & (gen >> 2 * s); pro &= pro >> 2 * s;
+        gen |= pro & (gen >> 4 * s);
+        reach |= gen;
+    }
+    return reach & empty;
+}
+
+// Layered BFS from srcs; returns the number of layers (layers[0] = srcs)
+template <bool QUEEN>
+inline int distance_layers(uint64_t srcs, uint64_t empty, uint64_t* layers) {
+    uint64_t seen = srcs, front = srcs;
+    int n = 0;
+    layers[n++] = srcs;
+    for (;;) {
+        front = (QUEEN ? queen_fill(front, empty) : king_step(front) & empty) & ~seen;
+        if (!front) return n;
+        seen |= front;
+        layers[n++] = front;
+    }
+}
+
+// Squares strictly closer to me minus squares strictly closer to the opponent;
+// kt, if given, also gets the sum of (4 - d) over those squares with d < 4
+inline int territory(const uint64_t* my, int n_my, const uint64_t* op, int n_op, int* kt) {
+    uint64_t reach_my = my[0], reach_op = op[0];
+    int t = 0;
+    for (int d = 1; d < n_my || d < n_op; d++) {
+        uint64_t m = d < n_my ? my[d] : 0;
+        uint64_t o = d < n_op ? op[d] : 0;
+        int diff = popcount(m & ~(reach_op | o)) - popcount(o & ~(reach_my | m));
+        reach_my |= m;
+        reach_op |= o;
+        t += diff;
+        if (kt && d < 4) *kt += (4 - d) * diff;
+    }
+    return t;
+}
+
+inline int mobility(uint64_t pieces, uint64_t occ) {
+    int mob = 0;
+    for (uint64_t p = pieces; p; p = clear_lsb(p)) mob += popcount(queen_attacks(lsb_index(p), occ));
+    return mob;
+}
+
+// Weights of the five terms by turn (row turn - 1, the last row from turn 28
+// on): opponent.cpp's table, shared by every evaluator built on those terms
+const double TURN_WEIGHTS[28][5] = {
+    { 0.07747, 0.05755, 0.64627, 0.70431, 0.02438 }, { 0.05093, 0.06276, 0.69898, 0.66192, 0.02362 },
+    { 0.06036, 0.06253, 0.60094, 0.67719, 0.01873 }, { 0.07597, 0.06952, 0.69061, 0.67989, 0.02098 },
+    { 0.08083, 0.08815, 0.58981, 0.54664, 0.02318 }, { 0.09155, 0.08397, 0.56392, 0.54319, 0.02317 },
+    { 0.10653, 0.10479, 0.54840, 0.53023, 0.02084 }, { 0.11534, 0.11515, 0.53325, 0.52423, 0.02237 },
+    { 0.12943, 0.12673, 0.50841, 0.52208, 0.02490 }, { 0.12882, 0.13946, 0.49621, 0.51776, 0.03045 },
+    { 0.13701, 0.15338, 0.47601, 0.51500, 0.03249 }, { 0.14530, 0.15565, 0.45365, 0.50934, 0.03830 },
+    { 0.14521, 0.16388, 0.44531, 0.50517, 0.04864 }, { 0.13750, 0.16326, 0.43619, 0.50328, 0.05912 },
+    { 0.13565, 0.15529, 0.42382, 0.50288, 0.07437 }, { 0.12382, 0.10361, 0.50487, 0.55808, 0.02791 },
+    { 0.11809, 0.14632, 0.40738, 0.41782, 0.10308 }, { 0.10805, 0.15043, 0.40520, 0.43073, 0.10967 },
+    { 0.09668, 0.15666, 0.40215, 0.44165, 0.10906 }, { 0.10585, 0.16319, 0.38220, 0.45465, 0.10062 },
+    { 0.11123, 0.15516, 0.36904, 0.46534, 0.09118 }, { 0.12535, 0.10492, 0.35567, 0.48043, 0.08337 },
+    { 0.28657, 0.16655, 0.38060, 0.42472, 0.10316 }, { 0.07143, 0.16655, 0.36658, 0.39520, 0.02194 },
+    { 0.07143, 0.16655, 0.36658, 0.39520, 0.02194 }, { 0.07143, 0.16655, 0.36658, 0.39520, 0.02194 },
+    { 0.07143, 0.16655, 0.36658, 0.39520, 0.02194 }, { 0.07143, 0.14627, 0.36658, 0.39520, 0.02194 }
+};
+
+// Queen moves available to color minus the opponent's, squashed
+struct MobilityEval {
+    static double evaluate(const BitBoard& b, int color, int turn) {
+        (void)turn;
+        uint64_t occ = b.occupied();
+        int diff = mobility(b.pieces[BitBoard::side(color)], occ) - mobility(b.pieces[BitBoard::side(-color)], occ);
+        return fast_sigmoid(diff * 0.02);
+    }
+};
+
+// bot033's five-term evaluation: queen territory, king territory, queen and
+// king position, mobility, weighted by turn
+struct TerritoryEval {
+    static double evaluate(const BitBoard& b, int color, int turn) {
+        static const double POW2[] = { 0, 0.5, 0.25, 0.125, 0.0625, 0.03125, 0.015625, 0.0078125, 0.00390625 };
+        static const double INV[] = { 1.0, 1.0 / 2, 1.0 / 3, 1.0 / 4, 1.0 / 5, 1.0 / 6 };
+
+        uint64_t empty = ~b.occupied();
+        uint64_t my_bb = b.pieces[BitBoard::side(color)], op_bb = b.pieces[BitBoard::side(-color)];
+        uint64_t km[NUM_SQUARES + 1], ko[NUM_SQUARES + 1], qm[NUM_SQUARES + 1], qo[NUM_SQUARES + 1];
+        int n_km = distance_layers<false>(my_bb, empty, km);
+        int n_ko = distance_layers<false>(op_bb, empty, ko);
+        int n_qm = distance_layers<true>(my_bb, empty, qm);
+        int n_qo = distance_layers<true>(op_bb, empty, qo);
+
+        double scores[5] = { 0, 0, 0, 0, 0 }; // qt, kt, qp, kp, mob
+        int kt = 0;
+        territory(km, n_km, ko, n_ko, &kt);
+        scores[0] = territory(qm, n_qm, qo, n_qo, nullptr);
+        scores[1] = kt;
+        for (int d = 1; d < 9 && (d < n_km || d < n_ko); d++) {
+            int diff = (d < n_km ? popcount(km[d]) : 0) - (d < n_ko ? popcount(ko[d]) : 0);
+            scores[2] += diff * POW2[d];
+            if (d < 6) scores[3] += diff * INV[d];
+        }
+        scores[4] = mobility(my_bb, ~empty) - mobility(op_bb, ~empty);
+
+        const double* w = TURN_WEIGHTS[turn >= 28 ? 27 : turn - 1];
+        double total = 0;
+        for (int i = 0; i < 5; i++) total += scores[i] * w[i];
+        return fast_sigmoid(total * 0.2);
+    }
+};
+
+} // namespace amazons
+
+#endif
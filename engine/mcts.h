@@ -0,0 +1,337 @@
+// mcts.h - header-only MCTS core templated on board, evaluator and policy
+// Engine<Board, Eval, Policy, Config> is one search specialized at compile time:
+// every call into the policies is static and inlined, nothing in the per-
+// iteration loop is virtual. See board.h, eval.h and policy.h for what each
+// parameter provides; Config fixes the pool size and the limits.
+//
+// Nodes are structure-of-arrays in one bump-allocated pool. A node's children
+// form one contiguous block that doubles (is copied to a new block twice the
+// size) when it fills; no move lists are stored: an expansion regenerates the
+// node's moves and draws one that is not a child yet. Descent records its path,
+// so nodes keep no parent index and blocks can move freely. The clock and the
+// RSS are checked every Config::CHECK_INTERVAL iterations.
+// Tree reuse: play() moves the root to the matching child. The pool is not
+// compacted; when it is three quarters full a turn starts from a fresh tree.
+// Phases: Eval and Policy may be SwitchAt<TURN, Before, After> schedules.
+// think() resolves them for its turn once and runs the search loop compiled for
+// that evaluator and policy, so the hot loop never looks at the turn; the tree
+// carries over a switch.
+#ifndef AMAZONS_MCTS_H
+#define AMAZONS_MCTS_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "board.h"
+#include "eval.h"
+#include "policy.h"
+
+namespace amazons {
+
+// --- PHASES ---
+// Before for turns below TURN, After from TURN on; After may be another SwitchAt
+template <int TURN, class Before, class After>
+struct SwitchAt {};
+
+// PhaseAt<T>::apply(turn, f) calls f.run<U>() with U the policy T selects at turn
+template <class T>
+struct PhaseAt {
+    template <class F>
+    static void apply(int turn, F& f) {
+        (void)turn;
+        f.template run<T>();
+    }
+};
+
+template <int TURN, class Before, class After>
+struct PhaseAt<SwitchAt<TURN, Before, After> > {
+    template <class F>
+    static void apply(int turn, F& f) {
+        if (turn < TURN) PhaseAt<Before>::apply(turn, f);
+        else PhaseAt<After>::apply(turn, f);
+    }
+};
+
+struct DefaultConfig {
+    static const int MAX_NODES = 8000000;   // Only used nodes consume RSS
+    static const int CHECK_INTERVAL = 256;  // Iterations between clock and RSS checks
+    static const int RSS_LIMIT_MB = 480;    // Search stops here (Botzone limit 512 MB)
+    static const int MAX_DEPTH = 96;        // Longest game is 92 plies
+};
+
+// Resident set size in bytes from /proc/self/statm, 0 if unavailable
+inline size_t resident_bytes() {
+    static int fd = open("/proc/self/statm", O_RDONLY);
+    char buf[128];
+    ssize_t n = fd >= 0 ? pread(fd, buf, sizeof(buf) - 1, 0) : -1;
+    if (n <= 0) return 0;
+    buf[n] = 0;
+    char* p = buf;
+    strtoull(p, &p, 10); // size
+    return strtoull(p, nullptr, 10) * (size_t)sysconf(_SC_PAGESIZE);
+}
+
+template <class Board, class Eval, class Policy, class Config = DefaultConfig>
+class Engine {
+public:
+    typedef std::chrono::steady_clock Clock;
+    typedef Board BoardType;
+
+    Engine()
+        : move_(new Move[Config::MAX_NODES]), first_(new int[Config::MAX_NODES]),
+          count_(new uint16_t[Config::MAX_NODES]), expanded_(new uint16_t[Config::MAX_NODES]),
+          capacity_(new uint16_t[Config::MAX_NODES]),
+          wins_(new float[Config::MAX_NODES]), visits_(new int[Config::MAX_NODES]) {
+        seed((uint32_t)Clock::now().time_since_epoch().count());
+        reset();
+    }
+
+    ~Engine() {
+        delete[] move_;
+        delete[] first_;
+        delete[] count_;
+        delete[] expanded_;
+        delete[] capacity_;
+        delete[] wins_;
+        delete[] visits_;
+    }
+
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    void seed(uint32_t s) {
+        rng_ = s ? s : 0xDEADBEEF;
+    }
+
+    // New game from the start position
+    void reset() {
+        board_ = Board();
+        color_ = BLACK;
+        ply_ = 0;
+        clear_tree();
+    }
+
+    // Apply a move of the side to move, keeping the matching subtree
+    void play(const Move& m) {
+        board_.apply(m);
+        color_ = -color_;
+        ply_++;
+        int next = -1;
+        if (first_[root_] >= 0)
+            for (int i = 0; i < expanded_[root_] && next < 0; i++)
+                if (move_[first_[root_] + i] == m) next = first_[root_] + i;
+        if (next < 0) clear_tree();
+        else root_ = next;
+    }
+
+    // Best move of the side to move, searching until deadline or max_iterations
+    // (0 for no cap); NO_MOVE if it has none
+    Move think(Clock::time_point deadline, uint32_t max_iterations = 0) {
+        if (top_ > Config::MAX_NODES / 4 * 3) clear_tree();
+        iterations_ = 0;
+        EvalPhase phase = { this, deadline, max_iterations, ply_ / 2 + 1 };
+        PhaseAt<Eval>::apply(phase.turn, phase);
+
+        int best = -1;
+        if (first_[root_] >= 0)
+            for (int i = 0; i < expanded_[root_]; i++) {
+                int ch = first_[root_] + i;
+                if (best < 0 || visits_[ch] > visits_[best]) best = ch;
+            }
+        if (best >= 0) return move_[best];
+        Move moves[MAX_MOVES];
+        return board_.generate(color_, moves) ? moves[0] : NO_MOVE;
+    }
+
+    // Moves and visit counts of the root's children; returns how many
+    int root_stats(Move* moves, int* visits) const {
+        int n = first_[root_] >= 0 ? expanded_[root_] : 0;
+        for (int i = 0; i < n; i++) {
+            moves[i] = move_[first_[root_] + i];
+            visits[i] = visits_[first_[root_] + i];
+        }
+        return n;
+    }
+
+    const Board& position() const { return board_; }
+    int side_to_move() const { return color_; }
+    int ply() const { return ply_; }
+    uint32_t iterations() const { return iterations_; }
+    int tree_nodes() const { return top_; }
+
+private:
+    static const uint16_t UNKNOWN = 0xFFFF;
+
+    Move* move_;        // Move into the node
+    int* first_;        // Child block, -1 before the first expansion
+    uint16_t* count_;   // Legal moves, UNKNOWN before the first expansion
+    uint16_t* expanded_; // Children in the block
+    uint16_t* capacity_; // Slots in the block
+    float* wins_;       // For the player who made move_
+    int* visits_;
+    int root_, top_;
+    Board board_;
+    int color_, ply_;
+    uint32_t rng_, iterations_;
+    Move scratch_[MAX_MOVES];
+
+    // think() with the evaluator E and the policy P of the current phase
+    template <class E, class P>
+    void search(Clock::time_point deadline, uint32_t max_iterations, int turn) {
+        const float c = P::exploration(turn);
+        for (;;) {
+            if (max_iterations && iterations_ >= max_iterations) break;
+            if (iterations_ % Config::CHECK_INTERVAL == 0 &&
+                (Clock::now() >= deadline || resident_bytes() > (size_t)Config::RSS_LIMIT_MB << 20))
+                break;
+            if (!iterate<E, P>(turn, c)) break;
+            iterations_++;
+        }
+    }
+
+    template <class E>
+    struct PolicyPhase {
+        Engine* engine;
+        Clock::time_point deadline;
+        uint32_t max_iterations;
+        int turn;
+        template <class P>
+        void run() {
+            engine->template search<E, P>(deadline, max_iterations, turn);
+        }
+    };
+
+    struct EvalPhase {
+        Engine* engine;
+        Clock::time_point deadline;
+        uint32_t max_iterations;
+        int turn;
+        template <class E>
+        void run() {
+            PolicyPhase<E> next = { engine, deadline, max_iterations, turn };
+            PhaseAt<Policy>::apply(turn, next);
+        }
+    };
+
+    inline uint32_t next_rand() {
+        uint32_t x = rng_;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        return rng_ = x;
+    }
+
+    void clear_tree() {
+        root_ = 0;
+        top_ = 1;
+        init_node(0, NO_MOVE);
+    }
+
+    inline void init_node(int n, const Move& m) {
+        move_[n] = m;
+        first_[n] = -1;
+        count_[n] = UNKNOWN;
+        expanded_[n] = capacity_[n] = 0;
+        wins_[n] = 0;
+        visits_[n] = 0;
+    }
+
+    inline void copy_node(int dst, int src) {
+        move_[dst] = move_[src];
+        first_[dst] = first_[src];
+        count_[dst] = count_[src];
+        expanded_[dst] = expanded_[src];
+        capacity_[dst] = capacity_[src];
+        wins_[dst] = wins_[src];
+        visits_[dst] = visits_[src];
+    }
+
+    inline bool is_child(int n, const Move& m) const {
+        for (int i = 0; i < expanded_[n]; i++)
+            if (move_[first_[n] + i] == m) return true;
+        return false;
+    }
+
+    // Add a random untried move of b as a child of n; -1 once the pool is full
+    int expand(int n, const Board& b, int to_move) {
+        int cnt = b.generate(to_move, scratch_);
+        int e = expanded_[n];
+        if (e == capacity_[n]) {
+            int cap = e ? 2 * e : 4;
+            if (cap > cnt) cap = cnt;
+            if (top_ + cap > Config::MAX_NODES) return -1;
+            for (int i = 0; i < e; i++) copy_node(top_ + i, first_[n] + i);
+            first_[n] = top_;
+            capacity_[n] = (uint16_t)cap;
+            top_ += cap;
+        }
+        Move m = scratch_[next_rand() % (uint32_t)cnt];
+        if (2 * e < cnt) {
+            while (is_child(n, m)) m = scratch_[next_rand() % (uint32_t)cnt];
+        } else if (is_child(n, m)) {
+            // Mostly expanded: the k-th untried move in generation order
+            int k = (int)(next_rand() % (uint32_t)(cnt - e));
+            for (int i = 0; i < cnt; i++) {
+                if (is_child(n, scratch_[i])) continue;
+                if (k-- == 0) {
+                    m = scratch_[i];
+                    break;
+                }
+            }
+        }
+        int slot = first_[n] + e;
+        init_node(slot, m);
+        expanded_[n]++;
+        return slot;
+    }
+
+    // One selection, expansion, evaluation and backup; false once the pool is full
+    template <class E, class P>
+    bool iterate(int turn, float c) {
+        int path[Config::MAX_DEPTH + 1];
+        int depth = 0;
+        Board b = board_;
+        int to_move = color_;
+        int n = root_;
+        path[depth++] = n;
+        double value; // For the player who moved into the last node of the path
+        for (;;) {
+            if (count_[n] == UNKNOWN) count_[n] = (uint16_t)b.generate(to_move, scratch_);
+            if (count_[n] == 0) {
+                value = 1; // The side to move is stuck: the last mover has won
+                break;
+            }
+            int e = expanded_[n];
+            if (e < count_[n] && (e == 0 || P::can_expand(e, visits_[n]))) {
+                int slot = expand(n, b, to_move);
+                if (slot < 0) return false;
+                b.apply(move_[slot]);
+                path[depth++] = slot;
+                value = E::evaluate(b, to_move, turn);
+                break;
+            }
+            int ch = first_[n] + select_ucb(wins_ + first_[n], visits_ + first_[n], e, visits_[n], c);
+            b.apply(move_[ch]);
+            to_move = -to_move;
+            n = ch;
+            path[depth++] = n;
+            if (depth > Config::MAX_DEPTH) {
+                value = E::evaluate(b, -to_move, turn);
+                break;
+            }
+        }
+        for (int k = depth - 1; k >= 0; k--) {
+            visits_[path[k]]++;
+            wins_[path[k]] += (float)value;
+            value = 1 - value;
+        }
+        return true;
+    }
+};
+
+} // namespace amazons
+
+#endif
@@ -0,0 +1,295 @@
+// occupancy.h - opponent.cpp's board and evaluation as core policies
+// bots/opponent.cpp keeps a position as one bitboard of every occupied square
+// (amazons and arrows) plus each side's amazons, and scores it with AVX2 shift
+// kernels: the eight directions are four shift amounts (9, 8, 7, 1), one per
+// 64-bit lane, applied right and left. OccupancyBoard and OpponentEval are that
+// layout and that evaluation on the Engine<> interfaces (board.h, eval.h). Every
+// kernel is compiled twice, for AVX2 and for plain x86-64, and the variant is
+// picked at run time as in bot033: BOT_CPU_LEVEL=0 or 1 forces the scalar one.
+// Squares are row * 8 + col as everywhere in the core; opponent.cpp stores the
+// transpose, which the evaluation cannot see since every term is symmetric.
+#ifndef AMAZONS_OCCUPANCY_H
+#define AMAZONS_OCCUPANCY_H
+
+#include <cmath>
+#include <cstdlib>
+
+#include "board.h"
+#include "eval.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define AMAZONS_AVX2 1
+#include <immintrin.h>
+#else
+#define AMAZONS_AVX2 0
+#endif
+
+namespace amazons {
+
+// Lane k shifts by SHIFT[k]; the masks drop the squares that would wrap a file
+const int SHIFT[4] = { 9, 8, 7, 1 };
+const uint64_t SHIFT_DOWN_MASK[4] = { 0xfefefefefefefefeULL, ~0ULL, 0x7f7f7f7f7f7f7f7fULL, 0xfefefefefefefefeULL };
+const uint64_t SHIFT_UP_MASK[4] = { 0x7f7f7f7f7f7f7f7fULL, ~0ULL, 0xfefefefefefefefeULL, 0x7f7f7f7f7f7f7f7fULL };
+
+inline bool cpu_has_avx2() {
+#if AMAZONS_AVX2
+    static const bool yes = [] {
+        const char* cap = getenv("BOT_CPU_LEVEL");
+        if (cap && *cap >= '0' && *cap <= '9' && atoi(cap) < 2) return false;
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return yes;
+#else
+    return false;
+#endif
+}
+
+// The kernels, one lane at a time
+struct ScalarShifts {
+    // Squares a queen reaches from any of srcs (srcs excluded), 7 steps per ray
+    static inline uint64_t slide(uint64_t srcs, uint64_t empty) {
+        uint64_t reach = 0;
+        for (int k = 0; k < 4; k++) {
+            uint64_t down = srcs, up = srcs;
+            for (int i = 0; i < 7; i++) {
+                down = ((down & SHIFT_DOWN_MASK[k]) >> SHIFT[k]) & empty;
+                up = ((up & SHIFT_UP_MASK[k]) << SHIFT[k]) & empty;
+                reach |= down | up;
+            }
+        }
+        return reach;
+    }
+
+    // opponent.cpp's calc_mobility: over the squares i queen steps out along
+    // each ray, the sum of their empty neighbours / i
+    static inline double mobility(uint64_t pieces, uint64_t empty) {
+        uint64_t down[4], up[4];
+        for (int k = 0; k < 4; k++) down[k] = up[k] = pieces;
+        double m = 0;
+        for (int i = 1; i <= 7; i++) {
+            uint64_t ring = 0, space = 0;
+            for (int k = 0; k < 4; k++) {
+                down[k] = ((down[k] & SHIFT_DOWN_MASK[k]) >> SHIFT[k]) & empty;
+                up[k] = ((up[k] & SHIFT_UP_MASK[k]) << SHIFT[k]) & empty;
+                ring |= down[k] | up[k];
+            }
+            for (int k = 0; k < 4; k++)
+                space |= (((ring & SHIFT_DOWN_MASK[k]) >> SHIFT[k]) | ((ring & SHIFT_UP_MASK[k]) << SHIFT[k])) & empty;
+            m += popcount(space) / (double)i;
+        }
+        return m;
+    }
+};
+
+#if AMAZONS_AVX2
+// The same kernels with the four lanes in one register (opponent.cpp's)
+struct Avx2Shifts {
+    __attribute__((target("avx2"))) static inline uint64_t or_lanes(__m256i v) {
+        __m128i x = _mm_or_si128(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        return (uint64_t)_mm_cvtsi128_si64(x) | (uint64_t)_mm_extract_epi64(x, 1);
+    }
+
+    // _mm256_set_epi64x lists lanes from the highest: lane k gets entry 3 - k
+    __attribute__((target("avx2"))) static inline __m256i shift() { return _mm256_set_epi64x(1, 7, 8, 9); }
+    __attribute__((target("avx2"))) static inline __m256i down_mask() {
+        return _mm256_set_epi64x((long long)SHIFT_DOWN_MASK[3], (long long)SHIFT_DOWN_MASK[2],
+                                 (long long)SHIFT_DOWN_MASK[1], (long long)SHIFT_DOWN_MASK[0]);
+    }
+    __attribute__((target("avx2"))) static inline __m256i up_mask() {
+        return _mm256_set_epi64x((long long)SHIFT_UP_MASK[3], (long long)SHIFT_UP_MASK[2],
+                                 (long long)SHIFT_UP_MASK[1], (long long)SHIFT_UP_MASK[0]);
+    }
+
+    // One step along all eight directions, per lane
+    __attribute__((target("avx2"))) static inline void step(__m256i& down, __m256i& up, __m256i empty) {
+        down = _mm256_and_si256(_mm256_srlv_epi64(_mm256_and_si256(down, down_mask()), shift()), empty);
+        up = _mm256_and_si256(_mm256_sllv_epi64(_mm256_and_si256(up, up_mask()), shift()), empty);
+    }
+
+    __attribute__((target("avx2"))) static inline uint64_t slide(uint64_t srcs, uint64_t empty) {
+        const __m256i e = _mm256_set1_epi64x((long long)empty);
+        __m256i down = _mm256_set1_epi64x((long long)srcs), up = down, reach = _mm256_setzero_si256();
+        for (int i = 0; i < 7; i++) {
+            step(down, up, e);
+            reach = _mm256_or_si256(reach, _mm256_or_si256(down, up));
+        }
+        return or_lanes(reach);
+    }
+
+    __attribute__((target("avx2,popcnt"))) static inline double mobility(uint64_t pieces, uint64_t empty) {
+        const __m256i e = _mm256_set1_epi64x((long long)empty);
+        __m256i down = _mm256_set1_epi64x((long long)pieces), up = down;
+        double m = 0;
+        for (int i = 1; i <= 7; i++) {
+            step(down, up, e);
+            __m256i ring = _mm256_set1_epi64x((long long)or_lanes(_mm256_or_si256(down, up)));
+            __m256i next = ring;
+            step(ring, next, e);
+            m += popcount(or_lanes(_mm256_or_si256(ring, next))) / (double)i;
+        }
+        return m;
+    }
+};
+#endif
+
+// --- OCCUPANCY BOARD ---
+// opponent.cpp's State: the occupied squares and each side's amazons; the
+// arrows are what the amazons do not account for
+struct OccupancyBoard {
+    uint64_t occ;       // Amazons and arrows
+    uint64_t pieces[2]; // [0] = BLACK, [1] = WHITE
+
+    OccupancyBoard() {
+        BitBoard start;
+        pieces[0] = start.pieces[0];
+        pieces[1] = start.pieces[1];
+        occ = pieces[0] | pieces[1];
+    }
+
+    static inline int side(int color) {
+        return color == BLACK ? 0 : 1;
+    }
+
+    inline uint64_t occupied() const {
+        return occ;
+    }
+
+    inline void apply(const Move& m) {
+        uint64_t step = 1ULL << m.from | 1ULL << m.to;
+        pieces[(pieces[0] >> m.from) & 1 ? 0 : 1] ^= step;
+        occ ^= step;
+        occ |= 1ULL << m.arrow;
+    }
+
+    // opponent.cpp's generate_moves: destinations and arrows by slide()
+    template <class Shifts>
+    __attribute__((always_inline)) inline int generate_with(int color, Move* out) const {
+        int n = 0;
+        for (uint64_t p = pieces[side(color)]; p; p = clear_lsb(p)) {
+            int from = lsb_index(p);
+            uint64_t empty = ~occ;
+            for (uint64_t d = Shifts::slide(1ULL << from, empty); d; d = clear_lsb(d)) {
+                int to = lsb_index(d);
+                uint64_t after = (empty | 1ULL << from) ^ 1ULL << to;
+                for (uint64_t s = Shifts::slide(1ULL << to, after); s; s = clear_lsb(s))
+                    out[n++] = Move(from, to, lsb_index(s));
+            }
+        }
+        return n;
+    }
+
+    int generate(int color, Move* out) const;
+
+    // Any queen step leaves a square to shoot back into, so a free neighbour is enough
+    inline bool can_move(int color) const {
+        return (king_step(pieces[side(color)]) & ~occ) != 0;
+    }
+};
+
+#if AMAZONS_AVX2
+__attribute__((target("avx2"))) inline int generate_avx2(const OccupancyBoard& b, int color, Move* out) {
+    return b.generate_with<Avx2Shifts>(color, out);
+}
+#endif
+
+inline int OccupancyBoard::generate(int color, Move* out) const {
+#if AMAZONS_AVX2
+    if (cpu_has_avx2()) return generate_avx2(*this, color, out);
+#endif
+    return generate_with<ScalarShifts>(color, out);
+}
+
+// --- OPPONENT EVALUATION ---
+// opponent.cpp's evaluate on any board with occupied() and pieces[2] (so on
+// BitBoard too): the five bot033 terms computed its way, weighted by
+// TURN_WEIGHTS (opponent.cpp's args) and squashed by the logistic function.
+//   t1, t2  queen and king territory (territory() in eval.h)
+//   p1      2 * sum over queen layers d of 2^-d, mine minus the opponent's
+//   p2      squares only one side reaches by king steps, counted for it, and on
+//           the squares both reach, the king distance / 6 against each side
+//   m0      mobility() of the kernels, mine minus the opponent's
+// The weight row is the number of arrows / 2, from the position itself rather
+// than from the turn being searched, so deep leaves use later weights.
+struct OpponentEval {
+    // Layers as distance_layers<true> (eval.h) builds them, by repeated slides
+    template <class Shifts>
+    __attribute__((always_inline)) static inline int queen_layers(uint64_t srcs, uint64_t empty, uint64_t* layers) {
+        uint64_t seen = srcs, front = srcs;
+        int n = 0;
+        layers[n++] = srcs;
+        for (;;) {
+            front = Shifts::slide(front, empty) & ~seen;
+            if (!front) return n;
+            seen |= front;
+            layers[n++] = front;
+        }
+    }
+
+    static inline double queen_position(const uint64_t* my, int n_my, const uint64_t* op, int n_op) {
+        double p = 0, w = 2;
+        for (int d = 1; d < n_my || d < n_op; d++) {
+            w *= 0.5;
+            p += ((d < n_my ? popcount(my[d]) : 0) - (d < n_op ? popcount(op[d]) : 0)) * w;
+        }
+        return 2 * p;
+    }
+
+    static inline double king_position(const uint64_t* my, int n_my, const uint64_t* op, int n_op) {
+        uint64_t reach_my = 0, reach_op = 0;
+        for (int d = 1; d < n_my; d++) reach_my |= my[d];
+        for (int d = 1; d < n_op; d++) reach_op |= op[d];
+        uint64_t common = reach_my & reach_op;
+        double p = popcount(reach_my & ~common) - popcount(reach_op & ~common);
+        for (int d = 1; d < n_my; d++) p -= popcount(my[d] & common) * d / 6.0;
+        for (int d = 1; d < n_op; d++) p += popcount(op[d] & common) * d / 6.0;
+        return p;
+    }
+
+    template <class Shifts, class Board>
+    __attribute__((always_inline)) static inline double evaluate_with(const Board& b, int color) {
+        uint64_t occ = b.occupied(), empty = ~occ;
+        uint64_t my_bb = b.pieces[Board::side(color)], op_bb = b.pieces[Board::side(-color)];
+        uint64_t km[NUM_SQUARES + 1], ko[NUM_SQUARES + 1], qm[NUM_SQUARES + 1], qo[NUM_SQUARES + 1];
+        int n_km = distance_layers<false>(my_bb, empty, km);
+        int n_ko = distance_layers<false>(op_bb, empty, ko);
+        int n_qm = queen_layers<Shifts>(my_bb, empty, qm);
+        int n_qo = queen_layers<Shifts>(op_bb, empty, qo);
+
+        double scores[5];
+        scores[0] = territory(qm, n_qm, qo, n_qo, nullptr);
+        scores[1] = territory(km, n_km, ko, n_ko, nullptr);
+        scores[2] = queen_position(qm, n_qm, qo, n_qo);
+        scores[3] = king_position(km, n_km, ko, n_ko);
+        scores[4] = Shifts::mobility(my_bb, empty) - Shifts::mobility(op_bb, empty);
+
+        int row = (popcount(occ) - 8) >> 1;
+        const double* w = TURN_WEIGHTS[row > 27 ? 27 : row];
+        double total = 0;
+        for (int i = 0; i < 5; i++) total += scores[i] * w[i];
+        return 1 / (1 + std::exp(-total * 0.2));
+    }
+
+    template <class Board>
+    static double evaluate(const Board& b, int color, int turn);
+};
+
+#if AMAZONS_AVX2
+template <class Board>
+__attribute__((target("avx2,popcnt"))) inline double evaluate_avx2(const Board& b, int color) {
+    return OpponentEval::evaluate_with<Avx2Shifts>(b, color);
+}
+#endif
+
+template <class Board>
+inline double OpponentEval::evaluate(const Board& b, int color, int turn) {
+    (void)turn;
+#if AMAZONS_AVX2
+    if (cpu_has_avx2()) return evaluate_avx2(b, color);
+#endif
+    return evaluate_with<ScalarShifts>(b, color);
+}
+
+} // namespace amazons
+
+#endif
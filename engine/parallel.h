@@ -0,0 +1,109 @@
+// parallel.h - root-parallel search over any core engine
+// RootParallel<EngineT, THREADS> keeps THREADS engines on the same position,
+// each with its own pool and seed. think() searches all of them until the
+// deadline, one thread each, and plays the move with the most root visits
+// summed over the trees (bot033's merge); every engine keeps its tree for the
+// next turn. Each engine checks the process RSS against its Config limit, so
+// the limit holds for all the pools together. Build with -pthread.
+#ifndef AMAZONS_PARALLEL_H
+#define AMAZONS_PARALLEL_H
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "board.h"
+
+namespace amazons {
+
+template <class EngineT, int THREADS>
+class RootParallel {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    RootParallel() {
+        uint32_t s = (uint32_t)Clock::now().time_since_epoch().count();
+        for (int t = 0; t < THREADS; t++) {
+            engines_[t] = new EngineT();
+            engines_[t]->seed(s + 0x9E3779B9U * (uint32_t)t);
+        }
+    }
+
+    ~RootParallel() {
+        for (int t = 0; t < THREADS; t++) delete engines_[t];
+    }
+
+    RootParallel(const RootParallel&) = delete;
+    RootParallel& operator=(const RootParallel&) = delete;
+
+    void seed(uint32_t s) {
+        for (int t = 0; t < THREADS; t++) engines_[t]->seed(s + 0x9E3779B9U * (uint32_t)t);
+    }
+
+    void reset() {
+        for (int t = 0; t < THREADS; t++) engines_[t]->reset();
+    }
+
+    void play(const Move& m) {
+        for (int t = 0; t < THREADS; t++) engines_[t]->play(m);
+    }
+
+    // max_iterations caps each engine on its own
+    Move think(Clock::time_point deadline, uint32_t max_iterations = 0) {
+        Move first[THREADS];
+        std::vector<std::thread> workers;
+        for (int t = 1; t < THREADS; t++)
+            workers.emplace_back([this, t, deadline, max_iterations, &first] {
+                first[t] = engines_[t]->think(deadline, max_iterations);
+            });
+        first[0] = engines_[0]->think(deadline, max_iterations);
+        for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+        if (THREADS == 1) return first[0];
+
+        // Sum the root visits by move; root move lists are short enough to scan
+        std::vector<Move> moves;
+        std::vector<int> visits;
+        for (int t = 0; t < THREADS; t++) {
+            int n = engines_[t]->root_stats(scratch_moves_, scratch_visits_);
+            for (int i = 0; i < n; i++) {
+                size_t k = 0;
+                while (k < moves.size() && !(moves[k] == scratch_moves_[i])) k++;
+                if (k == moves.size()) {
+                    moves.push_back(scratch_moves_[i]);
+                    visits.push_back(0);
+                }
+                visits[k] += scratch_visits_[i];
+            }
+        }
+        if (moves.empty()) return first[0];
+        size_t best = 0;
+        for (size_t k = 1; k < moves.size(); k++)
+            if (visits[k] > visits[best]) best = k;
+        return moves[best];
+    }
+
+    const typename EngineT::BoardType& position() const { return engines_[0]->position(); }
+    int side_to_move() const { return engines_[0]->side_to_move(); }
+    int ply() const { return engines_[0]->ply(); }
+
+    uint32_t iterations() const {
+        uint32_t n = 0;
+        for (int t = 0; t < THREADS; t++) n += engines_[t]->iterations();
+        return n;
+    }
+
+    int tree_nodes() const {
+        int n = 0;
+        for (int t = 0; t < THREADS; t++) n += engines_[t]->tree_nodes();
+        return n;
+    }
+
+private:
+    EngineT* engines_[THREADS];
+    Move scratch_moves_[MAX_MOVES];
+    int scratch_visits_[MAX_MOVES];
+};
+
+} // namespace amazons
+
+#endif
@@ -0,0 +1,68 @@
+// policy.h - selection policies for Engine<>
+// A policy provides
+//   static float exploration(int turn)              UCB constant for the turn
+//   static bool can_expand(int expanded, int visits) whether a node visited
+//       `visits` times may take another child while it still has untried moves
+// Selection itself is the UCB1 scan in select_ucb(), shared by every policy.
+#ifndef AMAZONS_POLICY_H
+#define AMAZONS_POLICY_H
+
+#include <cmath>
+
+namespace amazons {
+
+// Child of the block [wins, visits) x n with the highest UCB1 score; n > 0
+inline int select_ucb(const float* wins, const int* visits, int n, int parent_visits, float c) {
+    float c_log = c * std::sqrt(std::log((float)parent_visits + 1));
+    int best = 0;
+    float best_score = -1;
+    for (int i = 0; i < n; i++) {
+        float v = (float)visits[i];
+        float s = wins[i] / v + c_log / std::sqrt(v);
+        if (s > best_score) {
+            best_score = s;
+            best = i;
+        }
+    }
+    return best;
+}
+
+// bot032's schedule: C = 0.177 * exp(-0.008 * (turn - 1.41)), every untried move
+// expanded before any child is selected twice
+struct ScheduledUCB {
+    static float exploration(int turn) {
+        return 0.177f * std::exp(-0.008f * (turn - 1.41f));
+    }
+    static bool can_expand(int expanded, int visits) {
+        (void)expanded;
+        (void)visits;
+        return true;
+    }
+};
+
+// Same schedule with progressive widening: at most 2 * sqrt(visits) children
+struct WideningUCB {
+    static float exploration(int turn) {
+        return ScheduledUCB::exploration(turn);
+    }
+    static bool can_expand(int expanded, int visits) {
+        return expanded * expanded < 4 * (visits + 1);
+    }
+};
+
+// Both from the constants of S, for compile-time profiles (profiles.h):
+// C = S::UCB_BASE * exp(-S::UCB_DECAY * (turn - S::UCB_SHIFT)) and, when
+// S::WIDENING > 0, at most S::WIDENING * sqrt(visits + 1) children
+template <class S>
+struct ParamUCB {
+    static float exploration(int turn) {
+        return S::UCB_BASE * std::exp(-S::UCB_DECAY * (turn - S::UCB_SHIFT));
+    }
+    static bool can_expand(int expanded, int visits) {
+        return S::WIDENING <= 0 || expanded * expanded < S::WIDENING * S::WIDENING * (visits + 1);
+    }
+};
+
+} // namespace amazons
+
+#endif
@@ -0,0 +1,77 @@
+// profiles.h - named compile-time configurations of the engine core
+// A profile is one struct that fixes a whole bot: board, evaluator and policy
+// (each may be a SwitchAt phase schedule, mcts.h), the pool size and limits of
+// Engine's Config (it derives from DefaultConfig), the number of root-parallel
+// threads and the Botzone time limits. ProfileBot<P> is the engine it builds and
+// run_profile<P>() plays Botzone with it. Everything is a constant or a type,
+// so a profile costs nothing at run time, and a variant is a few lines here
+// instead of a copied bot file (as bot030, bot030-1, bot030-2 and bot031 were).
+// Each profile is a build target of engine/bots/profile.cpp:
+//     g++ -O3 -std=c++11 -pthread -DAMAZONS_PROFILE=PhasedProfile engine/bots/profile.cpp
+//     python3 scripts/utils/amalgamate.py --profile PhasedProfile engine/bots/profile.cpp bots/NAME.cpp
+#ifndef AMAZONS_PROFILES_H
+#define AMAZONS_PROFILES_H
+
+#include "botzone.h"
+#include "mcts.h"
+#include "occupancy.h"
+#include "parallel.h"
+
+namespace amazons {
+
+// bot034: BitBoard, bot033's evaluation, scheduled UCB1 with widening
+struct Bot034Profile : DefaultConfig {
+    typedef BitBoard Board;
+    typedef TerritoryEval Eval;
+    typedef WideningUCB Policy;
+    static const int THREADS = 1;
+    static constexpr double FIRST_LIMIT = 1.96; // Seconds, Botzone allows 2
+    static constexpr double LIMIT = 0.98;       // Later turns, Botzone allows 1
+    static const bool LONG_RUNNING = true;
+};
+
+// bot035: opponent.cpp's board and evaluation
+struct Bot035Profile : Bot034Profile {
+    typedef OccupancyBoard Board;
+    typedef OpponentEval Eval;
+};
+
+// bot035 on four cores: four pools under the same RSS limit
+struct ParallelProfile : Bot035Profile {
+    static const int THREADS = 4;
+};
+
+// A quarter of the pool and half the RSS, for hosts that run several bots
+struct SmallPoolProfile : Bot035Profile {
+    static const int MAX_NODES = 2000000;
+    static const int RSS_LIMIT_MB = 240;
+};
+
+// Constants of ParamUCB for PhasedProfile's endgame: bot032's schedule,
+// wider widening once few moves are left
+struct EndgameSchedule {
+    static constexpr float UCB_BASE = 0.177f;
+    static constexpr float UCB_DECAY = 0.008f;
+    static constexpr float UCB_SHIFT = 1.41f;
+    static constexpr float WIDENING = 4;
+};
+
+// Phase schedule: opponent.cpp's cheaper evaluation until turn 11, bot033's
+// from there on, and wider widening from turn 21. Not yet shown to be better:
+// 18-22 against Bot034Profile over 40 games at 100 ms per move.
+struct PhasedProfile : Bot034Profile {
+    typedef SwitchAt<11, OpponentEval, TerritoryEval> Eval;
+    typedef SwitchAt<21, WideningUCB, ParamUCB<EndgameSchedule> > Policy;
+};
+
+template <class P>
+using ProfileBot = RootParallel<Engine<typename P::Board, typename P::Eval, typename P::Policy, P>, P::THREADS>;
+
+template <class P>
+int run_profile() {
+    return run_botzone<ProfileBot<P> >(P::FIRST_LIMIT, P::LIMIT, P::LONG_RUNNING);
+}
+
+} // namespace amazons
+
+#endif
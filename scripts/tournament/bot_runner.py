@@ -13,12 +13,13 @@ import time
 import signal
 import os
 import select
+import threading
 from abc import ABC, abstractmethod
 from typing import Optional, List, Tuple
 from enum import Enum
 
 from .resource_monitor import (
-    ResourceMonitor, TurnMetrics, ViolationType, MemorySampler
+    ResourceMonitor, TurnMetrics, ViolationType, MemorySampler, parse_search_stats
 )
 
 
@@ -237,6 +238,7 @@ class TraditionalBot(BaseBotRunner):
             )
             # Use sampled peak memory
             metrics.memory_bytes = memory
+            metrics.search_stats = parse_search_stats(stderr or "")
             self.turn_metrics.append(metrics)
             
             # Check for time violation
@@ -325,6 +327,8 @@ class LongLiveBot(BaseBotRunner):
     ):
         super().__init__(bot_path, bot_name, resource_monitor)
         self.is_running = False
+        self._stderr_lines: List[str] = []
+        self._stderr_lock = threading.Lock()
         
     def _start_process(self):
         """Start the bot process."""
@@ -338,6 +342,23 @@ class LongLiveBot(BaseBotRunner):
                 bufsize=1
             )
             self.is_running = False
+            # Drain stderr continuously so a chatty bot never blocks on a full pipe
+            threading.Thread(
+                target=self._collect_stderr, args=(self.process.stderr,), daemon=True
+            ).start()
+    
+    def _collect_stderr(self, stream):
+        """Background reader: buffer stderr lines until the turn ends."""
+        for line in stream:
+            with self._stderr_lock:
+                self._stderr_lines.append(line)
+    
+    def _take_stderr(self) -> str:
+        """Return and clear the stderr received so far."""
+        with self._stderr_lock:
+            text = "".join(self._stderr_lines)
+            self._stderr_lines = []
+        return text
     
     def _read_line_with_timeout(self, timeout: float) -> Optional[str]:
         """Read a line from stdout with timeout."""
@@ -467,6 +488,8 @@ class LongLiveBot(BaseBotRunner):
                 is_first_turn=is_first_turn
             )
             metrics.memory_bytes = memory
+            # Printed before the move, so normally in by now; a late line counts for the next turn
+            metrics.search_stats = parse_search_stats(self._take_stderr())
             self.turn_metrics.append(metrics)
             
             # Check for violations
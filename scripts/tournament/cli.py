@@ -25,7 +25,8 @@ from .game_engine import GameEngine, GameResult, GameEndReason
 from .bot_runner import BotType
 from .resource_monitor import ResourceMonitor
 from .game_analyzer import GameAnalyzer, print_game_analysis
-from .utils import compile_bot, bot_exists, get_bot_path
+from .utils import compile_bot, bot_exists, get_bot_path, git_commit
+from . import perf_history
 
 
 def run_match(
@@ -399,7 +400,8 @@ def run_profile(
     memory_limit: int = 512 * 1024 * 1024,
     bot1_type: Optional[str] = None,
     bot2_type: Optional[str] = None,
-    profiles_dir: str = "profiles"
+    profiles_dir: str = "profiles",
+    history: Optional[str] = perf_history.DEFAULT_HISTORY
 ) -> Optional[GameResult]:
     """
     Run a profiling match between two bots with detailed per-turn time/memory tracking.
@@ -419,11 +421,13 @@ def run_profile(
         bot1_type: Force bot type ('long_live', 'traditional', or None for auto)
         bot2_type: Force bot type ('long_live', 'traditional', or None for auto)
         profiles_dir: Directory to store profile outputs
+        history: Performance history to add the CSV to, keyed by the current
+            git commit (None to skip, see perf_history.py)
     
     Returns:
         GameResult if match completed, None if setup failed
     """
-    from .resource_monitor import TurnMetrics, format_time, format_bytes
+    from .resource_monitor import TurnMetrics, SEARCH_STATS_FIELDS, format_time, format_bytes
     
     # Create profiles directory
     os.makedirs(profiles_dir, exist_ok=True)
@@ -500,7 +504,8 @@ def run_profile(
             "memory_limit_mb": memory_limit_mb,
             "time_limit": metrics.time_limit,
             "is_first_turn": metrics.is_first_turn,
-            "violation": metrics.violation.value
+            "violation": metrics.violation.value,
+            **{f: metrics.search_stats.get(f, "") for f in SEARCH_STATS_FIELDS}
         })
     
     for metrics in bot2_turns:
@@ -515,12 +520,20 @@ def run_profile(
             "memory_limit_mb": memory_limit_mb,
             "time_limit": metrics.time_limit,
             "is_first_turn": metrics.is_first_turn,
-            "violation": metrics.violation.value
+            "violation": metrics.violation.value,
+            **{f: metrics.search_stats.get(f, "") for f in SEARCH_STATS_FIELDS}
         })
     
     # Sort by turn number
     all_turn_data.sort(key=lambda x: x["turn"])
     
+    # Search statistics columns only when a bot was built with -DSEARCH_STATS=1
+    has_search_stats = any(t.search_stats for t in bot1_turns + bot2_turns)
+    if not has_search_stats:
+        for data in all_turn_data:
+            for f in SEARCH_STATS_FIELDS:
+                del data[f]
+    
     # Print per-turn data
     for data in all_turn_data:
         move_str = data["move"][:22] + ".." if len(data["move"]) > 24 else data["move"]
@@ -609,15 +622,23 @@ def run_profile(
         output_csv = os.path.join(profiles_dir, f"{base_filename}.csv")
     
     with open(output_csv, 'w', newline='') as f:
-        writer = csv.DictWriter(f, fieldnames=[
+        fieldnames = [
             "turn", "player", "move", "time_seconds", "memory_bytes", 
             "memory_mb", "memory_limit_mb", "time_limit", "is_first_turn", "violation"
-        ])
+        ]
+        if has_search_stats:
+            fieldnames += SEARCH_STATS_FIELDS
+        writer = csv.DictWriter(f, fieldnames=fieldnames, extrasaction='ignore')
         writer.writeheader()
         writer.writerows(all_turn_data)
     
     print(f"\n✓ CSV profile saved to: {output_csv}")
     
+    commit = git_commit()
+    if history:
+        perf_history.ingest([output_csv], commit=commit, history=history)
+        print(f"✓ Added to performance history: {history} (commit {commit})")
+    
     # Save JSON if requested
     if output_json:
         json_data = {
@@ -628,6 +649,7 @@ def run_profile(
                 "loser": result.loser,
                 "end_reason": result.end_reason.value,
                 "total_turns": result.total_turns,
+                "commit": commit,
                 "timestamp": datetime.now().isoformat()
             },
             "settings": {
@@ -774,6 +796,11 @@ Examples:
   %(prog)s profile bot026 bot027 --json           # Also save JSON output
   %(prog)s profile bot026 bot027 -o myprofile.csv # Custom output filename
   
+  %(prog)s perf ingest bench.json                 # Add tools/bench --json output to the history
+  %(prog)s perf ingest old.csv --commit 02e1d72   # Add a profile CSV measured at that commit
+  %(prog)s perf report                            # Write reports/perf_dashboard.md
+  %(prog)s perf check --threshold 0.1             # Exit 1 on a regression beyond 10%%
+  
   %(prog)s test bot015                            # Test traditional bot support
   %(prog)s compile bot015                         # Compile a bot
   
@@ -874,6 +901,25 @@ Time Limits (default Botzone):
                                help="Force bot1 type (default: auto-detect)")
     profile_parser.add_argument("--bot2-type", choices=['long_live', 'traditional'],
                                help="Force bot2 type (default: auto-detect)")
+    profile_parser.add_argument("--no-history", action="store_true",
+                               help="Don't add the profile to the performance history")
+    
+    # Perf command
+    perf_parser = subparsers.add_parser("perf",
+        help="Performance history: iterations/s, peak RSS and time headroom by commit")
+    perf_parser.add_argument("action", choices=['ingest', 'report', 'check'],
+                            help="ingest: add files to the history; report: write the dashboard; "
+                                 "check: exit 1 on a regression")
+    perf_parser.add_argument("files", nargs="*",
+                            help="Profile CSV/JSON or tools/bench JSON files (ingest)")
+    perf_parser.add_argument("--commit",
+                            help="Commit the ingested files measured (default: bench JSON's own, else unknown)")
+    perf_parser.add_argument("--history", default=perf_history.DEFAULT_HISTORY,
+                            help=f"History file (default: {perf_history.DEFAULT_HISTORY})")
+    perf_parser.add_argument("--threshold", type=float, default=perf_history.DEFAULT_THRESHOLD,
+                            help=f"Regression threshold as a fraction (default: {perf_history.DEFAULT_THRESHOLD})")
+    perf_parser.add_argument("-o", "--output", default=os.path.join("reports", "perf_dashboard.md"),
+                            help="Dashboard path (report, default: reports/perf_dashboard.md)")
     
     # Test command
     test_parser = subparsers.add_parser("test", help="Run a test")
@@ -958,9 +1004,32 @@ Time Limits (default Botzone):
                 turn_time=args.turn_time,
                 memory_limit=args.memory * 1024 * 1024,
                 bot1_type=args.bot1_type,
-                bot2_type=args.bot2_type
+                bot2_type=args.bot2_type,
+                history=None if args.no_history else perf_history.DEFAULT_HISTORY
             )
             return 0 if result else 1
+        
+        elif args.command == "perf":
+            if args.action == "ingest":
+                if not args.files:
+                    print("✗ perf ingest needs at least one file")
+                    return 1
+                n = perf_history.ingest(args.files, commit=args.commit, history=args.history)
+                print(f"✓ {n} entries added to {args.history}")
+                return 0
+            entries = perf_history.load_history(args.history)
+            if args.action == "report":
+                os.makedirs(os.path.dirname(args.output) or ".", exist_ok=True)
+                with open(args.output, 'w') as f:
+                    f.write(perf_history.render_dashboard(entries, args.threshold))
+                print(f"✓ Dashboard saved to: {args.output}")
+                return 0
+            regressions = perf_history.check_regressions(entries, args.threshold)
+            for r in regressions:
+                print(f"✗ {r}")
+            if not regressions:
+                print(f"✓ No regressions beyond {args.threshold:.0%}")
+            return 1 if regressions else 0
             
         elif args.command == "test":
             success = run_test(args.test_name, verbose)
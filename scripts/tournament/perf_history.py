@@ -0,0 +1,295 @@
+"""
+Performance history of the bots across versions.
+
+Ingests the per-turn CSVs of the profile command (profiles/profile_*.csv, see
+run_profile in cli.py) and the JSON of tools/bench into one history file,
+profiles/perf_history.jsonl: one line per source file, kind and bot, keyed by
+the commit that was measured. From the history it computes, per bot and commit:
+
+- iterations per second: per turn from the SEARCH_STATS counters (bots built
+  with -DSEARCH_STATS=1 report iterations; time_seconds is the runner's), and
+  per phase from tools/bench's iteration kernel (1e9 / ns_per_op)
+- peak RSS per turn of the bot (memory_mb), and over the game
+- time-limit headroom: (time_limit - time_seconds) / time_limit over the bot's
+  turns, as min / p5 / p50 quantiles
+
+check_regressions() compares each bot's newest commit with the one measured
+before it and flags changes beyond a threshold (a fraction, 0.15 = 15%): fewer
+iterations per second, a higher peak RSS, a slower bench kernel, or p5
+headroom down by more than threshold of the time limit (or below zero).
+render_dashboard() writes it all as a markdown report.
+"""
+
+import csv
+import json
+import os
+from datetime import datetime
+from typing import Any, Dict, List, Optional, Tuple
+
+DEFAULT_HISTORY = os.path.join("profiles", "perf_history.jsonl")
+DEFAULT_THRESHOLD = 0.15
+
+# Turn buckets of the per-turn RSS table: (label, first turn, last turn)
+RSS_BUCKETS = [("t1", 1, 1), ("t2-5", 2, 5), ("t6-10", 6, 10), ("t11-20", 11, 20), ("t21+", 21, 10**6)]
+
+
+def quantile(values: List[float], q: float) -> float:
+    """q-quantile of values by linear interpolation; values must not be empty."""
+    s = sorted(values)
+    pos = (len(s) - 1) * q
+    lo = int(pos)
+    hi = min(lo + 1, len(s) - 1)
+    return s[lo] + (s[hi] - s[lo]) * (pos - lo)
+
+
+def _float(value: Any) -> Optional[float]:
+    try:
+        return float(value)
+    except (TypeError, ValueError):
+        return None
+
+
+def summarize_turns(rows: List[Dict[str, str]]) -> Dict[str, Any]:
+    """Metrics of one bot's turns in a profile CSV (rows in game order)."""
+    rss_by_turn: Dict[str, float] = {}
+    headroom: List[float] = []
+    rates: List[float] = []
+    violations = 0
+    for k, row in enumerate(rows):
+        turn = str(k + 1)  # The bot's own turn number
+        mb = _float(row.get("memory_mb")) or 0.0
+        rss_by_turn[turn] = max(rss_by_turn.get(turn, 0.0), mb)
+        t = _float(row.get("time_seconds"))
+        limit = _float(row.get("time_limit"))
+        if t is not None and limit:
+            headroom.append((limit - t) / limit)
+        iterations = _float(row.get("iterations"))
+        if iterations and t:
+            rates.append(iterations / t)
+        if row.get("violation", "none") not in ("none", ""):
+            violations += 1
+    return {
+        "turns": len(rows),
+        "iterations_per_second": sum(rates) / len(rates) if rates else None,
+        "peak_rss_mb": max(rss_by_turn.values()) if rss_by_turn else 0.0,
+        "rss_by_turn": rss_by_turn,
+        "headroom": {
+            "min": min(headroom),
+            "p5": quantile(headroom, 0.05),
+            "p50": quantile(headroom, 0.5),
+        } if headroom else None,
+        "violations": violations,
+    }
+
+
+def profile_entries(rows: List[Dict[str, Any]], commit: str, source: str) -> List[Dict[str, Any]]:
+    """History entries of one profiled game's turn rows, one per player."""
+    by_bot: Dict[str, List[Dict[str, str]]] = {}
+    for row in sorted(rows, key=lambda r: int(r["turn"])):
+        by_bot.setdefault(row["player"], []).append(row)
+    entries = []
+    for bot, turns in by_bot.items():
+        entry = {"kind": "profile", "bot": bot, "commit": commit, "source": source}
+        entry.update(summarize_turns(turns))
+        entries.append(entry)
+    return entries
+
+
+def read_profile_csv(path: str, commit: str) -> List[Dict[str, Any]]:
+    """History entries of a profile CSV."""
+    with open(path, newline="") as f:
+        return profile_entries(list(csv.DictReader(f)), commit, path)
+
+
+def bench_entries(data: Dict[str, Any], commit: Optional[str], source: str) -> List[Dict[str, Any]]:
+    """History entries of a tools/bench JSON run, one per implementation."""
+    commit = commit or data.get("commit") or "unknown"
+    by_impl: Dict[str, Dict[str, Any]] = {}
+    for r in data.get("results", []):
+        e = by_impl.setdefault(r["impl"], {"kind": "bench", "bot": r["impl"], "commit": commit, "source": source,
+                                           "kernels": {}, "iterations_per_second": {}})
+        e["kernels"][f"{r['kernel']}/{r['phase']}"] = r["ns_per_op"]
+        if r["kernel"] == "iteration" and r["ns_per_op"] > 0:
+            e["iterations_per_second"][r["phase"]] = 1e9 / r["ns_per_op"]
+    return list(by_impl.values())
+
+
+def read_file(path: str, commit: Optional[str] = None) -> List[Dict[str, Any]]:
+    """
+    History entries of a profile CSV, a profile JSON (profile --json) or a
+    tools/bench JSON ("schema": "amazons-bench/1"). Bench JSON records its
+    commit; the profile outputs carry the commit in match.commit if they were
+    written by a run_profile that records it, else commit or "unknown".
+    """
+    if not path.endswith(".json"):
+        return read_profile_csv(path, commit or "unknown")
+    with open(path) as f:
+        data = json.load(f)
+    if str(data.get("schema", "")).startswith("amazons-bench/"):
+        return bench_entries(data, commit, path)
+    if "turns" in data:
+        commit = commit or data.get("match", {}).get("commit") or "unknown"
+        return profile_entries(data["turns"], commit, path)
+    raise ValueError(f"{path}: neither a profile nor a tools/bench JSON")
+
+
+def load_history(path: str = DEFAULT_HISTORY) -> List[Dict[str, Any]]:
+    if not os.path.exists(path):
+        return []
+    with open(path) as f:
+        return [json.loads(line) for line in f if line.strip()]
+
+
+def ingest(paths: List[str], commit: Optional[str] = None, history: str = DEFAULT_HISTORY) -> int:
+    """
+    Add profile and bench outputs (see read_file) to the history; returns the
+    entries added. A file ingested again replaces its earlier entries.
+    """
+    entries = load_history(history)
+    added = []
+    for path in paths:
+        new = read_file(path, commit)
+        stamp = datetime.now().isoformat(timespec="seconds")
+        for e in new:
+            e["recorded"] = stamp
+        entries = [e for e in entries if e["source"] != path]
+        added += new
+    entries += added
+    os.makedirs(os.path.dirname(history) or ".", exist_ok=True)
+    with open(history, "w") as f:
+        for e in entries:
+            f.write(json.dumps(e, sort_keys=True) + "\n")
+    return len(added)
+
+
+def by_commit(entries: List[Dict[str, Any]]) -> Dict[Tuple[str, str], List[Tuple[str, List[Dict[str, Any]]]]]:
+    """(kind, bot) -> [(commit, entries)] in the order the commits were first recorded."""
+    groups: Dict[Tuple[str, str], List[Tuple[str, List[Dict[str, Any]]]]] = {}
+    for e in entries:
+        commits = groups.setdefault((e["kind"], e["bot"]), [])
+        for c, es in commits:
+            if c == e["commit"]:
+                es.append(e)
+                break
+        else:
+            commits.append((e["commit"], [e]))
+    return groups
+
+
+def combine_profiles(entries: List[Dict[str, Any]]) -> Dict[str, Any]:
+    """One commit's profile runs of a bot: mean rate, worst RSS and headroom."""
+    rates = [e["iterations_per_second"] for e in entries if e.get("iterations_per_second")]
+    rooms = [e["headroom"] for e in entries if e.get("headroom")]
+    rss_by_turn: Dict[str, float] = {}
+    for e in entries:
+        for t, mb in e["rss_by_turn"].items():
+            rss_by_turn[t] = max(rss_by_turn.get(t, 0.0), mb)
+    return {
+        "runs": len(entries),
+        "turns": sum(e["turns"] for e in entries),
+        "iterations_per_second": sum(rates) / len(rates) if rates else None,
+        "peak_rss_mb": max(e["peak_rss_mb"] for e in entries),
+        "rss_by_turn": rss_by_turn,
+        "headroom": {k: min(r[k] for r in rooms) for k in ("min", "p5", "p50")} if rooms else None,
+        "violations": sum(e["violations"] for e in entries),
+    }
+
+
+def combine_bench(entries: List[Dict[str, Any]]) -> Dict[str, float]:
+    """One commit's bench runs of an implementation: the fastest time per kernel."""
+    kernels: Dict[str, float] = {}
+    for e in entries:
+        for k, ns in e["kernels"].items():
+            kernels[k] = min(kernels.get(k, ns), ns)
+    return kernels
+
+
+def check_regressions(entries: List[Dict[str, Any]], threshold: float = DEFAULT_THRESHOLD) -> List[str]:
+    """Regressions of each bot's newest commit against the commit before it."""
+    found = []
+    for (kind, bot), commits in sorted(by_commit(entries).items()):
+        if len(commits) < 2:
+            continue
+        (old_c, old_es), (new_c, new_es) = commits[-2], commits[-1]
+        tag = f"{bot} {old_c} -> {new_c}:"
+        if kind == "bench":
+            old, new = combine_bench(old_es), combine_bench(new_es)
+            for k in sorted(set(old) & set(new)):
+                if old[k] > 0 and new[k] > old[k] * (1 + threshold):
+                    found.append(f"{tag} {k} {old[k]:.1f} -> {new[k]:.1f} ns/op ({new[k] / old[k] - 1:+.0%})")
+            continue
+        old, new = combine_profiles(old_es), combine_profiles(new_es)
+        a, b = old["iterations_per_second"], new["iterations_per_second"]
+        if a and b and b < a * (1 - threshold):
+            found.append(f"{tag} {a:.0f} -> {b:.0f} iterations/s ({b / a - 1:+.0%})")
+        a, b = old["peak_rss_mb"], new["peak_rss_mb"]
+        if a > 0 and b > a * (1 + threshold):
+            found.append(f"{tag} peak RSS {a:.1f} -> {b:.1f} MB ({b / a - 1:+.0%})")
+        if new["headroom"]:
+            b = new["headroom"]["p5"]
+            a = old["headroom"]["p5"] if old["headroom"] else None
+            if b < 0:
+                found.append(f"{tag} p5 headroom {b:+.1%} of the time limit: over the limit")
+            elif a is not None and b < a - threshold:
+                found.append(f"{tag} p5 headroom {a:.1%} -> {b:.1%} of the time limit")
+    return found
+
+
+def _cell(value: Optional[float], fmt: str) -> str:
+    return "-" if value is None else format(value, fmt)
+
+
+def render_dashboard(entries: List[Dict[str, Any]], threshold: float = DEFAULT_THRESHOLD) -> str:
+    """The history as a markdown report, commits of each bot oldest first."""
+    groups = by_commit(entries)
+    out = ["# Performance dashboard", "",
+           f"Generated {datetime.now().isoformat(timespec='seconds')} from {len(entries)} history entries.", ""]
+
+    out += ["## Profiles", "",
+            "| bot | commit | runs | turns | iterations/s | peak RSS MB | headroom min | p5 | p50 | violations |",
+            "|---|---|---|---|---|---|---|---|---|---|"]
+    rss_rows = []
+    for (kind, bot), commits in sorted(groups.items()):
+        if kind != "profile":
+            continue
+        for commit, es in commits:
+            p = combine_profiles(es)
+            h = p["headroom"] or {}
+            out.append(f"| {bot} | {commit} | {p['runs']} | {p['turns']} | {_cell(p['iterations_per_second'], '.0f')} "
+                       f"| {_cell(p['peak_rss_mb'] or None, '.1f')} | {_cell(h.get('min'), '.1%')} | {_cell(h.get('p5'), '.1%')} "
+                       f"| {_cell(h.get('p50'), '.1%')} | {p['violations']} |")
+            cells = []
+            for _, first, last in RSS_BUCKETS:
+                mbs = [mb for t, mb in p["rss_by_turn"].items() if first <= int(t) <= last and mb > 0]
+                cells.append(f"{max(mbs):.1f}" if mbs else "-")
+            rss_rows.append(f"| {bot} | {commit} | " + " | ".join(cells) + " |")
+
+    out += ["", "## Peak RSS by turn (MB)", "",
+            "| bot | commit | " + " | ".join(label for label, _, _ in RSS_BUCKETS) + " |",
+            "|---|---|" + "---|" * len(RSS_BUCKETS)] + rss_rows
+
+    out += ["", "## Iterations per second (tools/bench, fastest run per commit)", "",
+            "| bot | commit | opening | midgame | endgame |", "|---|---|---|---|---|"]
+    for (kind, bot), commits in sorted(groups.items()):
+        if kind != "bench":
+            continue
+        for commit, es in commits:
+            ns = combine_bench(es)
+            rates = [1e9 / ns[k] if ns.get(k) else None for k in ("iteration/opening", "iteration/midgame", "iteration/endgame")]
+            out.append(f"| {bot} | {commit} | " + " | ".join(_cell(r, ".0f") for r in rates) + " |")
+
+    out += ["", "## Benchmarks (ns/op, fastest run per commit)", ""]
+    for (kind, bot), commits in sorted(groups.items()):
+        if kind != "bench":
+            continue
+        kernels = sorted({k for _, es in commits for k in combine_bench(es)})
+        out += [f"### {bot}", "", "| commit | " + " | ".join(kernels) + " |", "|---|" + "---|" * len(kernels)]
+        for commit, es in commits:
+            ns = combine_bench(es)
+            out.append(f"| {commit} | " + " | ".join(_cell(ns.get(k), ".1f") for k in kernels) + " |")
+        out.append("")
+
+    found = check_regressions(entries, threshold)
+    out += [f"## Regressions (threshold {threshold:.0%})", ""]
+    out += [f"- {r}" for r in found] if found else ["None."]
+    return "\n".join(out) + "\n"
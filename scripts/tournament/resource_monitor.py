@@ -33,6 +33,46 @@ class TurnMetrics:
     time_limit: float = 0.0
     memory_limit: int = 0
     violation: ViolationType = ViolationType.NONE
+    # Fields of the bot's SEARCH_STATS stderr line, if it printed one
+    search_stats: Dict[str, Any] = field(default_factory=dict)
+
+
+# Columns of a SEARCH_STATS line (bots built with -DSEARCH_STATS=1), in order
+SEARCH_STATS_FIELDS = [
+    "engine", "iterations", "nodes", "peak_nodes", "max_depth", "avg_depth",
+    "rss_mb", "faults", "stop", "select_ms", "expand_ms", "evaluate_ms", "backup_ms"
+]
+
+
+def parse_search_stats(stderr_text: str) -> Dict[str, Any]:
+    """
+    Parse the last SEARCH_STATS line of a bot's stderr.
+    
+    The line is "SEARCH_STATS key=value ...". Numeric values are converted;
+    turn and time_ms are dropped since the runner measures both itself.
+    Lines of a ponder search (engine=ponder, run on the opponent's time) are
+    skipped.
+    
+    Returns:
+        Dict of the fields, empty if no such line was printed.
+    """
+    stats: Dict[str, Any] = {}
+    for line in stderr_text.splitlines():
+        if not line.startswith("SEARCH_STATS ") or " engine=ponder " in line:
+            continue
+        stats = {}
+        for token in line.split()[1:]:
+            key, sep, value = token.partition("=")
+            if not sep or key in ("turn", "time_ms"):
+                continue
+            try:
+                stats[key] = int(value)
+            except ValueError:
+                try:
+                    stats[key] = float(value)
+                except ValueError:
+                    stats[key] = value
+    return stats
 
 
 @dataclass
@@ -65,3 +65,21 @@ def get_bot_path(bot_name: str) -> str:
         Full path to bot executable
     """
     return f"./bots/{bot_name}"
+
+
+def git_commit() -> str:
+    """
+    Short hash of the checked-out commit, as tools/bench records it.
+    
+    Returns:
+        The hash, or 'unknown' outside a git checkout
+    """
+    try:
+        result = subprocess.run(
+            ["git", "rev-parse", "--short", "HEAD"],
+            capture_output=True,
+            text=True
+        )
+    except OSError:
+        return "unknown"
+    return result.stdout.strip() if result.returncode == 0 and result.stdout.strip() else "unknown"
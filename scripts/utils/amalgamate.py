@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+"""
+Amalgamate a bot built on the C++ engine core into one Botzone source file.
+
+Every #include "..." is replaced by the file it names, recursively and once
+per file (the core headers have include guards, so a second copy would be empty
+anyway). System includes (#include <...>) are kept as they are.
+
+--profile NAME defines AMAZONS_PROFILE at the top, which selects the named
+profile of engine/profiles.h in engine/bots/profile.cpp.
+
+Usage:
+    python3 scripts/utils/amalgamate.py engine/bots/bot034.cpp bots/bot034.cpp
+    python3 scripts/utils/amalgamate.py --profile PhasedProfile engine/bots/profile.cpp bots/NAME.cpp
+"""
+
+import argparse
+import re
+import sys
+from pathlib import Path
+
+INCLUDE = re.compile(r'^\s*#\s*include\s+"([^"]+)"')
+
+
+def amalgamate(path: Path, seen: set) -> list:
+    """Lines of path with its local includes inlined."""
+    path = path.resolve()
+    if path in seen:
+        return []
+    seen.add(path)
+    out = []
+    for line in path.read_text().splitlines():
+        m = INCLUDE.match(line)
+        if m:
+            target = path.parent / m.group(1)
+            if not target.exists():
+                sys.exit(f"{path}: cannot find {m.group(1)}")
+            out.append(f"// ---- begin {target.resolve().name} ----")
+            out.extend(amalgamate(target, seen))
+            out.append(f"// ---- end {target.resolve().name} ----")
+        else:
+            out.append(line)
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("source", help="entry file, e.g. engine/bots/bot034.cpp")
+    parser.add_argument("output", help="single-file bot, e.g. bots/bot034.cpp")
+    parser.add_argument("--profile", help="profile of engine/profiles.h, e.g. PhasedProfile")
+    args = parser.parse_args()
+
+    source = Path(args.source)
+    lines = [f"// Generated by scripts/utils/amalgamate.py from {args.source} - do not edit"]
+    if args.profile:
+        if not re.fullmatch(r"\w+", args.profile):
+            sys.exit(f"not a profile name: {args.profile}")
+        lines.append(f"#define AMAZONS_PROFILE {args.profile}")
+    lines += amalgamate(source, set())
+    Path(args.output).write_text("\n".join(lines) + "\n")
+    print(f"Wrote {args.output} ({len(lines)} lines)")
+
+
+if __name__ == "__main__":
+    main()
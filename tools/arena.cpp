@@ -0,0 +1,676 @@
+// arena.cpp - in-process match runner for two engine builds
+// Both bots are compiled into this binary, each in its own namespace behind the
+// Engine interface (tools/engine.h), so a game is a loop of think()/play() calls
+// with no processes, pipes or history rebuilding. --jobs worker processes (one
+// per allowed CPU by default) play the games; each holds one instance of both
+// engines, is pinned to its own CPU so no two games share a core and skew each
+// other's clocks, and takes the next unplayed game from a counter in shared
+// memory, so a worker stuck in long games never leaves the others idle. Games
+// come in pairs that share a random opening with colours swapped. The parent
+// prints the score, the Elo difference of A over B with its 95% interval and,
+// with --sprt, stops as soon as the sequential probability ratio test accepts
+// either hypothesis. --jsonl writes one line per finished game, as it arrives,
+// and a summary line at the end. --log writes every game with its moves and
+// the players' time and memory per move as a binary game log (tools/gamelog.h).
+// --bot-a/--bot-b PATH replace an engine with a compiled Botzone bot run once
+// per move (tools/process_engine.h), e.g. bots/bot032 against bots/opponent;
+// such a bot keeps its own clock and ignores --movetime and --nodes.
+// --tune and --worker run distributed SPSA tuning of the bot's tunables
+// (get_tunable/set_tunable; protocol and schedule in tools/tune.h): the
+// coordinator plays no games, and each worker, on any host, plays batches of
+// theta+ (A) against theta- (B) games on all its cores. --tune takes name
+// prefixes ("ucb" for the exploration schedule, "w" for the evaluation
+// weights, "all"); theta is rewritten to --tune-out after every batch.
+// Build: g++ -O3 -std=c++11 -o tools/arena tools/arena.cpp
+//        [-DENGINE_A='"path/a.cpp"'] [-DENGINE_B='"path/b.cpp"']
+//        Both default to bots/bot033.cpp. Compile-time options of one side go
+//        in a wrapper file (#define LEAF_BATCH 8, then #include the bot), since
+//        -D flags would reach only engine A. A source must provide what
+//        tools/bot_engine.inc calls (choose_move, search_node_limit, ...), as
+//        bot033 does from this version on.
+// Usage: tools/arena [--games N] [--jobs J] [--no-pin] [--movetime S] [--nodes N]
+//                    [--openings K] [--seed X] [--engine-a mcts|pvs|hybrid]
+//                    [--engine-b ...] [--bot-a PATH] [--bot-b PATH]
+//                    [--sprt ELO0 ELO1] [--jsonl FILE] [--log FILE]
+//        tools/arena --tune PREFIX[,PREFIX...] --listen PORT [--tune-pairs N]
+//                    [--tune-step F] [--tune-rate R] [--batch G] [--tune-out FILE]
+//                    [--movetime S] [--nodes N] [--openings K] [--seed X]
+//        tools/arena --worker HOST:PORT [--jobs J] [--no-pin]
+
+// Everything the bots include, so their own #includes add nothing to the namespaces
+#include <iostream>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <sstream>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <signal.h>
+#include <limits.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/wait.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <memory>
+#include "engine.h"
+#include "gamelog.h"
+#include "process_engine.h"
+#include "tune.h"
+
+#ifndef ENGINE_A
+#define ENGINE_A "../bots/bot033.cpp"
+#endif
+#ifndef ENGINE_B
+#define ENGINE_B "../bots/bot033.cpp"
+#endif
+
+namespace engine_a {
+#define main bot_main
+#include ENGINE_A
+#undef main
+#include "bot_engine.inc"
+}
+
+// Configuration macros of the first build must not leak into the second
+#undef TWO_LEVEL_TREE
+#undef LONG_RUNNING
+#undef SEARCH_THREADS
+#undef SEARCH_ENGINE
+#undef SIMD_LEVEL
+#undef RSS_SOFT_LIMIT_MB
+#undef RSS_HARD_LIMIT_MB
+#undef EVAL_NNUE
+#undef PROGRESSIVE_WIDENING
+#undef TRANSPOSITION_TABLE
+#undef EVAL_QUEEN_TERRITORY
+#undef ENDGAME_SOLVER
+#undef LEAF_BATCH
+#undef HUGE_PAGES
+#undef REGION_CACHE
+#undef ROLLOUT_PLIES
+#undef ROLLOUT_OPENING
+#undef ROLLOUT_MIDGAME
+#undef ROLLOUT_ENDGAME
+#undef EARLY_STOP
+#undef MCTS_SOLVER
+#undef ROOT_PREFILTER
+#undef SEARCH_STATS
+#undef OPENING_BOOK
+#undef PONDER
+
+namespace engine_b {
+#define main bot_main
+#include ENGINE_B
+#undef main
+#include "bot_engine.inc"
+}
+
+using namespace std;
+
+struct Options {
+    int games = 100;
+    int jobs = 0;       // 0 for one per allowed CPU
+    bool pin = true;
+    EngineBudget budget = { 0, 0 };
+    int openings = 2;   // Random plies before the engines take over
+    uint32_t seed = 1;
+    int backend_a = -1;  // SearchEngine value, -1 for the build's default
+    int backend_b = -1;
+    bool sprt = false;
+    double elo0 = 0, elo1 = 5;
+    const char* bot_a = nullptr;  // Botzone executables instead of the linked engines
+    const char* bot_b = nullptr;
+    const char* jsonl = nullptr;
+    const char* log = nullptr;
+    // Tuning
+    const char* tune = nullptr;    // Name prefixes of the tuned parameters
+    int listen_port = 0;
+    const char* worker = nullptr;  // HOST:PORT of the coordinator
+    int tune_pairs = 10000;        // Game pairs in all
+    double tune_step = 0.1;        // c at the end, as a fraction of the start value
+    double tune_rate = 0.002;      // a / c^2 at the end
+    int batch = 0;                 // Games per job, 0 for two per worker core
+    const char* tune_out = "tune.txt";
+};
+
+struct GameResult {
+    int32_t game;
+    int8_t a_won;
+    int16_t plies;
+    int16_t worker;
+    float seconds;
+    uint8_t end;        // GameEnd
+    EngineMove moves[GAMELOG_MAX_PLIES];
+    TurnStat turns[GAMELOG_MAX_PLIES];
+};
+static_assert(sizeof(GameResult) <= PIPE_BUF, "results must stay atomic pipe writes");
+
+// The referee uses engine A's board and move generator
+typedef engine_a::Board RefBoard;
+
+inline EngineMove to_engine(const engine_a::Move& m) {
+    EngineMove e = { m.from, m.to, m.arrow };
+    return e;
+}
+
+inline uint32_t mix(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352DU;
+    x ^= x >> 15;
+    x *= 0x846CA68BU;
+    return x ^ (x >> 16);
+}
+
+// Play game g: A is Black in even games. Returns 1 if A won; an illegal move loses.
+GameResult play_game(Engine& a, Engine& b, const Options& opt, int g) {
+    Engine* players[2] = { g % 2 == 0 ? &a : &b, g % 2 == 0 ? &b : &a };
+    a.reset();
+    b.reset();
+    RefBoard board;
+    int color = engine_a::BLACK;
+    static engine_a::Move moves[engine_a::MAX_MOVES];
+    uint32_t rng = mix(opt.seed * 0x9E3779B9U + g / 2);
+    GameResult r;
+    memset(&r, 0, sizeof(r));
+    r.game = g;
+    for (int ply = 0;; ply++) {
+        int side = RefBoard::side(color);
+        int n = engine_a::generate_moves(board, color, moves);
+        if (n == 0) {
+            r.a_won = (players[side] != &a);
+            r.plies = (int16_t)ply;
+            r.end = END_NO_MOVES;
+            return r;
+        }
+        EngineMove m;
+        if (ply < opt.openings) {
+            rng = mix(rng + ply);
+            m = to_engine(moves[rng % n]);
+        } else {
+            auto start = chrono::steady_clock::now();
+            m = players[side]->think(opt.budget);
+            r.turns[ply].time_us = (uint32_t)chrono::duration_cast<chrono::microseconds>(
+                chrono::steady_clock::now() - start).count();
+            r.turns[ply].rss_kb = (uint32_t)(players[side]->resident() >> 10);
+            engine_a::Move mv(m.from, m.to, m.arrow);
+            if (find(moves, moves + n, mv) == moves + n) {
+                fprintf(stderr, "game %d: %s played an illegal move %d %d %d\n", g, players[side]->name(),
+                        m.from, m.to, m.arrow);
+                r.a_won = (players[side] != &a);
+                r.plies = (int16_t)ply;
+                r.end = END_ILLEGAL_MOVE;
+                return r;
+            }
+        }
+        r.moves[ply] = m;
+        board.apply_move(engine_a::Move(m.from, m.to, m.arrow));
+        a.play(m);
+        b.play(m);
+        color = -color;
+    }
+}
+
+// Expected score of a player stronger by elo
+inline double elo_to_score(double elo) {
+    return 1 / (1 + pow(10.0, -elo / 400));
+}
+
+inline double score_to_elo(double s) {
+    s = min(max(s, 1e-4), 1 - 1e-4);
+    return -400 * log10(1 / s - 1);
+}
+
+// Log-likelihood ratio of H1 (elo1) over H0 (elo0); Amazons has no draws
+inline double sprt_llr(int wins, int losses, double elo0, double elo1) {
+    double p0 = elo_to_score(elo0), p1 = elo_to_score(elo1);
+    return wins * log(p1 / p0) + losses * log((1 - p1) / (1 - p0));
+}
+
+void report(const Options& opt, int wins, int losses, int plies, double secs, bool final) {
+    int n = wins + losses;
+    double s = n ? (double)wins / n : 0.5;
+    double margin = n ? 1.96 * sqrt(s * (1 - s) / n) : 0.5;
+    fprintf(stderr, "%s%d games: A %d - %d B, score %.3f, Elo %+.1f [%+.1f, %+.1f], %.1f plies/game, %.1f s",
+            final ? "final: " : "", n, wins, losses, s, score_to_elo(s), score_to_elo(s - margin),
+            score_to_elo(s + margin), n ? (double)plies / n : 0.0, secs);
+    if (opt.sprt) fprintf(stderr, ", LLR %.2f", sprt_llr(wins, losses, opt.elo0, opt.elo1));
+    fprintf(stderr, "\n");
+}
+
+// One line per game for --jsonl; opening is the pair index, shared by games 2k and 2k+1
+void write_game(FILE* f, const GameResult& r) {
+    fprintf(f,
+            "{\"type\": \"game\", \"game\": %d, \"opening\": %d, \"a_color\": \"%s\", \"winner\": \"%s\", "
+            "\"plies\": %d, \"worker\": %d, \"seconds\": %.3f}\n",
+            r.game, r.game / 2, r.game % 2 == 0 ? "black" : "white", r.a_won ? "A" : "B", r.plies, r.worker,
+            r.seconds);
+    fflush(f);
+}
+
+// CPUs this process may run on, in order
+vector<int> allowed_cpus() {
+    vector<int> cpus;
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        for (int c = 0; c < CPU_SETSIZE; c++)
+            if (CPU_ISSET(c, &set)) cpus.push_back(c);
+    return cpus;
+}
+
+void pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) perror("sched_setaffinity");
+}
+
+// Name of a bot for the game log: its file name without directory or extension
+string player_name(const char* path) {
+    string s = path;
+    size_t slash = s.find_last_of('/');
+    if (slash != string::npos) s = s.substr(slash + 1);
+    size_t dot = s.find('.');
+    return dot == string::npos ? s : s.substr(0, dot);
+}
+
+void log_game(GameLogWriter& log, const GameResult& r, const Options& opt) {
+    GameRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.plies = (uint16_t)r.plies;
+    // The player to move at ply `plies` lost; A is Black in even games
+    int loser = r.plies % 2;
+    rec.winner = (int8_t)(1 - loser);
+    rec.end = r.end;
+    rec.opening = (uint16_t)min((int)r.plies, opt.openings);
+    string a = player_name(opt.bot_a ? opt.bot_a : ENGINE_A), b = player_name(opt.bot_b ? opt.bot_b : ENGINE_B);
+    if (a == b) a += "-A", b += "-B";
+    const string& black = r.game % 2 == 0 ? a : b;
+    const string& white = r.game % 2 == 0 ? b : a;
+    strncpy(rec.players[0], black.c_str(), sizeof(rec.players[0]) - 1);
+    strncpy(rec.players[1], white.c_str(), sizeof(rec.players[1]) - 1);
+    log.add(rec, r.moves, r.turns);
+}
+
+unique_ptr<Engine> make_engine(int side, const Options& opt) {
+    const char* bot = side == 0 ? opt.bot_a : opt.bot_b;
+    const char* label = side == 0 ? "A" : "B";
+    if (bot) return unique_ptr<Engine>(new ProcessEngine(label, bot));
+    if (side == 0) return unique_ptr<Engine>(new engine_a::BotEngine(label, opt.backend_a));
+    return unique_ptr<Engine>(new engine_b::BotEngine(label, opt.backend_b));
+}
+
+// Next unplayed game, shared by the pool's processes; nullptr on failure
+int* shared_counter() {
+    int* p = (int*)mmap(nullptr, sizeof(int), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        perror("mmap");
+        return nullptr;
+    }
+    return p;
+}
+
+// Fork opt.jobs pinned processes playing games [0, opt.games) and writing each
+// GameResult to fds[1]; the parent's write end is closed. Empty if fork failed.
+vector<pid_t> start_pool(const Options& opt, const vector<int>& cpus, int* next_game, int fds[2], FILE* jsonl) {
+    *next_game = 0;
+    vector<pid_t> pids;
+    for (int id = 0; id < opt.jobs; id++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            if (jsonl) fclose(jsonl);
+            if (opt.pin) pin_to_cpu(cpus[id]);
+            unique_ptr<Engine> a = make_engine(0, opt), b = make_engine(1, opt);
+            engine_a::seed_rng(id);
+            engine_b::seed_rng(id + opt.jobs);
+            for (;;) {
+                int g = __atomic_fetch_add(next_game, 1, __ATOMIC_RELAXED);
+                if (g >= opt.games) break;
+                auto start = chrono::steady_clock::now();
+                GameResult r = play_game(*a, *b, opt, g);
+                r.worker = (int16_t)id;
+                r.seconds = chrono::duration<float>(chrono::steady_clock::now() - start).count();
+                if (write(fds[1], &r, sizeof(r)) != (ssize_t)sizeof(r)) _exit(1);
+            }
+            _exit(0);
+        }
+        if (pid < 0) {
+            perror("fork");
+            for (pid_t p : pids) kill(p, SIGTERM);
+            pids.clear();
+            break;
+        }
+        pids.push_back(pid);
+    }
+    close(fds[1]);
+    return pids;
+}
+
+// --- TUNING ---
+// Worker: play the coordinator's batches until it sends games = 0 or goes away
+int run_worker(Options opt, const vector<int>& cpus) {
+    int fd = connect_to(opt.worker);
+    if (fd < 0) {
+        fprintf(stderr, "cannot connect to %s\n", opt.worker);
+        return 1;
+    }
+    TuneHello hello = { TUNE_MAGIC, (uint32_t)opt.jobs, (uint32_t)engine_a::NUM_TUNABLES };
+    if (!send_all(fd, &hello, sizeof(hello))) return 1;
+    int* next_game = shared_counter();
+    if (!next_game) return 1;
+    fprintf(stderr, "worker: connected to %s, %d jobs\n", opt.worker, opt.jobs);
+    TuneJob job;
+    vector<double> plus, minus;
+    while (recv_all(fd, &job, sizeof(job)) && job.magic == TUNE_MAGIC && job.games > 0) {
+        plus.resize(job.n_params);
+        minus.resize(job.n_params);
+        if (job.n_params != (uint32_t)engine_a::NUM_TUNABLES || !recv_all(fd, plus.data(), plus.size() * 8) ||
+            !recv_all(fd, minus.data(), minus.size() * 8))
+            break;
+        // The pool's processes inherit the parameters through fork
+        for (int i = 0; i < engine_a::NUM_TUNABLES; i++) {
+            engine_a::set_tunable(i, plus[i]);
+            engine_b::set_tunable(i, minus[i]);
+        }
+        opt.games = (int)job.games;
+        opt.seed = job.seed;
+        opt.openings = job.openings;
+        opt.budget.movetime = job.movetime;
+        opt.budget.nodes = job.nodes;
+        int fds[2];
+        if (pipe(fds) != 0) break;
+        vector<pid_t> pool = start_pool(opt, cpus, next_game, fds, nullptr);
+        GameResult r;
+        bool connected = !pool.empty();
+        while (connected && read(fds[0], &r, sizeof(r)) == (ssize_t)sizeof(r)) {
+            TuneGame t = { job.id, r.game, r.a_won, 0, r.plies };
+            connected = send_all(fd, &t, sizeof(t));
+        }
+        if (!connected)
+            for (pid_t pid : pool) kill(pid, SIGTERM);
+        close(fds[0]);
+        int status;
+        while (wait(&status) > 0) {}
+        TuneGame done = { job.id, -1, 0, 0, 0 };
+        if (!connected || !send_all(fd, &done, sizeof(done))) break;
+    }
+    close(fd);
+    fprintf(stderr, "worker: coordinator closed the connection\n");
+    return 0;
+}
+
+void write_theta(const Options& opt, const Spsa& spsa) {
+    FILE* f = fopen(opt.tune_out, "w");
+    if (!f) {
+        perror(opt.tune_out);
+        return;
+    }
+    fprintf(f, "# %d of %d game pairs\n", spsa.pairs, spsa.total_pairs);
+    for (size_t i = 0; i < spsa.theta.size(); i++)
+        if (spsa.tuned[i]) fprintf(f, "%s %.6g\n", engine_a::tunable_name((int)i), spsa.theta[i]);
+    fclose(f);
+}
+
+// Coordinator: hand out SPSA perturbations to whichever worker is idle
+int run_coordinator(const Options& opt) {
+    Spsa spsa;
+    spsa.total_pairs = max(1, opt.tune_pairs);
+    spsa.a_end_ratio = opt.tune_rate;
+    spsa.rng = opt.seed ? opt.seed : 1;
+    int n_tuned = 0;
+    for (int i = 0; i < engine_a::NUM_TUNABLES; i++) {
+        double v = engine_a::get_tunable(i);
+        string name = engine_a::tunable_name(i);
+        bool on = false;
+        stringstream prefixes(opt.tune);
+        for (string p; getline(prefixes, p, ',');)
+            if (p == "all" || name.compare(0, p.size(), p) == 0) on = true;
+        spsa.theta.push_back(v);
+        spsa.c.push_back(max(fabs(v) * opt.tune_step, 1e-4));
+        spsa.tuned.push_back(on);
+        n_tuned += on;
+    }
+    if (!n_tuned) {
+        fprintf(stderr, "--tune %s matches no parameter\n", opt.tune);
+        return 1;
+    }
+    int lfd = listen_on(opt.listen_port);
+    if (lfd < 0) {
+        perror("listen");
+        return 1;
+    }
+    fprintf(stderr, "tuning %d parameters over %d game pairs, listening on port %d\n", n_tuned,
+            spsa.total_pairs, opt.listen_port);
+
+    struct Worker {
+        int fd;
+        uint32_t cores;
+        int job;  // -1 when idle
+    };
+    struct Job {
+        vector<int8_t> delta;
+        int k;          // Pairs finished when it started
+        int games;
+        int a_minus_b;
+    };
+    vector<Worker> workers;
+    vector<Job> jobs;
+    int in_flight = 0; // Game pairs handed out and not finished
+    uint32_t seed = opt.seed;
+    auto t0 = chrono::steady_clock::now();
+    while (spsa.pairs < spsa.total_pairs) {
+        // Keep every idle worker busy while pairs remain
+        for (Worker& w : workers) {
+            int left = spsa.total_pairs - spsa.pairs - in_flight;
+            if (w.job >= 0 || left <= 0) continue;
+            int games = opt.batch > 0 ? opt.batch : 2 * (int)w.cores;
+            games = 2 * max(1, min(left, games / 2));
+            Job j;
+            vector<double> plus, minus;
+            spsa.perturb(plus, minus, j.delta);
+            j.k = spsa.pairs;
+            j.games = games;
+            j.a_minus_b = 0;
+            TuneJob msg = { TUNE_MAGIC, (uint32_t)jobs.size(), (uint32_t)games, seed++, opt.budget.nodes,
+                            opt.openings, opt.budget.movetime, (uint32_t)plus.size(), 0 };
+            if (send_all(w.fd, &msg, sizeof(msg)) && send_all(w.fd, plus.data(), plus.size() * 8) &&
+                send_all(w.fd, minus.data(), minus.size() * 8)) {
+                w.job = (int)jobs.size();
+                jobs.push_back(j);
+                in_flight += games / 2;
+            }
+        }
+        vector<pollfd> fds(1, pollfd{ lfd, POLLIN, 0 });
+        for (const Worker& w : workers) fds.push_back(pollfd{ w.fd, POLLIN, 0 });
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            perror("poll");
+            return 1;
+        }
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(lfd, nullptr, nullptr);
+            TuneHello hello;
+            if (fd >= 0 && recv_all(fd, &hello, sizeof(hello)) && hello.magic == TUNE_MAGIC &&
+                hello.n_params == (uint32_t)engine_a::NUM_TUNABLES) {
+                workers.push_back(Worker{ fd, max(1u, hello.cores), -1 });
+                fprintf(stderr, "worker %zu connected, %u cores\n", workers.size(), hello.cores);
+            } else if (fd >= 0) {
+                close(fd);
+            }
+        }
+        for (size_t i = workers.size(); i-- > 0;) {
+            if (!(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            Worker& w = workers[i];
+            TuneGame t;
+            bool alive = recv_all(w.fd, &t, sizeof(t));
+            if (alive && w.job >= 0 && t.job == (uint32_t)w.job) {
+                Job& j = jobs[w.job];
+                if (t.game >= 0) {
+                    j.a_minus_b += t.a_won ? 1 : -1;
+                    continue;
+                }
+                in_flight -= j.games / 2;
+                spsa.update(j.delta, j.k, j.a_minus_b, j.games / 2);
+                w.job = -1;
+                write_theta(opt, spsa);
+                double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+                fprintf(stderr, "%d/%d pairs, batch %+d, %.0f games/min, %zu workers\n", spsa.pairs,
+                        spsa.total_pairs, j.a_minus_b, secs > 0 ? 2 * spsa.pairs * 60 / secs : 0.0,
+                        workers.size());
+                continue;
+            }
+            // Gone (or talking nonsense): its batch is played again elsewhere
+            if (w.job >= 0) in_flight -= jobs[w.job].games / 2;
+            close(w.fd);
+            workers.erase(workers.begin() + i);
+            fprintf(stderr, "a worker left, %zu remain\n", workers.size());
+        }
+    }
+    TuneJob stop;
+    memset(&stop, 0, sizeof(stop));
+    stop.magic = TUNE_MAGIC;
+    for (const Worker& w : workers) {
+        send_all(w.fd, &stop, sizeof(stop));
+        close(w.fd);
+    }
+    close(lfd);
+    write_theta(opt, spsa);
+    fprintf(stderr, "theta written to %s\n", opt.tune_out);
+    return 0;
+}
+
+int parse_engine(const char* s) {
+    if (strcmp(s, "pvs") == 0) return engine_a::ENGINE_PVS;
+    if (strcmp(s, "hybrid") == 0) return engine_a::ENGINE_HYBRID;
+    return engine_a::ENGINE_MCTS;
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        string a = argv[i];
+        if (a == "--no-pin") {
+            opt.pin = false;
+            continue;
+        }
+        if (i + 1 >= argc) break;
+        if (a == "--games") opt.games = atoi(argv[++i]);
+        else if (a == "--jobs") opt.jobs = max(1, atoi(argv[++i]));
+        else if (a == "--movetime") opt.budget.movetime = atof(argv[++i]);
+        else if (a == "--nodes") opt.budget.nodes = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (a == "--openings") opt.openings = atoi(argv[++i]);
+        else if (a == "--seed") opt.seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (a == "--engine-a") opt.backend_a = parse_engine(argv[++i]);
+        else if (a == "--engine-b") opt.backend_b = parse_engine(argv[++i]);
+        else if (a == "--bot-a") opt.bot_a = argv[++i];
+        else if (a == "--bot-b") opt.bot_b = argv[++i];
+        else if (a == "--jsonl") opt.jsonl = argv[++i];
+        else if (a == "--log") opt.log = argv[++i];
+        else if (a == "--tune") opt.tune = argv[++i];
+        else if (a == "--listen") opt.listen_port = atoi(argv[++i]);
+        else if (a == "--worker") opt.worker = argv[++i];
+        else if (a == "--tune-pairs") opt.tune_pairs = atoi(argv[++i]);
+        else if (a == "--tune-step") opt.tune_step = atof(argv[++i]);
+        else if (a == "--tune-rate") opt.tune_rate = atof(argv[++i]);
+        else if (a == "--batch") opt.batch = atoi(argv[++i]);
+        else if (a == "--tune-out") opt.tune_out = argv[++i];
+        else if (a == "--sprt" && i + 2 < argc) {
+            opt.sprt = true;
+            opt.elo0 = atof(argv[++i]);
+            opt.elo1 = atof(argv[++i]);
+        }
+    }
+    // 0.1 s per move by default; a node budget alone gets a clock no move will reach
+    if (opt.budget.movetime <= 0) opt.budget.movetime = opt.budget.nodes ? 60 : 0.1;
+    vector<int> cpus = allowed_cpus();
+    if (cpus.empty()) cpus.push_back(0), opt.pin = false;
+    if (opt.jobs <= 0) opt.jobs = (int)cpus.size();
+    if (opt.jobs > (int)cpus.size() && opt.pin) {
+        fprintf(stderr, "%d jobs on %zu CPUs: not pinning\n", opt.jobs, cpus.size());
+        opt.pin = false;
+    }
+    if (opt.tune) return run_coordinator(opt);
+    if (opt.worker) return run_worker(opt, cpus);
+    fprintf(stderr, "A = %s, B = %s, %d games, %d jobs%s\n", opt.bot_a ? opt.bot_a : ENGINE_A,
+            opt.bot_b ? opt.bot_b : ENGINE_B, opt.games, opt.jobs, opt.pin ? ", pinned" : "");
+    FILE* jsonl = nullptr;
+    if (opt.jsonl && !(jsonl = fopen(opt.jsonl, "w"))) {
+        perror(opt.jsonl);
+        return 1;
+    }
+
+    GameLogWriter game_log;
+    if (opt.log && !game_log.open(opt.log)) {
+        perror(opt.log);
+        return 1;
+    }
+
+    int* next_game = shared_counter();
+    if (!next_game) return 1;
+    int fds[2];
+    if (pipe(fds) != 0) {
+        perror("pipe");
+        return 1;
+    }
+    vector<pid_t> workers = start_pool(opt, cpus, next_game, fds, jsonl);
+    if (workers.empty()) return 1;
+
+    // Results arrive in completion order; a pipe write this small is atomic
+    auto t0 = chrono::steady_clock::now();
+    int wins = 0, losses = 0, plies = 0;
+    double lower = log(0.05 / 0.95), upper = log(0.95 / 0.05);
+    const char* verdict = nullptr;
+    GameResult r;
+    while (read(fds[0], &r, sizeof(r)) == (ssize_t)sizeof(r)) {
+        if (r.a_won) wins++;
+        else losses++;
+        plies += r.plies;
+        if (jsonl) write_game(jsonl, r);
+        if (opt.log) log_game(game_log, r, opt);
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        int n = wins + losses;
+        if (n % max(1, opt.games / 20) == 0) report(opt, wins, losses, plies, secs, false);
+        if (opt.sprt) {
+            double llr = sprt_llr(wins, losses, opt.elo0, opt.elo1);
+            if (llr >= upper) verdict = "H1 accepted";
+            else if (llr <= lower) verdict = "H0 accepted";
+            if (verdict) break;
+        }
+    }
+    if (verdict)
+        for (pid_t pid : workers) kill(pid, SIGTERM);
+    int status;
+    while (wait(&status) > 0) {}
+
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    report(opt, wins, losses, plies, secs, true);
+    if (opt.sprt)
+        fprintf(stderr, "SPRT [%.1f, %.1f]: %s\n", opt.elo0, opt.elo1, verdict ? verdict : "inconclusive");
+    if (jsonl) {
+        int n = wins + losses;
+        fprintf(jsonl,
+                "{\"type\": \"summary\", \"games\": %d, \"a_wins\": %d, \"b_wins\": %d, \"elo\": %.1f, "
+                "\"plies_per_game\": %.1f, \"seconds\": %.1f, \"sprt\": \"%s\"}\n",
+                n, wins, losses, score_to_elo(n ? (double)wins / n : 0.5), n ? (double)plies / n : 0.0, secs,
+                !opt.sprt ? "off" : verdict ? verdict : "inconclusive");
+        fclose(jsonl);
+    }
+    return 0;
+}
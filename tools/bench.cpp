@@ -0,0 +1,828 @@
+// bench.cpp - micro-benchmarks of the engine kernels on a fixed position corpus
+// bot032 (int8 grid), bot033 (bitboards), the engine/ core behind bot034 and
+// bot035 and the opponent.cpp kernels are compiled into this binary, each in its own namespace,
+// and timed in the same run on the positions of tools/bench_corpus.txt
+// (opening, midgame and partitioned endgame, 8 of each). Kernels:
+//   movegen     every legal move of the side to move
+//   bfs         the four distance maps evaluate needs (king and queen, both sides)
+//   evaluate    one static evaluation
+//   uct_select  one UCB1 scan over as many children as the position has moves,
+//               with fixed pseudo-random statistics
+//   iteration   a search from a fresh tree, up to --iterations iterations or
+//               --iteration-time seconds; reported per iteration. Each run is
+//               forked so no engine sees another one's RSS. bot033 runs in its
+//               deterministic mode (fixed seed, --iterations and no clock), so
+//               its result carries a digest of the root visit counts ("tree").
+// Heap allocations are counted by replacing the global operator new. One JSON
+// object per run goes to stdout (or --json FILE), one result per line, so two
+// runs diff cleanly; --baseline OLD.json compares against an earlier run and
+// exits 1 when a kernel got slower than --tolerance allows. A baseline with
+// the same tree digest is the same search, and the speed change is reported
+// as such; a different digest means the search itself changed, which fails too.
+// Build: g++ -O3 -std=c++11 -o tools/bench tools/bench.cpp
+// Usage: tools/bench [--corpus FILE] [--json FILE] [--min-time S]
+//                    [--iterations N] [--iteration-time S] [--commit ID]
+//                    [--baseline OLD.json] [--tolerance F]
+//        tools/bench --write-corpus FILE [--seed X]
+
+// Everything the bots include, so their own #includes add nothing to the namespaces
+#include <iostream>
+#include <vector>
+#include <array>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <type_traits>
+#include <new>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <assert.h>
+#include <immintrin.h>
+
+// --- ALLOCATION COUNTER ---
+static uint64_t allocations = 0;
+
+void* operator new(size_t n) {
+    allocations++;
+    void* p = malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t n) {
+    allocations++;
+    void* p = malloc(n ? n : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+namespace b032 {
+#define main bot_main
+#include "../bots/bot032.cpp"
+#undef main
+}
+
+namespace b033 {
+#define main bot_main
+#include "../bots/bot033.cpp"
+#undef main
+}
+
+#include "../engine/mcts.h"
+#include "../engine/occupancy.h"
+
+// opponent.cpp switches the rest of the file to AVX2 and defines bool, BLACK,
+// min and friends as macros: keep both inside this block. Its kernels are
+// always_inline, so the wrappers that call them are compiled in here too.
+// Its own warnings are not ours to fix.
+#pragma GCC push_options
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wstrict-aliasing"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#pragma GCC diagnostic ignored "-Wformat"
+namespace opp {
+#define main opponent_main
+#include "../bots/opponent.cpp"
+#undef main
+
+// generate_moves without the per-child State and evaluation: child boards only
+int movegen(const State* s, int turn, uint64_t* out) {
+    uint64_t b0 = s->board;
+    int n = 0;
+    for (uint64_t chess = s->coor[turn]; chess;) {
+        uint64_t chess_coor = chess & (-chess);
+        chess ^= chess_coor;
+        for (uint64_t can_moves = get_queen_can_moves_avx2(~b0, chess_coor); can_moves;) {
+            uint64_t new_pos = can_moves & (-can_moves);
+            can_moves ^= new_pos;
+            b0 ^= (new_pos ^ chess_coor);
+            for (uint64_t arrow_can = get_queen_can_moves_avx2(~b0, new_pos); arrow_can;) {
+                uint64_t arrow_pos = arrow_can & (-arrow_can);
+                arrow_can -= arrow_pos;
+                out[n++] = b0 ^ arrow_pos;
+            }
+            b0 ^= (new_pos ^ chess_coor);
+        }
+    }
+    return n;
+}
+
+// The four BFS calls at the top of evaluate
+int bfs(State* s) {
+    king_move_bfs_avx2(s, s->board, s->coor[me], king_move_me, &king_move_me_max_dist);
+    king_move_bfs_avx2(s, s->board, s->coor[1 - me], king_move_you, &king_move_you_max_dist);
+    queen_move_bfs_avx2(s->board, s->coor[me], queen_move_me, &queen_move_me_max_dist);
+    queen_move_bfs_avx2(s->board, s->coor[1 - me], queen_move_you, &queen_move_you_max_dist);
+    return king_move_me_max_dist + queen_move_you_max_dist;
+}
+
+double eval(State* s) {
+    return evaluate(s);
+}
+
+State* uct_select(State* children, int n) {
+    return get_uct_max_state(children, n);
+}
+
+// The body of MCTS() for a fixed number of iterations
+uint32_t search(State* root, uint32_t max_iterations, double seconds) {
+    std::chrono::steady_clock::time_point deadline =
+        std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                               std::chrono::duration<double>(seconds));
+    uint32_t it = 0;
+    for (; it < max_iterations; it++) {
+        if (it % 64 == 0 && std::chrono::steady_clock::now() >= deadline) break;
+        if (StateTop > MAX_COUNT - 2 * 4 * 27 * 27) break; // Room for one more expansion
+        int next_turn = me;
+        State* leaf = select(root, &next_turn);
+        if (leaf->visit) {
+            expand(leaf, next_turn);
+            leaf = select(leaf, &next_turn);
+        }
+        backup(leaf, &next_turn);
+    }
+    // _state_alloc() relies on zeroed storage: clean up for the next search
+    memset(State_cache, 0, StateTop * sizeof(State));
+    StateTop = 0;
+    return it;
+}
+}
+#undef bool
+#undef true
+#undef false
+#undef BLACK
+#undef WHITE
+#undef BOARD_SIZE
+#undef MAX_COUNT
+#undef min
+#undef __inline
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+typedef amazons::Engine<amazons::BitBoard, amazons::TerritoryEval, amazons::WideningUCB> CoreEngine;
+typedef amazons::Engine<amazons::OccupancyBoard, amazons::OpponentEval, amazons::WideningUCB> OccupancyEngine;
+
+const char* const PHASES[3] = { "opening", "midgame", "endgame" };
+const int CORPUS_PER_PHASE = 8;
+
+struct Options {
+    string corpus = "tools/bench_corpus.txt";
+    string json;
+    string commit;
+    string baseline;
+    double min_time = 0.05;      // Seconds per kernel and phase
+    uint32_t iterations = 20000; // Per search in the iteration kernel
+    double iteration_time = 0.1;
+    double tolerance = 0.15;     // Allowed slowdown against the baseline
+};
+
+// One corpus position in every representation, all built by replaying its moves
+struct Position {
+    int phase;
+    vector<array<int, 6> > moves; // Botzone coordinates x0 y0 x1 y1 x2 y2
+    int color;                    // Side to move, BLACK = 1 / WHITE = -1
+    int turn;                     // Botzone turn number of the side to move
+    int move_count;
+    b032::Board grid;
+    b033::Board bits;
+    amazons::BitBoard core;
+    amazons::OccupancyBoard occ;
+    opp::State state;
+};
+
+struct Result {
+    int64_t ops;
+    double ns_per_op;
+    double allocs_per_op;
+    uint64_t tree; // Digest of the searched trees, 0 when not reproducible
+};
+
+struct Entry {
+    string impl, kernel, phase;
+    Result r;
+};
+
+static volatile uint64_t sink; // Keeps kernel results alive
+static uint64_t tree_digest;   // Folded in by reproducible search kernels
+
+inline void fold_digest(uint64_t v) {
+    tree_digest = (tree_digest ^ v) * 0x100000001B3ULL;
+}
+
+inline uint32_t mix(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352DU;
+    x ^= x >> 15;
+    x *= 0x846CA68BU;
+    return x ^ (x >> 16);
+}
+
+// --- CORPUS ---
+// King-connected flood of the empty squares around BLACK never touches WHITE
+bool partitioned(const amazons::BitBoard& b) {
+    uint64_t empty = ~b.occupied();
+    uint64_t reach = b.pieces[0];
+    for (;;) {
+        uint64_t next = reach | (amazons::king_step(reach) & empty);
+        if (next == reach) break;
+        reach = next;
+    }
+    return (amazons::king_step(reach) & b.pieces[1]) == 0;
+}
+
+void write_moves(ostream& out, const char* phase, const vector<amazons::Move>& line, size_t plies) {
+    out << phase << " " << plies;
+    for (size_t i = 0; i < plies; i++) {
+        const amazons::Move& m = line[i];
+        out << "  " << m.from / 8 << " " << m.from % 8 << " " << m.to / 8 << " " << m.to % 8 << " "
+            << m.arrow / 8 << " " << m.arrow % 8;
+    }
+    out << "\n";
+}
+
+// Uniformly random games; each gives at most one position per phase: an early
+// ply, one in the 20s and the first ply at which no region is shared
+int write_corpus(const string& path, uint32_t seed) {
+    ofstream out(path.c_str());
+    if (!out) {
+        cerr << "bench: cannot write " << path << endl;
+        return 1;
+    }
+    out << "# bench_corpus.txt - fixed positions for tools/bench, written by\n"
+        << "#     tools/bench --write-corpus tools/bench_corpus.txt --seed " << seed << "\n"
+        << "# <phase> <plies> then that many moves x0 y0 x1 y1 x2 y2 (Botzone coordinates)\n"
+        << "# from the start position. Keep it fixed: results are only comparable on one corpus.\n";
+    static amazons::Move moves[amazons::MAX_MOVES];
+    int found[3] = { 0, 0, 0 };
+    uint32_t rng = mix(seed);
+    for (int g = 0; found[0] < CORPUS_PER_PHASE || found[1] < CORPUS_PER_PHASE || found[2] < CORPUS_PER_PHASE; g++) {
+        amazons::BitBoard b;
+        vector<amazons::Move> line;
+        int color = amazons::BLACK;
+        size_t opening_ply = 2 + g % 7, midgame_ply = 20 + g % 10;
+        bool endgame_done = false;
+        for (;;) {
+            int n = b.generate(color, moves);
+            if (n == 0) break;
+            auto take = [&](int phase) {
+                if (found[phase] == CORPUS_PER_PHASE) return;
+                found[phase]++;
+                write_moves(out, PHASES[phase], line, line.size());
+            };
+            if (line.size() == opening_ply) take(0);
+            if (line.size() == midgame_ply) take(1);
+            if (!endgame_done && partitioned(b)) {
+                endgame_done = true;
+                take(2);
+            }
+            rng = mix(rng + (uint32_t)line.size());
+            amazons::Move m = moves[rng % (uint32_t)n];
+            b.apply(m);
+            line.push_back(m);
+            color = -color;
+        }
+    }
+    return 0;
+}
+
+bool load_corpus(const string& path, vector<Position>& out) {
+    ifstream in(path.c_str());
+    if (!in) {
+        cerr << "bench: cannot read " << path << endl;
+        return false;
+    }
+    string l;
+    while (getline(in, l)) {
+        if (l.empty() || l[0] == '#') continue;
+        stringstream ss(l);
+        string phase;
+        int plies;
+        if (!(ss >> phase >> plies)) continue;
+        Position p;
+        p.phase = -1;
+        for (int k = 0; k < 3; k++)
+            if (phase == PHASES[k]) p.phase = k;
+        if (p.phase < 0) {
+            cerr << "bench: unknown phase " << phase << endl;
+            return false;
+        }
+        for (int i = 0; i < plies; i++) {
+            array<int, 6> m;
+            for (int k = 0; k < 6; k++) ss >> m[k];
+            if (!ss) {
+                cerr << "bench: short move list: " << l << endl;
+                return false;
+            }
+            p.moves.push_back(m);
+        }
+        out.push_back(p);
+    }
+    return !out.empty();
+}
+
+// Replay the moves into every representation
+void build(Position& p) {
+    memset(&p.state, 0, sizeof(p.state));
+    p.state.board = (1ull << 2) | (1ull << 5) | (1ull << 16) | (1ull << 23);
+    p.state.coor[0] = p.state.board;
+    p.state.board |= (1ull << 40) | (1ull << 47) | (1ull << 58) | (1ull << 61);
+    p.state.coor[1] = p.state.board ^ p.state.coor[0];
+    for (size_t i = 0; i < p.moves.size(); i++) {
+        const array<int, 6>& c = p.moves[i];
+        int from = c[0] * 8 + c[1], to = c[2] * 8 + c[3], arrow = c[4] * 8 + c[5];
+        p.grid.apply_move(b032::Move(from, to, arrow));
+        p.bits.apply_move(b033::Move(from, to, arrow));
+        p.core.apply(amazons::Move(from, to, arrow));
+        p.occ.apply(amazons::Move(from, to, arrow));
+        opp::move(&p.state, c[0], c[1], c[2], c[3], c[4], c[5], (int)(i % 2));
+    }
+    p.color = p.moves.size() % 2 == 0 ? b033::BLACK : b033::WHITE;
+    p.turn = (int)p.moves.size() / 2 + 1;
+    static b033::Move moves[b033::MAX_MOVES];
+    p.move_count = b033::generate_moves(p.bits, p.color, moves);
+}
+
+inline int opp_side(const Position& p) {
+    return p.color == b033::BLACK ? 0 : 1;
+}
+
+// Run f(position) over every position of the phase, in rounds, for at least min_time
+template <class F>
+Result measure(const vector<Position*>& set, double min_time, F f) {
+    Result r = { 0, 0, 0, 0 };
+    if (set.empty()) return r;
+    uint64_t a0 = allocations;
+    Clock::time_point t0 = Clock::now();
+    double elapsed = 0;
+    do {
+        for (size_t i = 0; i < set.size(); i++) r.ops += f(*set[i]);
+        elapsed = chrono::duration<double>(Clock::now() - t0).count();
+    } while (elapsed < min_time);
+    r.ns_per_op = elapsed * 1e9 / (double)r.ops;
+    r.allocs_per_op = (double)(allocations - a0) / (double)r.ops;
+    return r;
+}
+
+// Searches run in a child process; the parent gets the Result through a pipe
+template <class F>
+Result measure_forked(const vector<Position*>& set, F f) {
+    Result r = { 0, 0, 0, 0 };
+    int fds[2];
+    if (pipe(fds) != 0) return r;
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        int64_t iterations = 0;
+        double seconds = 0;
+        uint64_t a0 = allocations;
+        tree_digest = 0;
+        for (size_t i = 0; i < set.size(); i++) {
+            Clock::time_point t0 = Clock::now();
+            iterations += f(*set[i]);
+            seconds += chrono::duration<double>(Clock::now() - t0).count();
+        }
+        Result c = { iterations, iterations ? seconds * 1e9 / (double)iterations : 0,
+                     iterations ? (double)(allocations - a0) / (double)iterations : 0, tree_digest };
+        ssize_t w = write(fds[1], &c, sizeof(c));
+        _exit(w == (ssize_t)sizeof(c) ? 0 : 1);
+    }
+    close(fds[1]);
+    if (pid > 0) {
+        if (read(fds[0], &r, sizeof(r)) != (ssize_t)sizeof(r)) r.ops = 0;
+        waitpid(pid, nullptr, 0);
+    }
+    close(fds[0]);
+    return r;
+}
+
+// --- UCT FIXTURES ---
+// Every position gets a parent with move_count children, laid out one after
+// the other in each implementation's own node storage
+struct UctFixture {
+    vector<float> wins;
+    vector<int> visits;
+    vector<int> first;   // Offset of each position's block
+    vector<int> parent_visits;
+};
+
+UctFixture make_uct_fixture(const vector<Position>& corpus) {
+    UctFixture u;
+    uint32_t rng = 12345;
+    for (size_t i = 0; i < corpus.size(); i++) {
+        u.first.push_back((int)u.wins.size());
+        int total = 0;
+        for (int k = 0; k < corpus[i].move_count; k++) {
+            rng = mix(rng + k);
+            int v = 1 + (int)(rng % 40);
+            u.visits.push_back(v);
+            u.wins.push_back(v * (float)((rng >> 8) % 1000) / 1000.0f);
+            total += v;
+        }
+        u.parent_visits.push_back(total);
+    }
+    u.first.push_back((int)u.wins.size());
+    return u;
+}
+
+// --- JSON ---
+string json_line(const Entry& e) {
+    char buf[256];
+    snprintf(buf, sizeof(buf),
+             "{\"impl\": \"%s\", \"kernel\": \"%s\", \"phase\": \"%s\", \"ops\": %lld, \"ns_per_op\": %.2f, "
+             "\"allocs_per_op\": %.4f",
+             e.impl.c_str(), e.kernel.c_str(), e.phase.c_str(), (long long)e.r.ops, e.r.ns_per_op,
+             e.r.allocs_per_op);
+    string s = buf;
+    if (e.r.tree) {
+        snprintf(buf, sizeof(buf), ", \"tree\": \"%016llx\"", (unsigned long long)e.r.tree);
+        s += buf;
+    }
+    return s + "}";
+}
+
+string git_commit() {
+    FILE* f = popen("git rev-parse --short HEAD 2>/dev/null", "r");
+    if (!f) return "unknown";
+    char buf[64] = { 0 };
+    if (!fgets(buf, sizeof(buf), f)) buf[0] = 0;
+    pclose(f);
+    string s(buf);
+    while (!s.empty() && (s.back() == '\n' || s.back() == '\r')) s.pop_back();
+    return s.empty() ? "unknown" : s;
+}
+
+void write_json(ostream& out, const Options& opt, const vector<Entry>& entries) {
+    out << "{\n"
+        << "  \"schema\": \"amazons-bench/1\",\n"
+        << "  \"commit\": \"" << opt.commit << "\",\n"
+        << "  \"compiler\": \"" << __VERSION__ << "\",\n"
+        << "  \"cpu_level\": " << b033::cpu_level << ",\n"
+        << "  \"corpus\": \"" << opt.corpus << "\",\n"
+        << "  \"results\": [\n";
+    for (size_t i = 0; i < entries.size(); i++)
+        out << "    " << json_line(entries[i]) << (i + 1 < entries.size() ? "," : "") << "\n";
+    out << "  ]\n}\n";
+}
+
+// Reads back the result lines of write_json; returns how many kernels regressed
+int compare_baseline(const Options& opt, const vector<Entry>& entries) {
+    ifstream in(opt.baseline.c_str());
+    if (!in) {
+        cerr << "bench: cannot read baseline " << opt.baseline << endl;
+        return 1;
+    }
+    int regressions = 0;
+    string l;
+    while (getline(in, l)) {
+        char impl[32], kernel[32], phase[32];
+        long long ops;
+        double ns;
+        if (sscanf(l.c_str(), " {\"impl\": \"%31[^\"]\", \"kernel\": \"%31[^\"]\", \"phase\": \"%31[^\"]\", \"ops\": %lld, "
+                              "\"ns_per_op\": %lf", impl, kernel, phase, &ops, &ns) != 5)
+            continue;
+        for (size_t i = 0; i < entries.size(); i++) {
+            const Entry& e = entries[i];
+            if (e.impl != impl || e.kernel != kernel || e.phase != phase || ns <= 0) continue;
+            double ratio = e.r.ns_per_op / ns;
+            const char* t = strstr(l.c_str(), "\"tree\": \"");
+            unsigned long long tree = t ? strtoull(t + 9, nullptr, 16) : 0;
+            if (tree && e.r.tree && tree != e.r.tree) {
+                regressions++;
+                fprintf(stderr, "SEARCH CHANGED %-8s %-10s %-8s tree %016llx -> %016llx\n", impl, kernel, phase, tree,
+                        (unsigned long long)e.r.tree);
+                continue;
+            }
+            if (tree && tree == e.r.tree)
+                fprintf(stderr, "same tree %-8s %-10s %-8s %10.2f -> %10.2f ns/op, %+.1f%% time\n", impl, kernel, phase,
+                        ns, e.r.ns_per_op, (ratio - 1) * 100);
+            if (ratio > 1 + opt.tolerance) {
+                regressions++;
+                fprintf(stderr, "REGRESSION %-8s %-10s %-8s %10.2f -> %10.2f ns/op (x%.2f)\n", impl, kernel, phase, ns,
+                        e.r.ns_per_op, ratio);
+            }
+        }
+    }
+    return regressions;
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    string write_path;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; i++) {
+        string a = argv[i];
+        bool has = i + 1 < argc;
+        if (a == "--corpus" && has) opt.corpus = argv[++i];
+        else if (a == "--json" && has) opt.json = argv[++i];
+        else if (a == "--commit" && has) opt.commit = argv[++i];
+        else if (a == "--baseline" && has) opt.baseline = argv[++i];
+        else if (a == "--min-time" && has) opt.min_time = atof(argv[++i]);
+        else if (a == "--iterations" && has) opt.iterations = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (a == "--iteration-time" && has) opt.iteration_time = atof(argv[++i]);
+        else if (a == "--tolerance" && has) opt.tolerance = atof(argv[++i]);
+        else if (a == "--write-corpus" && has) write_path = argv[++i];
+        else if (a == "--seed" && has) seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else {
+            cerr << "usage: " << argv[0] << " [--corpus FILE] [--json FILE] [--min-time S] [--iterations N]"
+                 << " [--iteration-time S] [--commit ID] [--baseline OLD.json] [--tolerance F]\n"
+                 << "       " << argv[0] << " --write-corpus FILE [--seed X]" << endl;
+            return 2;
+        }
+    }
+    if (!write_path.empty()) return write_corpus(write_path, seed);
+    if (opt.commit.empty()) opt.commit = git_commit();
+
+    b033::init_zobrist();
+    b033::init_ucb_tables();
+    b033::init_widening();
+    b033::init_cpu_dispatch();
+    b033::init_arena();
+    b033::rng_seed = 1; // With --iterations, deterministic mode
+    b033::init_thread_state(0);
+    b032::node_pool = new b032::MCTSNode[b032::MAX_NODES];
+    b032::seed_rng();
+    static CoreEngine core;
+    core.seed(1);
+    static OccupancyEngine occ_engine;
+    occ_engine.seed(1);
+    __builtin_cpu_init();
+    const bool have_avx2 = __builtin_cpu_supports("avx2");
+    if (!have_avx2) cerr << "bench: no AVX2, opponent.cpp kernels skipped" << endl;
+
+    vector<Position> corpus;
+    if (!load_corpus(opt.corpus, corpus)) return 1;
+    for (size_t i = 0; i < corpus.size(); i++) build(corpus[i]);
+
+    // UCT fixtures, copied into each implementation's node layout
+    UctFixture u = make_uct_fixture(corpus);
+    int bot_parent = (int)u.wins.size() + 1; // bot032/bot033 parents after all the children
+    for (size_t i = 0; i < corpus.size(); i++) {
+        int n = corpus[i].move_count, f = u.first[i];
+        b033::MCTSNode& p33 = b033::node_pool[bot_parent + i];
+        p33.first_child = 1 + f;
+        p33.child_count = n;
+        b033::node_visits[bot_parent + i] = u.parent_visits[i];
+        b032::MCTSNode& p32 = b032::node_pool[bot_parent + i];
+        p32.init(nullptr, b032::Move(), 0);
+        p32.visits = u.parent_visits[i];
+        for (int k = 0; k < n; k++) {
+            b033::node_wins[1 + f + k] = u.wins[f + k];
+            b033::node_visits[1 + f + k] = u.visits[f + k];
+            b032::MCTSNode& c32 = b032::node_pool[1 + f + k];
+            c32.init(&p32, b032::Move(), 0);
+            c32.wins = u.wins[f + k];
+            c32.visits = u.visits[f + k];
+            p32.add_child(&c32);
+        }
+    }
+    vector<opp::State> opp_parent(corpus.size());
+    vector<opp::State> opp_children(u.wins.size() + 1);
+    for (size_t i = 0; i < corpus.size(); i++) {
+        memset(&opp_parent[i], 0, sizeof(opp::State));
+        opp_parent[i].visit = u.parent_visits[i];
+        for (int k = u.first[i]; k < u.first[i + 1]; k++) {
+            opp::State& c = opp_children[k];
+            memset(&c, 0, sizeof(c));
+            c.quality = u.wins[k];
+            c.visit = u.visits[k] - 1; // opponent.cpp divides by 1 + visit
+            c.parent = &opp_parent[i];
+        }
+    }
+
+    vector<Entry> entries;
+    auto add = [&](const char* impl, const char* kernel, int phase, const Result& r) {
+        Entry e = { impl, kernel, PHASES[phase], r };
+        entries.push_back(e);
+        fprintf(stderr, "%-8s %-10s %-8s %12.2f ns/op %8.4f allocs/op\n", impl, kernel, PHASES[phase], r.ns_per_op,
+                r.allocs_per_op);
+    };
+
+    static b032::Move* const pool32 = b032::move_pool;
+    static b033::Move moves33[b033::MAX_MOVES];
+    static amazons::Move moves_core[amazons::MAX_MOVES];
+    static uint64_t moves_opp[amazons::MAX_MOVES];
+    static uint64_t layers[4][b033::NUM_SQUARES + 1];
+    static int dist[2][b032::NUM_SQUARES];
+    const bool avx2_level = b033::cpu_level >= b033::CPU_AVX2;
+
+    for (int ph = 0; ph < 3; ph++) {
+        vector<Position*> set;
+        for (size_t i = 0; i < corpus.size(); i++)
+            if (corpus[i].phase == ph) set.push_back(&corpus[i]);
+        if (set.empty()) continue;
+        const double t = opt.min_time;
+
+        // movegen
+        add("bot032", "movegen", ph, measure(set, t, [&](Position& p) {
+            int start, count;
+            b032::move_pool_ptr = 0;
+            p.grid.get_legal_moves(p.color, start, count);
+            sink += pool32[count - 1].arrow;
+            return 1;
+        }));
+        add("bot033", "movegen", ph, measure(set, t, [&](Position& p) {
+            sink += moves33[b033::generate_moves(p.bits, p.color, moves33) - 1].arrow;
+            return 1;
+        }));
+        add("bot034", "movegen", ph, measure(set, t, [&](Position& p) {
+            sink += moves_core[p.core.generate(p.color, moves_core) - 1].arrow;
+            return 1;
+        }));
+        add("bot035", "movegen", ph, measure(set, t, [&](Position& p) {
+            sink += moves_core[p.occ.generate(p.color, moves_core) - 1].arrow;
+            return 1;
+        }));
+        if (have_avx2)
+            add("opponent", "movegen", ph, measure(set, t, [&](Position& p) {
+                sink += moves_opp[opp::movegen(&p.state, opp_side(p), moves_opp) - 1];
+                return 1;
+            }));
+
+        // bfs
+        add("bot032", "bfs", ph, measure(set, t, [&](Position& p) {
+            int mine[4], theirs[4], nm = 0, nt = 0;
+            for (int s = 0; s < b032::NUM_SQUARES; s++) {
+                if (p.grid.grid[s] == p.color) mine[nm++] = s;
+                else if (p.grid.grid[s] == -p.color) theirs[nt++] = s;
+            }
+            b032::run_bfs(p.grid.grid, mine, dist[0]);
+            b032::run_bfs(p.grid.grid, theirs, dist[1]);
+            sink += dist[0][0] + dist[1][63];
+            return 1;
+        }));
+        add("bot033", "bfs", ph, measure(set, t, [&](Position& p) {
+            uint64_t empty = ~p.bits.occupied();
+            uint64_t mine = p.bits.pieces[b033::Board::side(p.color)], theirs = p.bits.pieces[b033::Board::side(-p.color)];
+            int n = b033::distance_layers<false, 0>(mine, empty, layers[0]) +
+                    b033::distance_layers<false, 0>(theirs, empty, layers[1]);
+            if (avx2_level)
+                n += b033::distance_layers<true, b033::CPU_AVX2>(mine, empty, layers[2]) +
+                     b033::distance_layers<true, b033::CPU_AVX2>(theirs, empty, layers[3]);
+            else
+                n += b033::distance_layers<true, b033::CPU_SCALAR>(mine, empty, layers[2]) +
+                     b033::distance_layers<true, b033::CPU_SCALAR>(theirs, empty, layers[3]);
+            sink += n;
+            return 1;
+        }));
+        add("bot034", "bfs", ph, measure(set, t, [&](Position& p) {
+            uint64_t empty = ~p.core.occupied();
+            uint64_t mine = p.core.pieces[amazons::BitBoard::side(p.color)];
+            uint64_t theirs = p.core.pieces[amazons::BitBoard::side(-p.color)];
+            sink += amazons::distance_layers<false>(mine, empty, layers[0]) +
+                    amazons::distance_layers<false>(theirs, empty, layers[1]) +
+                    amazons::distance_layers<true>(mine, empty, layers[2]) +
+                    amazons::distance_layers<true>(theirs, empty, layers[3]);
+            return 1;
+        }));
+        if (have_avx2)
+            add("opponent", "bfs", ph, measure(set, t, [&](Position& p) {
+                opp::me = opp_side(p);
+                sink += opp::bfs(&p.state);
+                return 1;
+            }));
+
+        // evaluate
+        add("bot032", "evaluate", ph, measure(set, t, [&](Position& p) {
+            sink += (uint64_t)(b032::evaluate(p.grid, p.color, p.turn) * 1e6);
+            return 1;
+        }));
+        add("bot033", "evaluate", ph, measure(set, t, [&](Position& p) {
+            sink += (uint64_t)(b033::evaluate(p.bits, p.color, p.turn) * 1e6);
+            return 1;
+        }));
+        add("bot034", "evaluate", ph, measure(set, t, [&](Position& p) {
+            sink += (uint64_t)(amazons::TerritoryEval::evaluate(p.core, p.color, p.turn) * 1e6);
+            return 1;
+        }));
+        add("bot035", "evaluate", ph, measure(set, t, [&](Position& p) {
+            sink += (uint64_t)(amazons::OpponentEval::evaluate(p.occ, p.color, p.turn) * 1e6);
+            return 1;
+        }));
+        if (have_avx2)
+            add("opponent", "evaluate", ph, measure(set, t, [&](Position& p) {
+                opp::me = opp_side(p);
+                sink += (uint64_t)(opp::eval(&p.state) * 1e6);
+                return 1;
+            }));
+
+        // uct_select
+        const float C = 0.177f;
+        add("bot032", "uct_select", ph, measure(set, t, [&](Position& p) {
+            sink += (uintptr_t)b032::node_pool[bot_parent + (&p - &corpus[0])].uct_select_child(C);
+            return 1;
+        }));
+        add("bot033", "uct_select", ph, measure(set, t, [&](Position& p) {
+            sink += b033::uct_select_child(bot_parent + (int)(&p - &corpus[0]), C);
+            return 1;
+        }));
+        add("bot034", "uct_select", ph, measure(set, t, [&](Position& p) {
+            size_t i = &p - &corpus[0];
+            sink += amazons::select_ucb(&u.wins[u.first[i]], &u.visits[u.first[i]], p.move_count, u.parent_visits[i], C);
+            return 1;
+        }));
+        if (have_avx2)
+            add("opponent", "uct_select", ph, measure(set, t, [&](Position& p) {
+                size_t i = &p - &corpus[0];
+                opp::C = C;
+                sink += (uintptr_t)opp::uct_select(&opp_children[u.first[i]], p.move_count);
+                return 1;
+            }));
+
+        // iteration
+        const uint32_t iters = opt.iterations;
+        const double secs = opt.iteration_time;
+        add("bot032", "iteration", ph, measure_forked(set, [&](Position& p) {
+            b032::search(p.grid, p.color, p.turn, Clock::now(), secs);
+            return (int64_t)b032::node_pool_ptr - 1; // One node per iteration besides the root
+        }));
+        add("bot033", "iteration", ph, measure_forked(set, [&](Position& p) {
+            b033::reset_pool();
+            b033::tree_root = b033::NO_NODE;
+            b033::search_node_limit = iters;
+            b033::search(p.bits, p.color, p.turn, Clock::now(), secs);
+            if (b033::deterministic_search()) {
+                static vector<b033::RootStat> stats;
+                b033::collect_root_stats(p.bits, stats);
+                for (const b033::RootStat& s : stats)
+                    fold_digest((uint64_t)s.move.from << 48 | (uint64_t)s.move.to << 40 |
+                                (uint64_t)s.move.arrow << 32 | (uint32_t)s.visits);
+            }
+            return (int64_t)b033::node_visits[b033::tree_root];
+        }));
+        add("bot034", "iteration", ph, measure_forked(set, [&](Position& p) {
+            core.reset();
+            for (size_t i = 0; i < p.moves.size(); i++) {
+                const array<int, 6>& c = p.moves[i];
+                core.play(amazons::Move(c[0] * 8 + c[1], c[2] * 8 + c[3], c[4] * 8 + c[5]));
+            }
+            Clock::time_point deadline =
+                Clock::now() + chrono::duration_cast<Clock::duration>(chrono::duration<double>(secs));
+            core.think(deadline, iters);
+            return (int64_t)core.iterations();
+        }));
+        add("bot035", "iteration", ph, measure_forked(set, [&](Position& p) {
+            occ_engine.reset();
+            for (size_t i = 0; i < p.moves.size(); i++) {
+                const array<int, 6>& c = p.moves[i];
+                occ_engine.play(amazons::Move(c[0] * 8 + c[1], c[2] * 8 + c[3], c[4] * 8 + c[5]));
+            }
+            Clock::time_point deadline =
+                Clock::now() + chrono::duration_cast<Clock::duration>(chrono::duration<double>(secs));
+            occ_engine.think(deadline, iters);
+            return (int64_t)occ_engine.iterations();
+        }));
+        if (have_avx2)
+            add("opponent", "iteration", ph, measure_forked(set, [&](Position& p) {
+                opp::State root = p.state;
+                root.child = root.parent = nullptr;
+                root.visit = root.len = 0;
+                root.quality = 0;
+                opp::me = opp_side(p);
+                opp::C = 0.176999999999 * exp(-0.008 * (p.turn - 1.41));
+                return (int64_t)opp::search(&root, iters, secs);
+            }));
+    }
+
+    if (opt.json.empty()) {
+        write_json(cout, opt, entries);
+    } else {
+        ofstream out(opt.json.c_str());
+        write_json(out, opt, entries);
+    }
+    if (!opt.baseline.empty()) {
+        int r = compare_baseline(opt, entries);
+        if (r) {
+            fprintf(stderr, "%d kernel(s) slower than the baseline by more than %.0f%%\n", r, opt.tolerance * 100);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+// book_gen.cpp - build bot033's opening book from long searches
+// Links the engine directly like tools/selfplay.cpp. Starting from the initial
+// position, every position up to --plies plies deep is searched for --movetime
+// seconds on a fresh tree; its most visited move goes into the book and its
+// --width most visited moves are followed to the next ply, so the book covers
+// the lines a strong opponent is likely to play as well as our own. Positions
+// reached twice (transpositions) or as each other's mirror image are searched
+// once; entries are keyed and oriented by canonical_hash. With --games LOG
+// (a tools/arena --log game log), every position that at least --min-games
+// logged games reached is searched too, so the book covers what opponents
+// actually played.
+// Build: g++ -O3 -std=c++11 -o tools/book_gen tools/book_gen.cpp
+// Usage: tools/book_gen [bot.cpp] [--plies P] [--width W] [--movetime S]
+//                      [--games LOG] [--min-games N]
+//        rewrites the block between BEGIN/END OPENING BOOK in bot.cpp
+
+#define main bot_main
+#include "../bots/bot033.cpp"
+#undef main
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "gamelog.h"
+
+struct Options {
+    const char* path = "bots/bot033.cpp";
+    int plies = 2 * BOOK_MAX_TURN;
+    int width = 2;
+    double movetime = 5.0;
+    const char* games = nullptr;
+    int min_games = 2;
+};
+
+// Positions after each ply of the logged games, by canonical key, with how many games reached them
+void logged_positions(const GameLog& log, int plies, vector<map<uint64_t, pair<Board, int> > >& out) {
+    out.assign(plies, map<uint64_t, pair<Board, int> >());
+    for (size_t i = 0; i < log.size(); i++) {
+        GameView g = log.game(i);
+        Board b;
+        for (int ply = 0; ply < plies && ply < g.plies(); ply++) {
+            auto& e = out[ply][canonical_hash(b.hash)];
+            if (e.second++ == 0) e.first = b;
+            b.apply_move(Move(g.moves[ply].from, g.moves[ply].to, g.moves[ply].arrow));
+        }
+    }
+}
+
+// Search board on a fresh tree; root moves by decreasing visits
+void search_position(const Board& board, int color, int ply, double movetime, vector<RootStat>& stats) {
+    reset_pool();
+    tree_root = NO_NODE;
+    search(board, color, ply / 2 + 1, chrono::steady_clock::now(), movetime);
+    collect_root_stats(board, stats);
+    sort(stats.begin(), stats.end(), [](const RootStat& a, const RootStat& b) { return a.visits > b.visits; });
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        string a = argv[i];
+        bool has_value = i + 1 < argc;
+        if (a == "--plies" && has_value) opt.plies = atoi(argv[++i]);
+        else if (a == "--width" && has_value) opt.width = max(1, atoi(argv[++i]));
+        else if (a == "--movetime" && has_value) opt.movetime = atof(argv[++i]);
+        else if (a == "--games" && has_value) opt.games = argv[++i];
+        else if (a == "--min-games" && has_value) opt.min_games = max(1, atoi(argv[++i]));
+        else opt.path = argv[i];
+    }
+
+    init_zobrist();
+    init_ucb_tables();
+    init_widening();
+    init_cpu_dispatch();
+    init_arena();
+    init_thread_state(0);
+    seed_rng(1);
+
+    vector<map<uint64_t, pair<Board, int> > > logged;
+    if (opt.games) {
+        GameLog log;
+        if (!log.open(opt.games)) {
+            fprintf(stderr, "%s: not a game log\n", opt.games);
+            return 1;
+        }
+        logged_positions(log, opt.plies, logged);
+    }
+
+    map<uint64_t, Move> book;
+    vector<Board> level(1), next;
+    auto t0 = chrono::steady_clock::now();
+    auto key_less = [](const Board& x, const Board& y) { return canonical_hash(x.hash) < canonical_hash(y.hash); };
+    auto key_equal = [](const Board& x, const Board& y) { return canonical_hash(x.hash) == canonical_hash(y.hash); };
+    for (int ply = 0; ply < opt.plies; ply++) {
+        if (!logged.empty()) {
+            for (const auto& e : logged[ply])
+                if (e.second.second >= opt.min_games && !book.count(e.first)) level.push_back(e.second.first);
+            sort(level.begin(), level.end(), key_less);
+            level.erase(unique(level.begin(), level.end(), key_equal), level.end());
+        }
+        if (level.empty()) break;
+        int color = ply % 2 ? WHITE : BLACK;
+        next.clear();
+        for (const Board& b : level) {
+            vector<RootStat> stats;
+            search_position(b, color, ply, opt.movetime, stats);
+            if (stats.empty()) continue;
+            uint64_t key = canonical_hash(b.hash);
+            book[key] = key == b.hash ? stats[0].move : mirror_move(stats[0].move);
+            for (int k = 0; k < opt.width && k < (int)stats.size(); k++) {
+                Board c = b;
+                c.apply_move(stats[k].move);
+                if (!book.count(canonical_hash(c.hash))) next.push_back(c);
+            }
+        }
+        // Transpositions and mirror images within the next ply
+        sort(next.begin(), next.end(), key_less);
+        next.erase(unique(next.begin(), next.end(), key_equal), next.end());
+        fprintf(stderr, "ply %d: %zu positions, %zu in book (%.0f s)\n", ply, level.size(), book.size(),
+                chrono::duration<double>(chrono::steady_clock::now() - t0).count());
+        level.swap(next);
+    }
+
+    ostringstream w;
+    w << "// BEGIN OPENING BOOK\n";
+    w << "// tools/book_gen.cpp: " << opt.plies << " plies, width " << opt.width << ", " << opt.movetime
+      << " s per position\n";
+    w << "constexpr BookEntry BOOK[] = {\n";
+    char line[64];
+    for (const auto& e : book) { // map order: sorted by hash
+        snprintf(line, sizeof(line), "    {0x%016llxULL, %d, %d, %d},\n", (unsigned long long)e.first,
+                 e.second.from, e.second.to, e.second.arrow);
+        w << line;
+    }
+    w << "};\n// END OPENING BOOK";
+
+    ifstream in(opt.path);
+    stringstream src;
+    src << in.rdbuf();
+    string text = src.str();
+    size_t a = text.find("// BEGIN OPENING BOOK"), b = text.find("// END OPENING BOOK");
+    if (a == string::npos || b == string::npos) {
+        fprintf(stderr, "%s: no OPENING BOOK block\n", opt.path);
+        return 1;
+    }
+    text.replace(a, b + strlen("// END OPENING BOOK") - a, w.str());
+    ofstream(opt.path) << text;
+    fprintf(stderr, "%zu positions written to %s\n", book.size(), opt.path);
+    return 0;
+}
@@ -0,0 +1,31 @@
+// engine.h - common interface of the engines linked into the native tools
+// An engine follows one game from the start position: reset() starts a new
+// game, play() applies a move by either side, think() returns the move of the
+// side to move without playing it. tools/bot_engine.inc wraps a bot source in it.
+#ifndef AMAZONS_ENGINE_H
+#define AMAZONS_ENGINE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+struct EngineMove {
+    uint8_t from, to, arrow; // Square indices (row * 8 + col); from = 255 when there is no move
+};
+
+struct EngineBudget {
+    double movetime;  // Seconds per move
+    uint32_t nodes;   // MCTS iterations or alpha-beta nodes per move, 0 for none
+};
+
+class Engine {
+public:
+    virtual ~Engine() {}
+    virtual const char* name() const = 0;
+    virtual void reset() = 0;
+    virtual void play(const EngineMove& m) = 0;
+    virtual EngineMove think(const EngineBudget& budget) = 0;
+    virtual size_t resident() const { return 0; } // Bytes after the last think(), 0 if unknown
+};
+
+#endif
@@ -0,0 +1,211 @@
+// gamelog.h - compact binary game log, written by tools/arena, read by mmap
+// A log is a GameLogHeader, then one record per game, then the index: one
+// uint64 file offset per game. A record is a GameRecord (players, result,
+// ply count), the moves as packed 3-byte EngineMoves (row * 8 + col squares,
+// the layout of bot032's and bot033's Move) and one TurnStat per ply, padded
+// to 8 bytes. Nothing is parsed on open: GameLog maps the file and a game is
+// a pointer into the mapping. A log whose writer died before close() has no
+// index; the reader then walks the records by their size fields.
+// Positions are not stored: every_position(ply) replays the first ply moves
+// of each game that long, a few xors per move on three bitboards.
+// Little-endian, like every machine the tools run on.
+#ifndef AMAZONS_GAMELOG_H
+#define AMAZONS_GAMELOG_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "engine.h"
+
+static_assert(sizeof(EngineMove) == 3, "log moves are 3 bytes");
+
+const char GAMELOG_MAGIC[8] = { 'A', 'M', 'Z', 'L', 'O', 'G', 0, 1 };
+const int GAMELOG_MAX_PLIES = 92; // 92 empty squares, one arrow per ply
+
+struct GameLogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t games;        // 0 until close()
+    uint64_t index_offset; // 0 until close()
+};
+
+enum GameEnd : uint8_t { END_NO_MOVES, END_ILLEGAL_MOVE, END_TIMEOUT, END_CRASH };
+
+struct GameRecord {
+    uint32_t size;      // Bytes of the record, header included
+    uint16_t plies;
+    int8_t winner;      // 0 Black, 1 White
+    uint8_t end;        // GameEnd
+    uint16_t opening;   // Random plies before the players took over
+    uint16_t reserved;
+    char players[2][20]; // Black's and White's names, NUL-padded
+};
+
+struct TurnStat {
+    uint32_t time_us; // Thinking time of the move, 0 for an opening ply
+    uint32_t rss_kb;  // Resident memory of the mover after it, 0 if unknown
+};
+
+// One game inside the mapping
+struct GameView {
+    const GameRecord* record;
+    const EngineMove* moves;
+    const TurnStat* turns;
+
+    int plies() const { return record->plies; }
+};
+
+// Bitboards of a position: pieces[0] Black's amazons, pieces[1] White's
+struct LogPosition {
+    uint64_t pieces[2];
+    uint64_t arrows;
+    int side; // To move, 0 Black
+
+    LogPosition() : arrows(0), side(0) {
+        pieces[0] = 1ULL << 2 | 1ULL << 5 | 1ULL << 16 | 1ULL << 23;
+        pieces[1] = 1ULL << 40 | 1ULL << 47 | 1ULL << 58 | 1ULL << 61;
+    }
+
+    void apply(const EngineMove& m) {
+        pieces[side] ^= 1ULL << m.from | 1ULL << m.to;
+        arrows |= 1ULL << m.arrow;
+        side ^= 1;
+    }
+};
+
+inline size_t record_size(int plies) {
+    size_t n = sizeof(GameRecord) + plies * sizeof(EngineMove);
+    n = (n + 7) & ~(size_t)7;
+    return n + plies * sizeof(TurnStat);
+}
+
+class GameLogWriter {
+public:
+    GameLogWriter() : f(nullptr) {}
+    ~GameLogWriter() { close(); }
+
+    bool open(const char* path) {
+        f = fopen(path, "wb");
+        if (!f) return false;
+        GameLogHeader h;
+        memcpy(h.magic, GAMELOG_MAGIC, sizeof(h.magic));
+        h.version = 1;
+        h.games = 0;
+        h.index_offset = 0;
+        offset = sizeof(h);
+        return fwrite(&h, sizeof(h), 1, f) == 1;
+    }
+
+    // Records are flushed as they come, so a crashed run keeps its games
+    void add(GameRecord r, const EngineMove* moves, const TurnStat* turns) {
+        if (!f) return;
+        r.size = (uint32_t)record_size(r.plies);
+        std::vector<char> buf(r.size, 0);
+        memcpy(&buf[0], &r, sizeof(r));
+        memcpy(&buf[sizeof(r)], moves, r.plies * sizeof(EngineMove));
+        memcpy(&buf[r.size - r.plies * sizeof(TurnStat)], turns, r.plies * sizeof(TurnStat));
+        fwrite(&buf[0], 1, buf.size(), f);
+        fflush(f);
+        index.push_back(offset);
+        offset += r.size;
+    }
+
+    void close() {
+        if (!f) return;
+        fwrite(index.data(), sizeof(uint64_t), index.size(), f);
+        GameLogHeader h;
+        memcpy(h.magic, GAMELOG_MAGIC, sizeof(h.magic));
+        h.version = 1;
+        h.games = (uint32_t)index.size();
+        h.index_offset = offset;
+        fseek(f, 0, SEEK_SET);
+        fwrite(&h, sizeof(h), 1, f);
+        fclose(f);
+        f = nullptr;
+    }
+
+private:
+    FILE* f;
+    uint64_t offset;
+    std::vector<uint64_t> index;
+};
+
+class GameLog {
+public:
+    GameLog() : data(nullptr), length(0) {}
+    ~GameLog() {
+        if (data) munmap((void*)data, length);
+    }
+    GameLog(const GameLog&) = delete;
+    GameLog& operator=(const GameLog&) = delete;
+
+    // False if the file is missing or not a game log
+    bool open(const char* path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(GameLogHeader)) {
+            ::close(fd);
+            return false;
+        }
+        length = (size_t)st.st_size;
+        void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        data = (const char*)p;
+        const GameLogHeader* h = (const GameLogHeader*)data;
+        if (memcmp(h->magic, GAMELOG_MAGIC, sizeof(h->magic)) != 0) return false;
+        if (h->index_offset && h->index_offset + h->games * sizeof(uint64_t) <= length) {
+            offsets = (const uint64_t*)(data + h->index_offset);
+            games = h->games;
+        } else {
+            // No index: walk the records
+            for (uint64_t at = sizeof(GameLogHeader); at + sizeof(GameRecord) <= length;) {
+                uint32_t size = ((const GameRecord*)(data + at))->size;
+                if (size < sizeof(GameRecord) || at + size > length) break;
+                scanned.push_back(at);
+                at += size;
+            }
+            offsets = scanned.data();
+            games = scanned.size();
+        }
+        return true;
+    }
+
+    size_t size() const { return games; }
+
+    GameView game(size_t i) const {
+        const GameRecord* r = (const GameRecord*)(data + offsets[i]);
+        GameView v = { r, (const EngineMove*)(r + 1),
+                       (const TurnStat*)((const char*)r + r->size - r->plies * sizeof(TurnStat)) };
+        return v;
+    }
+
+    // f(game index, position) for every game at least ply plies long, after its
+    // first ply moves; turn N of Black is ply 2N - 2, of White 2N - 1
+    template <class F>
+    void every_position(int ply, F f) const {
+        for (size_t i = 0; i < games; i++) {
+            GameView g = game(i);
+            if (g.plies() < ply) continue;
+            LogPosition p;
+            for (int k = 0; k < ply; k++) p.apply(g.moves[k]);
+            f(i, p);
+        }
+    }
+
+private:
+    const char* data;
+    size_t length;
+    const uint64_t* offsets = nullptr;
+    size_t games = 0;
+    std::vector<uint64_t> scanned;
+};
+
+#endif
@@ -0,0 +1,255 @@
+// nnue_train.cpp - fit bot033's NNUE evaluator and embed the quantized weights
+// The network (see "NNUE ACCUMULATOR" in bots/bot033.cpp) is trained to reproduce
+// the handcrafted evaluation on positions from semi-random games: every move is
+// the best prior move (CURSOR_PRIOR) or a uniformly random one, half and half.
+// The target is the handcrafted score before fast_sigmoid, for Black, clipped to
+// +-TARGET_CLIP. Every position is also used colour-swapped and mirrored.
+// Given a game log (tools/arena --log, format in tools/gamelog.h) instead of a
+// game count, the positions of the logged games are used instead.
+// Build: g++ -O3 -std=c++11 -o tools/nnue_train tools/nnue_train.cpp
+// Usage: tools/nnue_train [bot.cpp] [games | LOG] [epochs]
+//        rewrites the block between BEGIN/END NNUE WEIGHTS in bot.cpp
+
+#define EVAL_NNUE 0
+#define main bot_main
+#include "../bots/bot033.cpp"
+#undef main
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include "gamelog.h"
+
+const double TARGET_CLIP = 8.0;
+
+struct Sample {
+    uint64_t pieces[2], arrows;
+    float target;
+};
+
+// Column mirror with colours swapped: the start position maps onto itself
+inline uint64_t mirror(uint64_t b) {
+    uint64_t r = 0;
+    for (; b; b = clear_lsb(b)) {
+        int sq = lsb_index(b);
+        r |= 1ULL << (sq / 8 * 8 + 7 - sq % 8);
+    }
+    return r;
+}
+
+// The position and its colour-swapped mirror image
+void add_samples(const Board& b, int turn, vector<Sample>& out) {
+    double p = evaluate(b, BLACK, turn);
+    double y = 2 * p - 1;
+    double x = max(-TARGET_CLIP, min(TARGET_CLIP, y / max(1e-9, 1 - fabs(y)))); // fast_sigmoid^-1
+    Sample s = { { b.pieces[0], b.pieces[1] }, b.arrows, (float)x };
+    out.push_back(s);
+    Sample m = { { mirror(b.pieces[1]), mirror(b.pieces[0]) }, mirror(b.arrows), (float)-x };
+    out.push_back(m);
+}
+
+void generate(int games, vector<Sample>& out) {
+    for (int g = 0; g < games; g++) {
+        Board b;
+        int color = BLACK;
+        for (int ply = 0;; ply++) {
+            MoveCursor mc;
+            if (fast_rand() & 1) mc.init_prior(b, color);
+            else mc.init(b, color);
+            if (!mc.has_next()) break;
+            b.apply_move(mc.next(b));
+            color = -color;
+            add_samples(b, ply / 2 + 1, out);
+        }
+    }
+}
+
+// Every position after a move of the logged games
+void generate(const GameLog& log, vector<Sample>& out) {
+    for (size_t i = 0; i < log.size(); i++) {
+        GameView g = log.game(i);
+        Board b;
+        for (int ply = 0; ply < g.plies(); ply++) {
+            b.apply_move(Move(g.moves[ply].from, g.moves[ply].to, g.moves[ply].arrow));
+            add_samples(b, ply / 2 + 1, out);
+        }
+    }
+}
+
+inline int features(const Sample& s, int* f) {
+    int n = 0;
+    for (int c = 0; c < 2; c++)
+        for (uint64_t b = s.pieces[c]; b; b = clear_lsb(b)) f[n++] = c * NUM_SQUARES + lsb_index(b);
+    for (uint64_t b = s.arrows; b; b = clear_lsb(b)) f[n++] = NNUE_ARROW + lsb_index(b);
+    return n;
+}
+
+struct Net {
+    vector<float> w1, b1, w2;
+    float b2;
+    Net() : w1(NNUE_FEATURES * NNUE_HIDDEN), b1(NNUE_HIDDEN), w2(NNUE_HIDDEN), b2(0) {}
+};
+
+struct Adam {
+    vector<float> m, v;
+    explicit Adam(size_t n) : m(n), v(n) {}
+    void step(float* w, const float* g, size_t n, float lr, int t, float lo, float hi) {
+        const float b1 = 0.9f, b2 = 0.999f;
+        float c1 = 1 - pow(b1, t), c2 = 1 - pow(b2, t);
+        for (size_t i = 0; i < n; i++) {
+            m[i] = b1 * m[i] + (1 - b1) * g[i];
+            v[i] = b2 * v[i] + (1 - b2) * g[i] * g[i];
+            w[i] -= lr * (m[i] / c1) / (sqrt(v[i] / c2) + 1e-8f);
+            w[i] = min(hi, max(lo, w[i]));
+        }
+    }
+};
+
+// Forward pass; h receives the hidden pre-activations
+inline float forward(const Net& net, const int* f, int n, float* h) {
+    for (int j = 0; j < NNUE_HIDDEN; j++) h[j] = net.b1[j];
+    for (int k = 0; k < n; k++)
+        for (int j = 0; j < NNUE_HIDDEN; j++) h[j] += net.w1[f[k] * NNUE_HIDDEN + j];
+    float out = net.b2;
+    for (int j = 0; j < NNUE_HIDDEN; j++) out += min(max(h[j], 0.0f), 1.0f) * net.w2[j];
+    return out;
+}
+
+double mse(const Net& net, const vector<Sample>& data, size_t lo, size_t hi) {
+    int f[NUM_SQUARES];
+    float h[NNUE_HIDDEN];
+    double sum = 0;
+    for (size_t i = lo; i < hi; i++) {
+        double d = forward(net, f, features(data[i], f), h) - data[i].target;
+        sum += d * d;
+    }
+    return sum / (hi - lo);
+}
+
+// Integer forward pass exactly as evaluate_nnue computes it
+double quantized_mse(const vector<int16_t>& w1, const vector<int16_t>& b1, const vector<int8_t>& w2, int32_t b2,
+                     const vector<Sample>& data, size_t lo, size_t hi) {
+    int f[NUM_SQUARES];
+    double sum = 0;
+    for (size_t i = lo; i < hi; i++) {
+        int n = features(data[i], f);
+        int16_t acc[NNUE_HIDDEN];
+        for (int j = 0; j < NNUE_HIDDEN; j++) acc[j] = b1[j];
+        for (int k = 0; k < n; k++)
+            for (int j = 0; j < NNUE_HIDDEN; j++) acc[j] += w1[f[k] * NNUE_HIDDEN + j];
+        int32_t s = b2;
+        for (int j = 0; j < NNUE_HIDDEN; j++) s += min(max((int)acc[j], 0), NNUE_QA) * w2[j];
+        double d = (double)s / (NNUE_QA * NNUE_QB) - data[i].target;
+        sum += d * d;
+    }
+    return sum / (hi - lo);
+}
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "bots/bot033.cpp";
+    const char* games = argc > 2 ? argv[2] : "20000";
+    int epochs = argc > 3 ? atoi(argv[3]) : 6;
+    init_zobrist();
+    init_cpu_dispatch();
+    seed_rng(1);
+
+    vector<Sample> data;
+    GameLog log;
+    if (log.open(games)) generate(log, data);
+    else generate(atoi(games), data);
+    mt19937 rng(1);
+    shuffle(data.begin(), data.end(), rng);
+    size_t n_val = data.size() / 20, n_train = data.size() - n_val;
+    double mean = 0, var = 0;
+    for (const Sample& s : data) mean += s.target;
+    mean /= data.size();
+    for (const Sample& s : data) var += (s.target - mean) * (s.target - mean);
+    fprintf(stderr, "%zu positions (%zu held out), target variance %.4f\n", data.size(), n_val, var / data.size());
+
+    Net net;
+    normal_distribution<float> init(0.0f, 0.1f);
+    for (float& w : net.w1) w = init(rng);
+    for (int j = 0; j < NNUE_HIDDEN; j++) {
+        net.b1[j] = 0.5f;
+        net.w2[j] = init(rng);
+    }
+    // Weight bounds keep the int16 accumulator and int8 output weights in range
+    const float W1_MAX = 2.0f, W2_MAX = 127.0f / NNUE_QB;
+    Adam a_w1(net.w1.size()), a_b1(NNUE_HIDDEN), a_w2(NNUE_HIDDEN), a_b2(1);
+    vector<float> g_w1(net.w1.size()), g_b1(NNUE_HIDDEN), g_w2(NNUE_HIDDEN);
+    const int BATCH = 256;
+    int t = 0;
+    for (int e = 0; e < epochs; e++) {
+        float lr = 1e-3f * (e + 1 == epochs ? 0.3f : 1.0f);
+        for (size_t i0 = 0; i0 + BATCH <= n_train; i0 += BATCH) {
+            fill(g_w1.begin(), g_w1.end(), 0.0f);
+            fill(g_b1.begin(), g_b1.end(), 0.0f);
+            fill(g_w2.begin(), g_w2.end(), 0.0f);
+            float g_b2 = 0;
+            for (size_t i = i0; i < i0 + BATCH; i++) {
+                int f[NUM_SQUARES];
+                float h[NNUE_HIDDEN];
+                int n = features(data[i], f);
+                float d = 2 * (forward(net, f, n, h) - data[i].target) / BATCH;
+                g_b2 += d;
+                for (int j = 0; j < NNUE_HIDDEN; j++) {
+                    float a = min(max(h[j], 0.0f), 1.0f);
+                    g_w2[j] += d * a;
+                    if (h[j] <= 0 || h[j] >= 1) continue;
+                    float gh = d * net.w2[j];
+                    g_b1[j] += gh;
+                    for (int k = 0; k < n; k++) g_w1[f[k] * NNUE_HIDDEN + j] += gh;
+                }
+            }
+            t++;
+            a_w1.step(net.w1.data(), g_w1.data(), g_w1.size(), lr, t, -W1_MAX, W1_MAX);
+            a_b1.step(net.b1.data(), g_b1.data(), NNUE_HIDDEN, lr, t, -W1_MAX, W1_MAX);
+            a_w2.step(net.w2.data(), g_w2.data(), NNUE_HIDDEN, lr, t, -W2_MAX, W2_MAX);
+            a_b2.step(&net.b2, &g_b2, 1, lr, t, -TARGET_CLIP, TARGET_CLIP);
+        }
+        fprintf(stderr, "epoch %d: train mse %.4f, held-out mse %.4f\n", e + 1,
+                mse(net, data, 0, min(n_train, n_val)), mse(net, data, n_train, data.size()));
+    }
+
+    vector<int16_t> q1(net.w1.size()), qb1(NNUE_HIDDEN);
+    vector<int8_t> q2(NNUE_HIDDEN);
+    for (size_t i = 0; i < q1.size(); i++) q1[i] = (int16_t)lround(net.w1[i] * NNUE_QA);
+    for (int j = 0; j < NNUE_HIDDEN; j++) {
+        qb1[j] = (int16_t)lround(net.b1[j] * NNUE_QA);
+        q2[j] = (int8_t)lround(net.w2[j] * NNUE_QB);
+    }
+    int32_t qb2 = (int32_t)lround(net.b2 * NNUE_QA * NNUE_QB);
+    fprintf(stderr, "quantized held-out mse %.4f\n", quantized_mse(q1, qb1, q2, qb2, data, n_train, data.size()));
+
+    ostringstream w;
+    w << "// BEGIN NNUE WEIGHTS\n";
+    w << "// tools/nnue_train.cpp: " << games << " games, " << epochs << " epochs\n";
+    w << "constexpr int16_t NNUE_W1[NNUE_FEATURES][NNUE_HIDDEN] = {\n";
+    for (int f = 0; f < NNUE_FEATURES; f++) {
+        w << "    {";
+        for (int j = 0; j < NNUE_HIDDEN; j++) w << (j ? "," : "") << q1[f * NNUE_HIDDEN + j];
+        w << "}" << (f + 1 < NNUE_FEATURES ? "," : "") << "\n";
+    }
+    w << "};\nconstexpr int16_t NNUE_B1[NNUE_HIDDEN] = {";
+    for (int j = 0; j < NNUE_HIDDEN; j++) w << (j ? "," : "") << qb1[j];
+    w << "};\nconstexpr int8_t NNUE_W2[NNUE_HIDDEN] = {";
+    for (int j = 0; j < NNUE_HIDDEN; j++) w << (j ? "," : "") << (int)q2[j];
+    w << "};\nconstexpr int32_t NNUE_B2 = " << qb2 << ";\n// END NNUE WEIGHTS";
+
+    ifstream in(path);
+    stringstream src;
+    src << in.rdbuf();
+    string text = src.str();
+    size_t a = text.find("// BEGIN NNUE WEIGHTS"), b = text.find("// END NNUE WEIGHTS");
+    if (a == string::npos || b == string::npos) {
+        fprintf(stderr, "%s: no NNUE WEIGHTS block\n", path);
+        return 1;
+    }
+    text.replace(a, b + strlen("// END NNUE WEIGHTS") - a, w.str());
+    ofstream(path) << text;
+    fprintf(stderr, "weights written to %s\n", path);
+    return 0;
+}
@@ -0,0 +1,470 @@
+// perft.cpp - leaf counts of the move generators, cross-checked between boards
+// perft(d) is the number of move sequences of length d from a position (a side
+// with no move ends a line early, so stalemated lines contribute nothing past
+// that ply). Every board representation in the tree is compiled in, each in its
+// own namespace, and must agree on every position:
+//   bot002    bitboards, vector<Move> generation
+//   bot032    int8 grid, global move pool
+//   bot033    bitboards with ray tables
+//   core      engine/board.h BitBoard (bot034)
+//   occupancy engine/occupancy.h OccupancyBoard (bot035), AVX2 or scalar
+//   opponent  opponent.cpp State with its AVX2 sliding kernel
+// Positions are the start position plus the corpus of tools/bench. When the
+// counts differ, the position is divided: each root move is played on every
+// board and the first moves with different subtree counts are printed.
+// Each implementation's time is reported as leaves per second.
+// Build: g++ -O3 -std=c++11 -o tools/perft tools/perft.cpp
+// Usage: tools/perft [--depth D] [--corpus FILE] [--no-corpus] [--only PHASE]
+
+// Everything the bots include, so their own #includes add nothing to the namespaces
+#include <iostream>
+#include <vector>
+#include <array>
+#include <deque>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <sstream>
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include <assert.h>
+#include <immintrin.h>
+
+namespace b002 {
+#define main bot_main
+#include "../bots/bot002.cpp"
+#undef main
+}
+
+namespace b032 {
+#define main bot_main
+#include "../bots/bot032.cpp"
+#undef main
+}
+
+namespace b033 {
+#define main bot_main
+#include "../bots/bot033.cpp"
+#undef main
+}
+
+#include "../engine/board.h"
+#include "../engine/occupancy.h"
+
+// opponent.cpp switches the rest of the file to AVX2 and defines bool, BLACK,
+// min and friends as macros: keep both inside this block (see tools/bench.cpp)
+#pragma GCC push_options
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wstrict-aliasing"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#pragma GCC diagnostic ignored "-Wformat"
+namespace opp {
+#define main opponent_main
+#include "../bots/opponent.cpp"
+#undef main
+
+// generate_moves' enumeration, recursing on each child instead of storing it
+uint64_t perft(const State* s, int turn, int depth) {
+    if (depth == 0) return 1;
+    uint64_t b0 = s->board, leaves = 0;
+    for (uint64_t chess = s->coor[turn]; chess;) {
+        uint64_t chess_coor = chess & (-chess);
+        chess ^= chess_coor;
+        for (uint64_t can_moves = get_queen_can_moves_avx2(~b0, chess_coor); can_moves;) {
+            uint64_t new_pos = can_moves & (-can_moves);
+            can_moves ^= new_pos;
+            b0 ^= (new_pos ^ chess_coor);
+            for (uint64_t arrow_can = get_queen_can_moves_avx2(~b0, new_pos); arrow_can;) {
+                uint64_t arrow_pos = arrow_can & (-arrow_can);
+                arrow_can -= arrow_pos;
+                if (depth == 1) {
+                    leaves++;
+                    continue;
+                }
+                State child = *s;
+                child.board = b0 ^ arrow_pos;
+                child.coor[turn] ^= (new_pos ^ chess_coor);
+                leaves += perft(&child, 1 - turn, depth - 1);
+            }
+            b0 ^= (new_pos ^ chess_coor);
+        }
+    }
+    return leaves;
+}
+}
+#undef bool
+#undef true
+#undef false
+#undef BLACK
+#undef WHITE
+#undef BOARD_SIZE
+#undef MAX_COUNT
+#undef min
+#undef __inline
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+typedef array<int, 6> BotzoneMove; // x0 y0 x1 y1 x2 y2
+const int MAX_DEPTH = 8;
+
+// One board implementation: a position set up by replaying moves, then perft
+class Perft {
+public:
+    virtual ~Perft() {}
+    virtual const char* name() const = 0;
+    virtual void reset() = 0;
+    virtual void play(const BotzoneMove& m) = 0;
+    virtual uint64_t perft(int depth) = 0;
+    double seconds = 0;
+    uint64_t leaves = 0;
+};
+
+inline int square(int x, int y) {
+    return x * 8 + y;
+}
+
+class Perft002 : public Perft {
+public:
+    const char* name() const override { return "bot002"; }
+    void reset() override {
+        board = b002::Board();
+        color = b002::BLACK;
+    }
+    void play(const BotzoneMove& m) override {
+        b002::apply_move(board, b002::Move(square(m[0], m[1]), square(m[2], m[3]), square(m[4], m[5])), color);
+        color = 1 - color;
+    }
+    uint64_t perft(int depth) override { return run(board, color, depth); }
+
+private:
+    b002::Board board;
+    int color;
+    vector<b002::Move> lists[MAX_DEPTH + 1];
+
+    uint64_t run(const b002::Board& b, int c, int depth) {
+        if (depth == 0) return 1;
+        vector<b002::Move>& moves = lists[depth];
+        b002::generate_moves(b, c, moves);
+        if (depth == 1) return moves.size();
+        uint64_t n = 0;
+        for (size_t i = 0; i < moves.size(); i++) {
+            b002::Board next = b;
+            b002::apply_move(next, moves[i], c);
+            n += run(next, 1 - c, depth - 1);
+        }
+        return n;
+    }
+};
+
+class Perft032 : public Perft {
+public:
+    const char* name() const override { return "bot032"; }
+    void reset() override {
+        board = b032::Board();
+        color = b032::BLACK;
+    }
+    void play(const BotzoneMove& m) override {
+        board.apply_move(b032::Move(square(m[0], m[1]), square(m[2], m[3]), square(m[4], m[5])));
+        color = -color;
+    }
+    uint64_t perft(int depth) override {
+        b032::move_pool_ptr = 0;
+        return run(board, color, depth);
+    }
+
+private:
+    b032::Board board;
+    int color;
+
+    // Each level appends its moves to the pool and releases them on return
+    uint64_t run(const b032::Board& b, int c, int depth) {
+        if (depth == 0) return 1;
+        int mark = b032::move_pool_ptr, start, count;
+        b.get_legal_moves(c, start, count);
+        uint64_t n = 0;
+        if (depth == 1) {
+            n = count;
+        } else {
+            for (int i = 0; i < count; i++) {
+                b032::Board next = b;
+                next.apply_move(b032::move_pool[start + i]);
+                n += run(next, -c, depth - 1);
+            }
+        }
+        b032::move_pool_ptr = mark;
+        return n;
+    }
+};
+
+class Perft033 : public Perft {
+public:
+    const char* name() const override { return "bot033"; }
+    void reset() override {
+        board = b033::Board();
+        color = b033::BLACK;
+    }
+    void play(const BotzoneMove& m) override {
+        board.apply_move(b033::Move(square(m[0], m[1]), square(m[2], m[3]), square(m[4], m[5])));
+        color = -color;
+    }
+    uint64_t perft(int depth) override { return run(board, color, depth); }
+
+private:
+    b033::Board board;
+    int color;
+    b033::Move lists[MAX_DEPTH + 1][b033::MAX_MOVES];
+
+    uint64_t run(const b033::Board& b, int c, int depth) {
+        if (depth == 0) return 1;
+        b033::Move* moves = lists[depth];
+        int count = b033::generate_moves(b, c, moves);
+        if (depth == 1) return count;
+        uint64_t n = 0;
+        for (int i = 0; i < count; i++) {
+            b033::Board next = b;
+            next.apply_move(moves[i]);
+            n += run(next, -c, depth - 1);
+        }
+        return n;
+    }
+};
+
+// Any board policy of the engine core
+template <class Board>
+class PerftCore : public Perft {
+public:
+    explicit PerftCore(const char* label) : label(label) {}
+    const char* name() const override { return label; }
+    void reset() override {
+        board = Board();
+        color = amazons::BLACK;
+    }
+    void play(const BotzoneMove& m) override {
+        board.apply(amazons::Move(square(m[0], m[1]), square(m[2], m[3]), square(m[4], m[5])));
+        color = -color;
+    }
+    uint64_t perft(int depth) override { return run(board, color, depth); }
+
+    // Root moves in Botzone coordinates, for dividing
+    vector<BotzoneMove> root_moves() const {
+        vector<BotzoneMove> out;
+        int count = board.generate(color, lists[0]);
+        for (int i = 0; i < count; i++) {
+            const amazons::Move& m = lists[0][i];
+            BotzoneMove b = { { m.from / 8, m.from % 8, m.to / 8, m.to % 8, m.arrow / 8, m.arrow % 8 } };
+            out.push_back(b);
+        }
+        return out;
+    }
+
+private:
+    const char* label;
+    Board board;
+    int color;
+    mutable amazons::Move lists[MAX_DEPTH + 1][amazons::MAX_MOVES];
+
+    uint64_t run(const Board& b, int c, int depth) const {
+        if (depth == 0) return 1;
+        amazons::Move* moves = lists[depth];
+        int count = b.generate(c, moves);
+        if (depth == 1) return count;
+        uint64_t n = 0;
+        for (int i = 0; i < count; i++) {
+            Board next = b;
+            next.apply(moves[i]);
+            n += run(next, -c, depth - 1);
+        }
+        return n;
+    }
+};
+
+class PerftOpponent : public Perft {
+public:
+    const char* name() const override { return "opponent"; }
+    void reset() override {
+        memset(&state, 0, sizeof(state));
+        state.board = (1ull << 2) | (1ull << 5) | (1ull << 16) | (1ull << 23);
+        state.coor[0] = state.board;
+        state.board |= (1ull << 40) | (1ull << 47) | (1ull << 58) | (1ull << 61);
+        state.coor[1] = state.board ^ state.coor[0];
+        turn = 0;
+    }
+    void play(const BotzoneMove& m) override {
+        opp::move(&state, m[0], m[1], m[2], m[3], m[4], m[5], turn);
+        turn = 1 - turn;
+    }
+    uint64_t perft(int depth) override { return opp::perft(&state, turn, depth); }
+
+private:
+    opp::State state;
+    int turn;
+};
+
+struct Position {
+    string label;
+    vector<BotzoneMove> moves;
+};
+
+// tools/bench_corpus.txt: "<phase> <plies>" and that many Botzone moves per line
+bool load_corpus(const string& path, const string& only, vector<Position>& out) {
+    ifstream in(path.c_str());
+    if (!in) {
+        cerr << "perft: cannot read " << path << endl;
+        return false;
+    }
+    string l;
+    int line_no = 0;
+    while (getline(in, l)) {
+        line_no++;
+        if (l.empty() || l[0] == '#') continue;
+        stringstream ss(l);
+        Position p;
+        int plies;
+        if (!(ss >> p.label >> plies)) continue;
+        for (int i = 0; i < plies; i++) {
+            BotzoneMove m;
+            for (int k = 0; k < 6; k++) ss >> m[k];
+            if (!ss) {
+                cerr << "perft: short move list on line " << line_no << endl;
+                return false;
+            }
+            p.moves.push_back(m);
+        }
+        if (!only.empty() && p.label != only) continue;
+        p.label += ":" + to_string(line_no);
+        out.push_back(p);
+    }
+    return true;
+}
+
+void setup(Perft& p, const vector<BotzoneMove>& moves) {
+    p.reset();
+    for (size_t i = 0; i < moves.size(); i++) p.play(moves[i]);
+}
+
+uint64_t timed_perft(Perft& p, int depth) {
+    Clock::time_point t0 = Clock::now();
+    uint64_t n = p.perft(depth);
+    p.seconds += chrono::duration<double>(Clock::now() - t0).count();
+    p.leaves += n;
+    return n;
+}
+
+// Play each root move everywhere and report the first ones whose subtrees disagree
+void divide(vector<Perft*>& impls, PerftCore<amazons::BitBoard>& core, const Position& pos, int depth) {
+    setup(core, pos.moves);
+    vector<BotzoneMove> roots = core.root_moves();
+    int reported = 0;
+    for (size_t r = 0; r < roots.size() && reported < 5; r++) {
+        vector<BotzoneMove> line = pos.moves;
+        line.push_back(roots[r]);
+        vector<uint64_t> counts;
+        bool same = true;
+        for (size_t i = 0; i < impls.size(); i++) {
+            setup(*impls[i], line);
+            counts.push_back(impls[i]->perft(depth - 1));
+            same = same && counts[i] == counts[0];
+        }
+        if (same) continue;
+        reported++;
+        const BotzoneMove& m = roots[r];
+        fprintf(stderr, "  after %d %d %d %d %d %d:", m[0], m[1], m[2], m[3], m[4], m[5]);
+        for (size_t i = 0; i < impls.size(); i++) fprintf(stderr, " %s=%llu", impls[i]->name(), (unsigned long long)counts[i]);
+        fprintf(stderr, "\n");
+    }
+    if (!reported) fprintf(stderr, "  every root move agrees: the root move lists themselves differ\n");
+}
+
+int main(int argc, char** argv) {
+    int depth = 2;
+    string corpus = "tools/bench_corpus.txt", only;
+    bool use_corpus = true;
+    for (int i = 1; i < argc; i++) {
+        string a = argv[i];
+        bool has = i + 1 < argc;
+        if (a == "--depth" && has) depth = atoi(argv[++i]);
+        else if (a == "--corpus" && has) corpus = argv[++i];
+        else if (a == "--only" && has) only = argv[++i];
+        else if (a == "--no-corpus") use_corpus = false;
+        else {
+            cerr << "usage: " << argv[0] << " [--depth D] [--corpus FILE] [--no-corpus] [--only PHASE]" << endl;
+            return 2;
+        }
+    }
+    if (depth < 1 || depth > MAX_DEPTH) {
+        cerr << "perft: depth must be 1.." << MAX_DEPTH << endl;
+        return 2;
+    }
+
+    b033::init_zobrist();
+    vector<Position> positions;
+    if (only.empty() || only == "start") positions.push_back(Position{ "start", {} });
+    if (use_corpus && !load_corpus(corpus, only, positions)) return 1;
+
+    static Perft002 p002;
+    static Perft032 p032;
+    static Perft033 p033;
+    static PerftCore<amazons::BitBoard> core("core");
+    static PerftCore<amazons::OccupancyBoard> occupancy("occupancy");
+    static PerftOpponent opponent;
+    vector<Perft*> impls = { &p002, &p032, &p033, &core, &occupancy };
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) impls.push_back(&opponent);
+    else cerr << "perft: no AVX2, opponent.cpp skipped" << endl;
+    static PerftCore<amazons::BitBoard> divider("core");
+
+    int mismatches = 0;
+    for (size_t k = 0; k < positions.size(); k++) {
+        const Position& pos = positions[k];
+        vector<uint64_t> counts;
+        for (size_t i = 0; i < impls.size(); i++) {
+            setup(*impls[i], pos.moves);
+            counts.push_back(timed_perft(*impls[i], depth));
+        }
+        bool same = true;
+        for (size_t i = 1; i < impls.size(); i++) same = same && counts[i] == counts[0];
+        printf("%-12s perft(%d) = %llu%s\n", pos.label.c_str(), depth, (unsigned long long)counts[0],
+               same ? "" : "  MISMATCH");
+        if (same) continue;
+        mismatches++;
+        for (size_t i = 0; i < impls.size(); i++)
+            fprintf(stderr, "  %-9s %llu\n", impls[i]->name(), (unsigned long long)counts[i]);
+        if (depth > 1) divide(impls, divider, pos, depth);
+    }
+
+    printf("\n%-9s %13s %10s %12s\n", "board", "leaves", "seconds", "Mleaves/s");
+    for (size_t i = 0; i < impls.size(); i++) {
+        const Perft& p = *impls[i];
+        printf("%-9s %13llu %10.3f %12.2f\n", p.name(), (unsigned long long)p.leaves, p.seconds,
+               p.seconds > 0 ? p.leaves / p.seconds / 1e6 : 0.0);
+    }
+    if (mismatches) {
+        printf("%d position(s) disagree\n", mismatches);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+// process_engine.h - Engine adapter for a compiled Botzone bot
+// Runs the executable once per move with the simple (non long-running)
+// protocol, exactly as Botzone and scripts/tournament/bot_runner.py do: the
+// turn number, then the 2n-1 request and response lines of the game so far.
+// The first line the bot prints is its move; the process is then killed, so a
+// bot that asks to keep running is restarted next turn. The bot keeps its own
+// clock: EngineBudget is not passed on, and a "fixed-time" game runs at the
+// limits compiled into the bot. This lets the arena play old bots and
+// bots/opponent.cpp, which do not provide what tools/bot_engine.inc calls.
+#ifndef AMAZONS_PROCESS_ENGINE_H
+#define AMAZONS_PROCESS_ENGINE_H
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "engine.h"
+
+class ProcessEngine : public Engine {
+public:
+    // A bot that has not answered after timeout seconds forfeits the move
+    ProcessEngine(const char* label, const char* path, double timeout = 10)
+        : label(label), path(path), timeout(timeout), last_rss(0) {
+        signal(SIGPIPE, SIG_IGN); // A bot that exits before reading its input must not kill us
+    }
+
+    const char* name() const override { return label; }
+
+    void reset() override { history.clear(); }
+
+    void play(const EngineMove& m) override { history.push_back(m); }
+
+    size_t resident() const override { return last_rss; } // Peak of the last run
+
+    EngineMove think(const EngineBudget&) override {
+        EngineMove none = { 255, 255, 255 };
+        int in[2], out[2];
+        if (pipe(in) != 0) return none;
+        if (pipe(out) != 0) {
+            close(in[0]);
+            close(in[1]);
+            return none;
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            dup2(in[0], 0);
+            dup2(out[1], 1);
+            int null = open("/dev/null", O_WRONLY);
+            if (null >= 0) dup2(null, 2);
+            close(in[0]);
+            close(in[1]);
+            close(out[0]);
+            close(out[1]);
+            execl(path, path, (char*)nullptr);
+            _exit(127);
+        }
+        close(in[0]);
+        close(out[1]);
+        EngineMove m = none;
+        if (pid > 0) {
+            std::string request = input();
+            // The request (at most 93 lines) fits in the pipe buffer
+            ssize_t w = write(in[1], request.data(), request.size());
+            (void)w;
+            close(in[1]);
+            m = read_move(out[0]);
+            kill(pid, SIGKILL);
+            struct rusage ru;
+            last_rss = wait4(pid, nullptr, 0, &ru) == pid ? (size_t)ru.ru_maxrss * 1024 : 0;
+        } else {
+            close(in[1]);
+        }
+        close(out[0]);
+        return m;
+    }
+
+private:
+    const char* label;
+    const char* path;
+    double timeout;
+    size_t last_rss;
+    std::vector<EngineMove> history;
+
+    static void append(std::string& s, const EngineMove& m) {
+        char line[32];
+        snprintf(line, sizeof(line), "%d %d %d %d %d %d\n", m.from / 8, m.from % 8, m.to / 8, m.to % 8,
+                 m.arrow / 8, m.arrow % 8);
+        s += line;
+    }
+
+    // Black's first request is "-1 ..."; after it the lines are the game's moves in order
+    std::string input() const {
+        std::string s = std::to_string(history.size() / 2 + 1) + "\n";
+        if (history.size() % 2 == 0) s += "-1 -1 -1 -1 -1 -1\n";
+        for (const EngineMove& m : history) append(s, m);
+        return s;
+    }
+
+    // First output line as a move; none on timeout, EOF or a malformed line
+    EngineMove read_move(int fd) const {
+        EngineMove none = { 255, 255, 255 };
+        std::string line;
+        int left_ms = (int)(timeout * 1000);
+        char buf[256];
+        while (line.find('\n') == std::string::npos) {
+            struct pollfd p = { fd, POLLIN, 0 };
+            auto t0 = std::chrono::steady_clock::now();
+            if (left_ms <= 0 || poll(&p, 1, left_ms) <= 0) return none;
+            ssize_t n = read(fd, buf, sizeof(buf));
+            if (n <= 0) return none;
+            line.append(buf, n);
+            left_ms -= (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now() - t0).count();
+        }
+        int c[6];
+        if (sscanf(line.c_str(), "%d %d %d %d %d %d", &c[0], &c[1], &c[2], &c[3], &c[4], &c[5]) != 6) return none;
+        for (int k = 0; k < 6; k++)
+            if (c[k] < 0 || c[k] > 7) return none;
+        EngineMove m = { (uint8_t)(c[0] * 8 + c[1]), (uint8_t)(c[2] * 8 + c[3]), (uint8_t)(c[4] * 8 + c[5]) };
+        return m;
+    }
+};
+
+#endif
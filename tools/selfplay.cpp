@@ -0,0 +1,206 @@
+// selfplay.cpp - bot033 self-play driver writing fixed-size training records
+// Links the engine directly: no pipes, no Botzone protocol, no process per turn.
+// --jobs worker processes each play every jobs-th game with their own tree and
+// memory budget (fork, so the engine's per-process state needs no changes) and
+// append whole games to one file opened O_APPEND.
+// Build: g++ -O3 -std=c++11 -o tools/selfplay tools/selfplay.cpp
+// Usage: tools/selfplay out.bin [--games N] [--jobs J] [--movetime S]
+//                               [--random-plies K] [--seed X]
+//
+// File layout (little endian): SelfPlayHeader, then SelfPlayRecord[] to the end
+// of the file. Both are fixed-size and packed, so the file can be mmap'ed and
+// indexed directly.
+
+#define main bot_main
+#include "../bots/bot033.cpp"
+#undef main
+
+#include <sys/wait.h>
+
+const char SELFPLAY_MAGIC[8] = { 'A', 'M', 'Z', 'S', 'P', '0', '1', 0 };
+const int RECORD_TOP_MOVES = 16; // Most visited root moves kept per position
+
+#pragma pack(push, 1)
+struct SelfPlayHeader {
+    char magic[8];
+    uint32_t record_size;
+    uint32_t top_moves;
+};
+
+struct SelfPlayRecord {
+    uint64_t pieces[2];    // [0] = BLACK, [1] = WHITE amazons
+    uint64_t arrows;
+    uint8_t side_to_move;  // 0 = BLACK, 1 = WHITE
+    uint8_t turn;          // Botzone turn number of the side to move
+    int8_t result;         // Final result for the side to move: 1 win, -1 loss
+    uint8_t move_count;    // Entries used in moves/visits
+    uint8_t solved;        // 1: the endgame solver chose the move, moves[0] only
+    uint8_t reserved[3];
+    float value;           // Search value of the played move for the side to move
+    uint32_t root_visits;  // Sum over all root children
+    Move moves[RECORD_TOP_MOVES];       // By decreasing visits
+    uint16_t visits[RECORD_TOP_MOVES];  // Share of root_visits, scaled to 65535
+};
+#pragma pack(pop)
+
+struct Options {
+    const char* out = nullptr;
+    int games = 100;
+    int jobs = 1;
+    double movetime = 0.1;
+    int random_plies = 4;  // Opening plies drawn from the visit distribution
+    uint32_t seed = 1;
+};
+
+// One search from the kept tree; fills rec except result and returns the move to play
+Move think(const Board& board, int color, int ply, const Options& opt, SelfPlayRecord& rec) {
+    int turn = ply / 2 + 1;
+    auto start = chrono::steady_clock::now();
+    memset(&rec, 0, sizeof(rec));
+    rec.pieces[0] = board.pieces[0];
+    rec.pieces[1] = board.pieces[1];
+    rec.arrows = board.arrows;
+    rec.side_to_move = (uint8_t)Board::side(color);
+    rec.turn = (uint8_t)turn;
+
+    Move solved;
+    if (ENDGAME_SOLVER && solve_endgame(board, color, start, opt.movetime * ENDGAME_TIME_SHARE, solved)) {
+        rec.solved = 1;
+        rec.move_count = 1;
+        rec.moves[0] = solved;
+        rec.visits[0] = 65535;
+        return solved;
+    }
+    Move best = search(board, color, turn, start, opt.movetime);
+
+    vector<RootStat> stats;
+    collect_root_stats(board, stats);
+    sort(stats.begin(), stats.end(), [](const RootStat& a, const RootStat& b) { return a.visits > b.visits; });
+    uint64_t total = 0;
+    for (const RootStat& st : stats) total += st.visits;
+    rec.root_visits = (uint32_t)total;
+    rec.move_count = (uint8_t)min((int)stats.size(), RECORD_TOP_MOVES);
+    for (int i = 0; i < rec.move_count; i++) {
+        rec.moves[i] = stats[i].move;
+        rec.visits[i] = (uint16_t)(total ? stats[i].visits * 65535 / total : 0);
+    }
+
+    // Early plies: sample by visits so games do not repeat
+    if (ply < opt.random_plies && total > 0) {
+        uint64_t r = ((uint64_t)fast_rand() << 32 | fast_rand()) % total;
+        for (const RootStat& st : stats) {
+            if (r < (uint64_t)st.visits) {
+                best = st.move;
+                break;
+            }
+            r -= st.visits;
+        }
+    }
+
+    const MCTSNode& root = node_pool[tree_root];
+    for (int i = 0; i < root.child_count; i++) {
+        int c = root.first_child + i;
+        if (node_visits[c] > 0 && full_move(c, board) == best) rec.value = node_wins[c] / node_visits[c];
+    }
+    return best;
+}
+
+// Play one game from the start position; records come back with results filled in
+void play_game(const Options& opt, vector<SelfPlayRecord>& records) {
+    records.clear();
+    reset_pool();
+    tree_root = NO_NODE;
+    Board board;
+    int color = BLACK;
+    for (int ply = 0;; ply++) {
+        SelfPlayRecord rec;
+        Move m = think(board, color, ply, opt, rec);
+        if (m.from == 255) {
+            // color cannot move and loses
+            for (SelfPlayRecord& r : records) r.result = r.side_to_move == Board::side(color) ? -1 : 1;
+            return;
+        }
+        records.push_back(rec);
+        board.apply_move(m);
+        advance_root(m);
+        color = -color;
+    }
+}
+
+void worker(const Options& opt, int fd, int id) {
+    init_arena();
+    init_thread_state(0);
+    seed_rng(0);
+    xorshift_state ^= opt.seed * 0x85EBCA6BU + id * 0xC2B2AE35U;
+    vector<SelfPlayRecord> records;
+    for (int g = id; g < opt.games; g += opt.jobs) {
+        play_game(opt, records);
+        size_t bytes = records.size() * sizeof(SelfPlayRecord);
+        if (write(fd, records.data(), bytes) != (ssize_t)bytes) {
+            perror("write");
+            _exit(1);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; i++) {
+        string a = argv[i];
+        bool has_value = i + 1 < argc;
+        if (a == "--games" && has_value) opt.games = atoi(argv[++i]);
+        else if (a == "--jobs" && has_value) opt.jobs = max(1, atoi(argv[++i]));
+        else if (a == "--movetime" && has_value) opt.movetime = atof(argv[++i]);
+        else if (a == "--random-plies" && has_value) opt.random_plies = atoi(argv[++i]);
+        else if (a == "--seed" && has_value) opt.seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else opt.out = argv[i];
+    }
+    if (!opt.out) {
+        fprintf(stderr, "usage: %s out.bin [--games N] [--jobs J] [--movetime S] [--random-plies K] [--seed X]\n", argv[0]);
+        return 2;
+    }
+
+    init_zobrist();
+    init_ucb_tables();
+    init_widening();
+    init_cpu_dispatch();
+
+    int fd = open(opt.out, O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        perror(opt.out);
+        return 1;
+    }
+    if (lseek(fd, 0, SEEK_END) == 0) {
+        SelfPlayHeader h;
+        memcpy(h.magic, SELFPLAY_MAGIC, sizeof(h.magic));
+        h.record_size = sizeof(SelfPlayRecord);
+        h.top_moves = RECORD_TOP_MOVES;
+        if (write(fd, &h, sizeof(h)) != (ssize_t)sizeof(h)) {
+            perror("write");
+            return 1;
+        }
+    }
+
+    auto t0 = chrono::steady_clock::now();
+    for (int id = 0; id < opt.jobs; id++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            worker(opt, fd, id);
+            _exit(0);
+        }
+        if (pid < 0) {
+            perror("fork");
+            return 1;
+        }
+    }
+    int failed = 0, status;
+    while (wait(&status) > 0) failed += !(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    off_t size = lseek(fd, 0, SEEK_END);
+    close(fd);
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    fprintf(stderr, "%s: %lld records (%d games, %.1f s)%s\n", opt.out,
+            (long long)((size - (off_t)sizeof(SelfPlayHeader)) / (off_t)sizeof(SelfPlayRecord)), opt.games, secs,
+            failed ? ", some workers failed" : "");
+    return failed ? 1 : 0;
+}
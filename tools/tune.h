@@ -0,0 +1,184 @@
+// tune.h - wire protocol and SPSA state of distributed tuning (tools/arena --tune)
+// One coordinator (tools/arena --tune ... --listen PORT) owns the parameter
+// vector; any number of workers (tools/arena --worker HOST:PORT, on any host)
+// connect over TCP and each play batches of games at their full core count.
+// A worker announces itself with a TuneHello; the coordinator answers with a
+// TuneJob: the parameter sets of engine A (theta + c * delta) and engine B
+// (theta - c * delta) for one SPSA perturbation, and the batch to play. The
+// worker streams one TuneGame per finished game and a TuneGame with game -1
+// when the batch is done, then waits for its next job. Jobs are independent,
+// so the coordinator never waits for a slow host: it updates theta from each
+// batch as it arrives (asynchronous SPSA), and throughput grows with the
+// number of workers. All structs are sent raw: every host must be
+// little-endian with the same ABI, which the tools assume anyway.
+//
+// SPSA follows the usual schedule: after k game pairs, c_k = c / (k+1)^0.101
+// and a_k = a / (A+k+1)^0.602 with A = N/10 for N pairs in all; c is chosen
+// so c_N is the per-parameter step (--tune-step, as a fraction of the start
+// value), and a so a_N / c_N^2 is --tune-rate. A batch with result
+// R = A's wins - B's wins moves theta_i by a_k / c_k * R / delta_i.
+// Parameters are non-negative. Before a perturbation theta_i is raised to at
+// least c_k, so theta - c_k stays valid without clamping and A and B sit
+// symmetrically around theta, as the gradient estimate assumes.
+#ifndef AMAZONS_TUNE_H
+#define AMAZONS_TUNE_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+const uint32_t TUNE_MAGIC = 0x544E5A41; // "AZNT"
+
+struct TuneHello {
+    uint32_t magic;
+    uint32_t cores;    // Games the worker plays at once
+    uint32_t n_params; // Of its engine build, must match the coordinator's
+};
+
+// Followed by n_params doubles for engine A, then n_params for engine B
+struct TuneJob {
+    uint32_t magic;
+    uint32_t id;
+    uint32_t games;   // 0: no more work, disconnect
+    uint32_t seed;    // Of the batch's random openings
+    uint32_t nodes;
+    int32_t openings;
+    double movetime;
+    uint32_t n_params;
+    uint32_t reserved;
+};
+
+struct TuneGame {
+    uint32_t job;
+    int32_t game;     // -1: the batch is done
+    int8_t a_won;
+    uint8_t reserved;
+    int16_t plies;
+};
+
+// Whole buffers over a stream socket; false once the peer is gone
+inline bool send_all(int fd, const void* p, size_t n) {
+    const char* c = (const char*)p;
+    while (n) {
+        ssize_t w = send(fd, c, n, MSG_NOSIGNAL);
+        if (w <= 0) return false;
+        c += w;
+        n -= (size_t)w;
+    }
+    return true;
+}
+
+inline bool recv_all(int fd, void* p, size_t n) {
+    char* c = (char*)p;
+    while (n) {
+        ssize_t r = recv(fd, c, n, 0);
+        if (r <= 0) return false;
+        c += r;
+        n -= (size_t)r;
+    }
+    return true;
+}
+
+// Connected socket to "host:port", -1 on failure
+inline int connect_to(const std::string& address) {
+    size_t colon = address.rfind(':');
+    if (colon == std::string::npos) return -1;
+    std::string host = address.substr(0, colon), port = address.substr(colon + 1);
+    addrinfo hints, *res = nullptr;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &res) != 0) return -1;
+    int fd = -1;
+    for (addrinfo* a = res; a && fd < 0; a = a->ai_next) {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(res);
+    if (fd >= 0) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+// Listening socket on every interface, -1 on failure
+inline int listen_on(int port) {
+    int fd = socket(AF_INET6, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    int one = 1, zero = 0;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &zero, sizeof(zero));
+    sockaddr_in6 addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin6_family = AF_INET6;
+    addr.sin6_addr = in6addr_any;
+    addr.sin6_port = htons((uint16_t)port);
+    if (bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+struct Spsa {
+    std::vector<double> theta;
+    std::vector<double> c;      // Step at the end of the run, per parameter
+    std::vector<bool> tuned;    // Parameters outside --tune keep their value
+    double a_end_ratio = 0.002; // a_N / c_N^2
+    int total_pairs = 1;
+    int pairs = 0;              // Finished so far
+    uint32_t rng = 1;
+
+    uint32_t next_rand() {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return rng;
+    }
+
+    double big_a() const { return 0.1 * total_pairs; }
+    double c_k(int i, int k) const { return c[i] * pow((double)total_pairs, 0.101) / pow(k + 1.0, 0.101); }
+    double a_k(int i, int k) const {
+        return a_end_ratio * c[i] * c[i] * pow(big_a() + total_pairs, 0.602) / pow(big_a() + k + 1, 0.602);
+    }
+
+    // A perturbation at the current pair count: delta is +-1 on tuned parameters,
+    // theta first raised to c_k where it is lower
+    void perturb(std::vector<double>& plus, std::vector<double>& minus, std::vector<int8_t>& delta) {
+        size_t n = theta.size();
+        delta.assign(n, 0);
+        for (size_t i = 0; i < n; i++)
+            if (tuned[i]) theta[i] = std::max(theta[i], c_k((int)i, pairs));
+        plus = minus = theta;
+        for (size_t i = 0; i < n; i++) {
+            if (!tuned[i]) continue;
+            delta[i] = next_rand() & 1 ? 1 : -1;
+            double step = c_k((int)i, pairs) * delta[i];
+            plus[i] = theta[i] + step;
+            minus[i] = theta[i] - step;
+        }
+    }
+
+    // Result of a batch started at pair count k: A's wins minus B's over its game pairs
+    void update(const std::vector<int8_t>& delta, int k, int a_minus_b, int batch_pairs) {
+        for (size_t i = 0; i < theta.size(); i++)
+            if (delta[i])
+                theta[i] = std::max(0.0, theta[i] + a_k((int)i, k) / c_k((int)i, k) * a_minus_b / delta[i]);
+        pairs += batch_pairs;
+    }
+};
+
+#endif